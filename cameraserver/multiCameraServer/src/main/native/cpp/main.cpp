@@ -19,6 +19,8 @@
    {
        "team": <team number>,
        "ntmode": <"client" or "server", "client" if unspecified>
+       "shared capture": <true to capture all cameras on one thread> // optional
+       "capture affinity": [<CPU number>, ...]  // optional
        "cameras": [
            {
                "name": <camera name>
@@ -51,6 +53,8 @@ namespace {
 
 unsigned int team;
 bool server = false;
+bool sharedCapture = false;
+std::vector<int> captureAffinity;
 
 struct CameraConfig {
   std::string name;
@@ -140,6 +144,24 @@ bool ReadConfig() {
     }
   }
 
+  // shared capture (optional)
+  if (j.count("shared capture") != 0) {
+    try {
+      sharedCapture = j.at("shared capture").get<bool>();
+    } catch (const wpi::json::exception& e) {
+      ParseError() << "could not read shared capture: " << e.what() << '\n';
+    }
+  }
+
+  // capture affinity (optional)
+  if (j.count("capture affinity") != 0) {
+    try {
+      captureAffinity = j.at("capture affinity").get<std::vector<int>>();
+    } catch (const wpi::json::exception& e) {
+      ParseError() << "could not read capture affinity: " << e.what() << '\n';
+    }
+  }
+
   // cameras
   try {
     for (auto&& camera : j.at("cameras")) {
@@ -186,6 +208,8 @@ int main(int argc, char* argv[]) {
   }
 
   // start cameras
+  cs::UsbCamera::SetSharedCapture(sharedCapture);
+  cs::UsbCamera::SetCaptureAffinity(captureAffinity);
   for (auto&& camera : cameras) {
     StartCamera(camera);
   }
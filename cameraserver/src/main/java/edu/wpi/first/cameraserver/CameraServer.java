@@ -80,6 +80,8 @@ public final class CameraServer {
         }
       case kCv:
         return "cv:";
+      case kFile:
+        return "file:";
       default:
         return "unknown:";
     }
@@ -42,6 +42,7 @@ struct CameraServer::Impl {
   cs::VideoListener m_videoListener;
   int m_tableListener;
   int m_nextPort;
+  std::string m_hostname;
   std::vector<std::string> m_addresses;
 };
 
@@ -79,6 +80,8 @@ static wpi::StringRef MakeSourceValue(CS_Source source,
     }
     case CS_SOURCE_CV:
       return "cv:";
+    case CS_SOURCE_FILE:
+      return "file:";
     default:
       return "unknown:";
   }
@@ -117,7 +120,7 @@ std::vector<std::string> CameraServer::Impl::GetSinkStreamValues(CS_Sink sink) {
     values.emplace_back(MakeStreamValue(listenAddress, port));
   } else {
     // Otherwise generate for hostname and all interface addresses
-    values.emplace_back(MakeStreamValue(cs::GetHostname() + ".local", port));
+    values.emplace_back(MakeStreamValue(m_hostname + ".local", port));
 
     for (const auto& addr : m_addresses) {
       if (addr == "127.0.0.1") {
@@ -166,6 +169,10 @@ std::vector<std::string> CameraServer::Impl::GetSourceStreamValues(
 }
 
 void CameraServer::Impl::UpdateStreamValues() {
+  // Values are collected for all sources first, so each source's streams
+  // are published at most once per update
+  wpi::DenseMap<CS_Source, std::vector<std::string>> streams;
+
   std::scoped_lock lock(m_mutex);
   // Over all the sinks...
   for (const auto& i : m_sinks) {
@@ -180,17 +187,15 @@ void CameraServer::Impl::UpdateStreamValues() {
     if (source == 0) {
       continue;
     }
-    auto table = m_tables.lookup(source);
-    if (table) {
+    if (m_tables.count(source) != 0) {
       // Don't set stream values if this is a HttpCamera passthrough
       if (cs::GetSourceKind(source, &status) == CS_SOURCE_HTTP) {
         continue;
       }
 
-      // Set table value
       auto values = GetSinkStreamValues(sink);
       if (!values.empty()) {
-        table->GetEntry("streams").SetStringArray(values);
+        streams[source] = std::move(values);
       }
     }
   }
@@ -200,15 +205,20 @@ void CameraServer::Impl::UpdateStreamValues() {
     CS_Source source = i.second.GetHandle();
 
     // Get the source's subtable (if none exists, we're done)
-    auto table = m_tables.lookup(source);
-    if (table) {
-      // Set table value
+    if (m_tables.count(source) != 0) {
       auto values = GetSourceStreamValues(source);
       if (!values.empty()) {
-        table->GetEntry("streams").SetStringArray(values);
+        streams[source] = std::move(values);
       }
     }
   }
+
+  // Set table values
+  for (auto&& stream : streams) {
+    m_tables.lookup(stream.first)
+        ->GetEntry("streams")
+        .SetStringArray(stream.second);
+  }
 }
 
 static std::string PixelFormatToString(int pixelFormat) {
@@ -413,14 +423,18 @@ CameraServer::Impl::Impl() : m_nextPort(kBasePort) {
             }
             break;
           }
-          case cs::VideoEvent::kSinkSourceChanged:
-          case cs::VideoEvent::kSinkCreated:
-          case cs::VideoEvent::kSinkDestroyed:
           case cs::VideoEvent::kNetworkInterfacesChanged: {
+            m_hostname = cs::GetHostname();
             m_addresses = cs::GetNetworkInterfaces();
             UpdateStreamValues();
             break;
           }
+          case cs::VideoEvent::kSinkSourceChanged:
+          case cs::VideoEvent::kSinkCreated:
+          case cs::VideoEvent::kSinkDestroyed: {
+            UpdateStreamValues();
+            break;
+          }
           default:
             break;
         }
@@ -4,14 +4,24 @@
 
 #include "vision/VisionRunner.h"
 
+#include <algorithm>
 #include <thread>
 
 #include <opencv2/core/mat.hpp>
+#include <wpi/condition_variable.h>
+#include <wpi/timestamp.h>
 
 #include "cameraserver/CameraServerShared.h"
 
 using namespace frc;
 
+// Weight given to each new sample in the timing averages
+static constexpr double kTimingWeight = 0.1;
+
+static double Elapsed(uint64_t start, uint64_t end) {
+  return end > start ? (end - start) * 1.0e-6 : 0.0;
+}
+
 VisionRunnerBase::VisionRunnerBase(cs::VideoSource videoSource)
     : m_image(std::make_unique<cv::Mat>()),
       m_cvSink("VisionRunner CvSink"),
@@ -19,6 +29,13 @@ VisionRunnerBase::VisionRunnerBase(cs::VideoSource videoSource)
   m_cvSink.SetSource(videoSource);
 }
 
+VisionRunnerBase::VisionRunnerBase(cs::VideoSource videoSource,
+                                   int numWorkers, Delivery delivery)
+    : VisionRunnerBase(videoSource) {
+  m_numWorkers = (std::max)(numWorkers, 1);
+  m_delivery = delivery;
+}
+
 // Located here and not in header due to cv::Mat forward declaration.
 VisionRunnerBase::~VisionRunnerBase() = default;
 
@@ -30,12 +47,25 @@ void VisionRunnerBase::RunOnce() {
         "VisionRunner::RunOnce() cannot be called from the main robot thread");
     return;
   }
+  uint64_t start = wpi::Now();
   auto frameTime = m_cvSink.GrabFrame(*m_image);
   if (frameTime == 0) {
     auto error = m_cvSink.GetError();
     csShared->ReportDriverStationError(error);
   } else {
-    DoProcess(*m_image);
+    uint64_t grabbed = wpi::Now();
+    DoProcessFrame(0, *m_image);
+    uint64_t processed = wpi::Now();
+    DoDeliverFrame(0, frameTime);
+    uint64_t delivered = wpi::Now();
+
+    std::scoped_lock lock(m_timingMutex);
+    ++m_timing.framesDelivered;
+    UpdateTiming(&Timing::grabTime, Elapsed(start, grabbed));
+    UpdateTiming(&Timing::processTime, Elapsed(grabbed, processed));
+    UpdateTiming(&Timing::waitTime, 0);
+    UpdateTiming(&Timing::listenerTime, Elapsed(processed, delivered));
+    UpdateTiming(&Timing::latency, Elapsed(frameTime, delivered));
   }
 }
 
@@ -48,6 +78,10 @@ void VisionRunnerBase::RunForever() {
         "thread");
     return;
   }
+  if (m_numWorkers > 1) {
+    RunParallel();
+    return;
+  }
   while (m_enabled) {
     RunOnce();
   }
@@ -56,3 +90,147 @@ void VisionRunnerBase::RunForever() {
 void VisionRunnerBase::Stop() {
   m_enabled = false;
 }
+
+VisionRunnerBase::Timing VisionRunnerBase::GetTiming() const {
+  std::scoped_lock lock(m_timingMutex);
+  return m_timing;
+}
+
+void VisionRunnerBase::DoProcessFrame(int worker, cv::Mat& image) {
+  DoProcess(image);
+}
+
+void VisionRunnerBase::DoDeliverFrame(int worker, uint64_t frameTime) {}
+
+void VisionRunnerBase::UpdateTiming(double Timing::*stage, double value) {
+  double& avg = m_timing.*stage;
+  if (m_timing.framesDelivered + m_timing.framesDropped <= 1) {
+    avg = value;
+  } else {
+    avg += (value - avg) * kTimingWeight;
+  }
+}
+
+// This thread grabs each frame into the image of an idle worker and hands it
+// off with a sequence number.  Workers process their frames concurrently,
+// then take turns delivering them: in order of sequence number, or (for
+// kLatest) as soon as the listener is free, skipping any frame older than
+// the last one delivered.
+void VisionRunnerBase::RunParallel() {
+  auto csShared = frc::GetCameraServerShared();
+
+  struct Worker {
+    cv::Mat image;
+    uint64_t frameTime = 0;
+    uint64_t seq = 0;
+    double grabTime = 0;
+    bool ready = false;
+    std::thread thread;
+  };
+  std::vector<Worker> workers(m_numWorkers);
+
+  wpi::mutex mutex;
+  wpi::condition_variable cond;
+  std::vector<int> idle;
+  bool done = false;
+  bool delivering = false;
+  uint64_t nextSeq = 0;
+  // kInOrder: the sequence number to deliver next;
+  // kLatest: one past the sequence number last delivered
+  uint64_t nextDeliver = 0;
+
+  auto workerMain = [&](int index) {
+    Worker& worker = workers[index];
+    std::unique_lock lock(mutex);
+    for (;;) {
+      idle.push_back(index);
+      cond.notify_all();
+      cond.wait(lock, [&] { return done || worker.ready; });
+      if (!worker.ready) {
+        break;
+      }
+      worker.ready = false;
+      lock.unlock();
+
+      uint64_t start = wpi::Now();
+      DoProcessFrame(index, worker.image);
+      uint64_t processed = wpi::Now();
+
+      lock.lock();
+      if (m_delivery == Delivery::kInOrder) {
+        cond.wait(lock,
+                  [&] { return !delivering && nextDeliver == worker.seq; });
+      } else {
+        cond.wait(lock, [&] { return !delivering; });
+        if (worker.seq < nextDeliver) {
+          std::scoped_lock timingLock(m_timingMutex);
+          ++m_timing.framesDropped;
+          UpdateTiming(&Timing::processTime, Elapsed(start, processed));
+          continue;
+        }
+      }
+      nextDeliver = worker.seq + 1;
+      delivering = true;
+      lock.unlock();
+
+      uint64_t waited = wpi::Now();
+      DoDeliverFrame(index, worker.frameTime);
+      uint64_t delivered = wpi::Now();
+      {
+        std::scoped_lock timingLock(m_timingMutex);
+        ++m_timing.framesDelivered;
+        UpdateTiming(&Timing::grabTime, worker.grabTime);
+        UpdateTiming(&Timing::processTime, Elapsed(start, processed));
+        UpdateTiming(&Timing::waitTime, Elapsed(processed, waited));
+        UpdateTiming(&Timing::listenerTime, Elapsed(waited, delivered));
+        UpdateTiming(&Timing::latency, Elapsed(worker.frameTime, delivered));
+      }
+
+      lock.lock();
+      delivering = false;
+    }
+  };
+
+  for (int i = 0; i < m_numWorkers; ++i) {
+    workers[i].thread = std::thread(workerMain, i);
+  }
+
+  std::unique_lock lock(mutex);
+  while (m_enabled) {
+    // A worker always becomes idle eventually, so Stop() doesn't need to
+    // wake this
+    cond.wait(lock, [&] { return !idle.empty(); });
+    if (!m_enabled) {
+      break;
+    }
+    int index = idle.back();
+    idle.pop_back();
+    Worker& worker = workers[index];
+    lock.unlock();
+
+    uint64_t start = wpi::Now();
+    auto frameTime = m_cvSink.GrabFrame(worker.image);
+    double grabTime = Elapsed(start, wpi::Now());
+    if (frameTime == 0) {
+      csShared->ReportDriverStationError(m_cvSink.GetError());
+    }
+
+    lock.lock();
+    if (frameTime == 0) {
+      idle.push_back(index);
+      continue;
+    }
+    worker.frameTime = frameTime;
+    worker.seq = nextSeq++;
+    worker.grabTime = grabTime;
+    worker.ready = true;
+    cond.notify_all();
+  }
+  done = true;
+  cond.notify_all();
+  lock.unlock();
+
+  for (auto&& worker : workers) {
+    worker.thread.join();
+  }
+}
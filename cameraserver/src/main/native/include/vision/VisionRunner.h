@@ -4,9 +4,14 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <vector>
+
+#include <wpi/mutex.h>
 
 #include "cscore.h"
 #include "cscore_cv.h"
@@ -19,6 +24,44 @@ namespace frc {
  */
 class VisionRunnerBase {
  public:
+  /**
+   * How results are delivered to the listener when frames are processed by
+   * multiple workers.
+   */
+  enum class Delivery {
+    /**
+     * Every processed frame is delivered, in the order the frames were
+     * captured.
+     */
+    kInOrder,
+    /**
+     * Only results newer than the last one delivered are delivered; a frame
+     * that finishes processing after a newer frame is dropped.
+     */
+    kLatest
+  };
+
+  /**
+   * Per-stage timing of the frames run through the pipeline. Times are in
+   * seconds, averaged over recent frames.
+   */
+  struct Timing {
+    /** Number of frames delivered to the listener. */
+    uint64_t framesDelivered = 0;
+    /** Number of frames processed but dropped as stale. */
+    uint64_t framesDropped = 0;
+    /** Time spent waiting for a frame from the video source. */
+    double grabTime = 0;
+    /** Time spent running the pipeline. */
+    double processTime = 0;
+    /** Time a result waited for earlier results to be delivered. */
+    double waitTime = 0;
+    /** Time spent in the listener. */
+    double listenerTime = 0;
+    /** Time from frame capture to the listener returning. */
+    double latency = 0;
+  };
+
   /**
    * Creates a new vision runner. It will take images from the {@code
    * videoSource}, and call the virtual DoProcess() method.
@@ -28,6 +71,19 @@ class VisionRunnerBase {
    */
   explicit VisionRunnerBase(cs::VideoSource videoSource);
 
+  /**
+   * Creates a new vision runner that processes frames on multiple worker
+   * threads. It will take images from the {@code videoSource}, and call the
+   * virtual DoProcessFrame() and DoDeliverFrame() methods.
+   *
+   * @param videoSource the video source to use to supply images for the
+   *                    pipeline
+   * @param numWorkers  the number of worker threads used by RunForever()
+   * @param delivery    how results are delivered
+   */
+  VisionRunnerBase(cs::VideoSource videoSource, int numWorkers,
+                   Delivery delivery);
+
   ~VisionRunnerBase();
 
   VisionRunnerBase(const VisionRunnerBase&) = delete;
@@ -53,6 +109,11 @@ class VisionRunnerBase {
    * This must be run in a dedicated thread, and cannot be used in the main
    * robot thread because it will freeze the robot program.
    *
+   * <p>If the runner has more than one worker, consecutive frames are instead
+   * processed concurrently by the workers while this thread grabs frames, and
+   * results are delivered to the listener one at a time as specified by the
+   * delivery mode.</p>
+   *
    * <strong>Do not call this method directly from the main thread.</strong>
    */
   void RunForever();
@@ -62,13 +123,45 @@ class VisionRunnerBase {
    */
   void Stop();
 
+  /**
+   * Gets the per-stage timing of the frames run so far.
+   */
+  Timing GetTiming() const;
+
  protected:
   virtual void DoProcess(cv::Mat& image) = 0;
 
+  /**
+   * Runs the pipeline of a worker on an image. This is called concurrently
+   * for different workers. The default implementation calls DoProcess().
+   *
+   * @param worker the worker index (0 to numWorkers - 1)
+   * @param image  the image
+   */
+  virtual void DoProcessFrame(int worker, cv::Mat& image);
+
+  /**
+   * Delivers the result of a worker's pipeline. Calls are never concurrent.
+   * The default implementation does nothing.
+   *
+   * @param worker    the worker index (0 to numWorkers - 1)
+   * @param frameTime the capture time of the frame, in the same time base as
+   *                  wpi::Now()
+   */
+  virtual void DoDeliverFrame(int worker, uint64_t frameTime);
+
  private:
+  void RunParallel();
+  void UpdateTiming(double Timing::*stage, double value);
+
   std::unique_ptr<cv::Mat> m_image;
   cs::CvSink m_cvSink;
   std::atomic_bool m_enabled;
+  int m_numWorkers = 1;
+  Delivery m_delivery = Delivery::kInOrder;
+
+  mutable wpi::mutex m_timingMutex;
+  Timing m_timing;
 };
 
 /**
@@ -83,14 +176,19 @@ class VisionRunner : public VisionRunnerBase {
  public:
   VisionRunner(cs::VideoSource videoSource, T* pipeline,
                std::function<void(T&)> listener);
+  VisionRunner(cs::VideoSource videoSource, std::vector<T*> pipelines,
+               std::function<void(T&, uint64_t)> listener,
+               Delivery delivery = Delivery::kInOrder);
   virtual ~VisionRunner() = default;
 
  protected:
   void DoProcess(cv::Mat& image) override;
+  void DoProcessFrame(int worker, cv::Mat& image) override;
+  void DoDeliverFrame(int worker, uint64_t frameTime) override;
 
  private:
-  T* m_pipeline;
-  std::function<void(T&)> m_listener;
+  std::vector<T*> m_pipelines;
+  std::function<void(T&, uint64_t)> m_listener;
 };
 }  // namespace frc
 
@@ -0,0 +1,113 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+// Compares cscore's built-in color conversions (which use SSE2/AVX2/NEON
+// kernels when available) against the equivalent cv::cvtColor calls.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "cscore.h"
+#include "cscore_raw.h"
+
+static constexpr int kWidth = 640;
+static constexpr int kHeight = 480;
+static constexpr int kIterations = 500;
+
+static void BenchOpenCV(const char* name, const cv::Mat& src, int code) {
+  cv::Mat dst;
+  cv::cvtColor(src, dst, code);  // warm up (allocates dst)
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    cv::cvtColor(src, dst, code);
+  }
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::printf("%-16s cvtColor: %8.1f us/frame\n", name,
+              elapsed.count() / kIterations);
+}
+
+// Puts src frames into a raw source and grabs them (without copying) from a
+// raw sink in pixelFormat.  Frames are converted lazily by the grabbing
+// thread, so the grab time is dominated by the conversion.
+static void BenchCscore(const char* name, const cv::Mat& src,
+                        CS_PixelFormat srcFormat, CS_PixelFormat dstFormat) {
+  CS_Status status = 0;
+  cs::VideoMode mode{static_cast<cs::VideoMode::PixelFormat>(srcFormat),
+                     kWidth, kHeight, 30};
+  CS_Source source = cs::CreateRawSource("source", mode, &status);
+  CS_Sink sink = cs::CreateRawSink("sink", &status);
+  cs::SetSinkSource(sink, source, &status);
+
+  std::atomic_bool done{false};
+  std::thread producer{[&] {
+    cs::RawFrame frame;
+    frame.data = reinterpret_cast<char*>(src.data);
+    frame.dataLength = src.total() * src.elemSize();
+    frame.totalData = frame.dataLength;
+    frame.pixelFormat = srcFormat;
+    frame.width = kWidth;
+    frame.height = kHeight;
+    while (!done) {
+      CS_Status status = 0;
+      cs::PutSourceFrame(source, frame, &status);
+      std::this_thread::yield();
+    }
+    frame.data = nullptr;  // not owned by the frame
+  }};
+
+  cs::RawFrame out;
+  out.pixelFormat = dstFormat;
+  out.width = kWidth;
+  out.height = kHeight;
+  int grabbed = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kIterations; ++i) {
+    if (cs::GrabSinkFrameTimeoutDirect(sink, out, 1.0, &status) != 0) {
+      ++grabbed;
+    }
+  }
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  done = true;
+  producer.join();
+  cs::ReleaseSink(sink, &status);
+  cs::ReleaseSource(source, &status);
+  std::printf("%-16s cscore:   %8.1f us/frame\n", name,
+              elapsed.count() / (grabbed ? grabbed : 1));
+}
+
+int main() {
+  // Synthetic YUYV test pattern, and the other formats derived from it
+  cv::Mat yuyv{kHeight, kWidth, CV_8UC2};
+  for (int y = 0; y < kHeight; ++y) {
+    uchar* row = yuyv.ptr(y);
+    for (int x = 0; x < kWidth; ++x) {
+      row[2 * x] = (x + y) & 0xff;
+      row[2 * x + 1] = (x % 2) == 0 ? (x * 255 / kWidth) : (y * 255 / kHeight);
+    }
+  }
+  cv::Mat bgr, rgb565, gray;
+  cv::cvtColor(yuyv, bgr, cv::COLOR_YUV2BGR_YUYV);
+  cv::cvtColor(bgr, rgb565, cv::COLOR_RGB2BGR565);
+  cv::cvtColor(bgr, gray, cv::COLOR_BGR2GRAY);
+
+  BenchOpenCV("YUYV->BGR", yuyv, cv::COLOR_YUV2BGR_YUYV);
+  BenchCscore("YUYV->BGR", yuyv, CS_PIXFMT_YUYV, CS_PIXFMT_BGR);
+  BenchOpenCV("YUYV->Gray", yuyv, cv::COLOR_YUV2GRAY_YUYV);
+  BenchCscore("YUYV->Gray", yuyv, CS_PIXFMT_YUYV, CS_PIXFMT_GRAY);
+  BenchOpenCV("BGR->RGB565", bgr, cv::COLOR_RGB2BGR565);
+  BenchCscore("BGR->RGB565", bgr, CS_PIXFMT_BGR, CS_PIXFMT_RGB565);
+  BenchOpenCV("RGB565->BGR", rgb565, cv::COLOR_BGR5652RGB);
+  BenchCscore("RGB565->BGR", rgb565, CS_PIXFMT_RGB565, CS_PIXFMT_BGR);
+  BenchOpenCV("BGR->Gray", bgr, cv::COLOR_BGR2GRAY);
+  BenchCscore("BGR->Gray", bgr, CS_PIXFMT_BGR, CS_PIXFMT_GRAY);
+  BenchOpenCV("Gray->BGR", gray, cv::COLOR_GRAY2BGR);
+  BenchCscore("Gray->BGR", gray, CS_PIXFMT_GRAY, CS_PIXFMT_BGR);
+}
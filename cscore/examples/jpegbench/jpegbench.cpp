@@ -0,0 +1,101 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+// Compares YUYV to JPEG compression through cscore (which uses the direct
+// libjpeg-turbo encoder when built with USE_LIBJPEG_TURBO) against
+// converting to BGR and compressing with cv::imencode.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "cscore.h"
+#include "cscore_raw.h"
+
+static constexpr int kWidth = 640;
+static constexpr int kHeight = 480;
+static constexpr int kQuality = 80;
+static constexpr int kIterations = 200;
+
+int main() {
+  // Synthetic YUYV test pattern
+  cv::Mat yuyv{kHeight, kWidth, CV_8UC2};
+  for (int y = 0; y < kHeight; ++y) {
+    uchar* row = yuyv.ptr(y);
+    for (int x = 0; x < kWidth; ++x) {
+      row[2 * x] = (x + y) & 0xff;
+      row[2 * x + 1] = (x % 2) == 0 ? (x * 255 / kWidth) : (y * 255 / kHeight);
+    }
+  }
+
+  // OpenCV: convert to BGR, then compress
+  {
+    cv::Mat bgr;
+    std::vector<uchar> jpeg;
+    std::vector<int> params{cv::IMWRITE_JPEG_QUALITY, kQuality};
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+      cv::cvtColor(yuyv, bgr, cv::COLOR_YUV2BGR_YUYV);
+      cv::imencode(".jpg", bgr, jpeg, params);
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    std::printf("cvtColor+imencode: %.3f ms/frame (%zu bytes)\n",
+                elapsed.count() / kIterations, jpeg.size());
+  }
+
+  // cscore: put YUYV frames into a source and grab them as MJPEG.  Frames
+  // are converted lazily by the grabbing thread, so the grab time is
+  // dominated by the conversion.
+  {
+    CS_Status status = 0;
+    cs::VideoMode mode{cs::VideoMode::kYUYV, kWidth, kHeight, 30};
+    CS_Source source = cs::CreateRawSource("source", mode, &status);
+    CS_Sink sink = cs::CreateRawSink("sink", &status);
+    cs::SetSinkSource(sink, source, &status);
+
+    std::atomic_bool done{false};
+    std::thread producer{[&] {
+      cs::RawFrame frame;
+      frame.data = reinterpret_cast<char*>(yuyv.data);
+      frame.dataLength = yuyv.total() * yuyv.elemSize();
+      frame.totalData = frame.dataLength;
+      frame.pixelFormat = CS_PIXFMT_YUYV;
+      frame.width = kWidth;
+      frame.height = kHeight;
+      while (!done) {
+        CS_Status status = 0;
+        cs::PutSourceFrame(source, frame, &status);
+        std::this_thread::yield();
+      }
+      frame.data = nullptr;  // not owned by the frame
+    }};
+
+    cs::RawFrame jpeg;
+    jpeg.pixelFormat = CS_PIXFMT_MJPEG;
+    jpeg.width = kWidth;
+    jpeg.height = kHeight;
+    int grabbed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+      if (cs::GrabSinkFrameTimeout(sink, jpeg, 1.0, &status) != 0) {
+        ++grabbed;
+      }
+    }
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+    done = true;
+    producer.join();
+    cs::ReleaseSink(sink, &status);
+    cs::ReleaseSource(source, &status);
+    std::printf("cscore YUYV->MJPEG: %.3f ms/frame (%d bytes)\n",
+                elapsed.count() / (grabbed ? grabbed : 1), jpeg.totalData);
+  }
+}
@@ -0,0 +1,71 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+// Records a USB camera to a file, or plays a recording back to an MJPEG
+// server:
+//
+//   recordplayback record <file>
+//   recordplayback play <file> [max|step]
+//
+// In step mode, each press of Enter plays one frame.
+
+#include <cstdio>
+#include <cstring>
+
+#include <wpi/raw_ostream.h>
+
+#include "cscore.h"
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    wpi::errs() << "Usage: " << argv[0] << " record <file>\n"
+                << "       " << argv[0] << " play <file> [max|step]\n";
+    return 1;
+  }
+
+  if (std::strcmp(argv[1], "record") == 0) {
+    cs::UsbCamera camera{"usbcam", 0};
+    camera.SetVideoMode(cs::VideoMode::kMJPEG, 320, 240, 30);
+    cs::RecordingSink recorder{"recorder", argv[2]};
+    if (recorder.GetLastStatus() != 0) {
+      wpi::errs() << "could not create " << argv[2] << '\n';
+      return 1;
+    }
+    recorder.SetSource(camera);
+    wpi::outs() << "recording; press Enter to stop\n";
+    std::getchar();
+    return 0;
+  }
+
+  auto mode = cs::FileSource::kOriginalRate;
+  if (argc > 3 && std::strcmp(argv[3], "max") == 0) {
+    mode = cs::FileSource::kMaxRate;
+  } else if (argc > 3 && std::strcmp(argv[3], "step") == 0) {
+    mode = cs::FileSource::kStepped;
+  }
+  cs::FileSource source{"playback", argv[2], mode};
+  if (source.GetLastStatus() != 0) {
+    wpi::errs() << "could not open " << argv[2] << '\n';
+    return 1;
+  }
+  source.SetLoop(true);
+  cs::MjpegServer mjpegServer{"httpserver", 8081};
+  mjpegServer.SetSource(source);
+
+  if (mode == cs::FileSource::kStepped) {
+    wpi::outs() << "press Enter to step, q then Enter to quit\n";
+    for (;;) {
+      int ch = std::getchar();
+      if (ch == 'q' || ch == EOF) {
+        break;
+      }
+      if (ch == '\n') {
+        source.Step();
+      }
+    }
+  } else {
+    wpi::outs() << "playing; press Enter to stop\n";
+    std::getchar();
+  }
+}
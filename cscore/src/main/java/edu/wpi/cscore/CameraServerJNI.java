@@ -331,7 +331,18 @@ public class CameraServerJNI {
   //
   public enum TelemetryKind {
     kSourceBytesReceived(1),
-    kSourceFramesReceived(2);
+    kSourceFramesReceived(2),
+    kSourceCaptureLatency(3),
+    kSourcePublishLatency(4),
+    kSourceConvertTimeMJPEG(5),
+    kSourceConvertTimeRGB565(6),
+    kSourceConvertTimeBGR(7),
+    kSourceConvertTimeGray(8),
+    kSinkFramesDropped(9),
+    kSinkSendBacklog(10),
+    kSourceImagePoolHits(11),
+    kSourceImagePoolMisses(12),
+    kSinkBytesSent(13);
 
     private final int value;
 
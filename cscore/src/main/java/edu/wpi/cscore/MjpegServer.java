@@ -88,4 +88,56 @@ public class MjpegServer extends VideoSink {
     CameraServerJNI.setProperty(
         CameraServerJNI.getSinkProperty(m_handle, "default_compression"), quality);
   }
+
+  /**
+   * Set whether streaming clients are served by a single shared thread.
+   *
+   * <p>By default each streaming client is served by its own thread. When shared streaming is
+   * enabled, clients that connect afterwards are instead handed off to one thread that waits for
+   * each frame once and writes it to all clients using non-blocking sends. Clients that are unable
+   * to keep up have frames dropped rather than stalling the stream.
+   *
+   * @param enabled True to enable shared streaming
+   */
+  public void setSharedStreaming(boolean enabled) {
+    CameraServerJNI.setProperty(
+        CameraServerJNI.getSinkProperty(m_handle, "shared_streaming"), enabled ? 1 : 0);
+  }
+
+  /**
+   * Set whether streams adapt to the available bandwidth.
+   *
+   * <p>When enabled, the server watches how quickly each client takes data and, if the connection
+   * can't keep up or a bandwidth limit is reached, lowers the JPEG quality, then the resolution,
+   * and skips frames as needed. Quality is restored once the connection has room again. Like
+   * compression, reducing quality recompresses MJPEG source images.
+   *
+   * @param enabled True to enable adaptive streaming
+   */
+  public void setAdaptiveStreaming(boolean enabled) {
+    CameraServerJNI.setProperty(
+        CameraServerJNI.getSinkProperty(m_handle, "adaptive_streaming"), enabled ? 1 : 0);
+  }
+
+  /**
+   * Set the bandwidth budget for each client that doesn't specify it. Frames are skipped (and, with
+   * adaptive streaming, quality is reduced) to stay within it.
+   *
+   * @param kbps bandwidth in kilobits per second, 0 for unlimited
+   */
+  public void setStreamBandwidth(int kbps) {
+    CameraServerJNI.setProperty(
+        CameraServerJNI.getSinkProperty(m_handle, "stream_bandwidth"), kbps);
+  }
+
+  /**
+   * Set the total bandwidth for all clients of this server. Frames are skipped (and, with adaptive
+   * streaming, quality is reduced) to stay within it.
+   *
+   * @param kbps bandwidth in kilobits per second, 0 for unlimited
+   */
+  public void setMaxBandwidth(int kbps) {
+    CameraServerJNI.setProperty(
+        CameraServerJNI.getSinkProperty(m_handle, "max_bandwidth"), kbps);
+  }
 }
@@ -59,4 +59,16 @@ public class UsbCamera extends VideoCamera {
     CameraServerJNI.setProperty(
         CameraServerJNI.getSourceProperty(m_handle, "connect_verbose"), level);
   }
+
+  /**
+   * Set whether frames should reference the camera driver buffers directly
+   * rather than being copied.  Only supported on Linux; the number of driver
+   * buffers requested changes on the next (re)connect.
+   *
+   * @param enabled true to enable zero-copy capture
+   */
+  public void setZeroCopy(boolean enabled) {
+    CameraServerJNI.setProperty(
+        CameraServerJNI.getSourceProperty(m_handle, "zero_copy"), enabled ? 1 : 0);
+  }
 }
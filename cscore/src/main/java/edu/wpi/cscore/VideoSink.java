@@ -13,7 +13,8 @@ public class VideoSink implements AutoCloseable {
     kUnknown(0),
     kMjpeg(2),
     kCv(4),
-    kRaw(8);
+    kRaw(8),
+    kRecording(16);
 
     private final int value;
 
@@ -38,6 +39,8 @@ public class VideoSink implements AutoCloseable {
         return Kind.kMjpeg;
       case 4:
         return Kind.kCv;
+      case 16:
+        return Kind.kRecording;
       default:
         return Kind.kUnknown;
     }
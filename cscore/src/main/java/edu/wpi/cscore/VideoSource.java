@@ -14,7 +14,8 @@ public class VideoSource implements AutoCloseable {
     kUsb(1),
     kHttp(2),
     kCv(4),
-    kRaw(8);
+    kRaw(8),
+    kFile(16);
 
     private final int value;
 
@@ -68,6 +69,8 @@ public class VideoSource implements AutoCloseable {
         return Kind.kHttp;
       case 4:
         return Kind.kCv;
+      case 16:
+        return Kind.kFile;
       default:
         return Kind.kUnknown;
     }
@@ -313,6 +316,19 @@ public class VideoSource implements AutoCloseable {
         m_handle, CameraServerJNI.TelemetryKind.kSourceBytesReceived);
   }
 
+  /**
+   * Get the average latency from frame capture to delivery to a sink (in microseconds).
+   *
+   * <p>CameraServerJNI#setTelemetryPeriod() must be called for this to be valid (throws
+   * VisionException if telemetry is not enabled).
+   *
+   * @return Latency averaged over the telemetry period.
+   */
+  public double getCaptureLatency() {
+    return CameraServerJNI.getTelemetryAverageValue(
+        m_handle, CameraServerJNI.TelemetryKind.kSourceCaptureLatency);
+  }
+
   /** Enumerate all known video modes for this source. */
   public VideoMode[] enumerateVideoModes() {
     return CameraServerJNI.enumerateSourceVideoModes(m_handle);
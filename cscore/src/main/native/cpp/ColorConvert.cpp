@@ -0,0 +1,781 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ColorConvert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CSCORE_COLOR_SSE2
+#define CSCORE_COLOR_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CSCORE_TARGET_AVX2
+#else
+#define CSCORE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CSCORE_COLOR_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace cs;
+
+// YUYV to BGR uses BT.601 video range coefficients (the same ones OpenCV
+// uses), but is computed in 16-bit arithmetic so it vectorizes without
+// widening: luma and chroma (centered and shifted left by 8) are multiplied
+// by coefficients in units of 2^-14, keeping the high 16 bits of the product.
+// This leaves intermediate values with 6 fractional bits.  Results are within
+// 1 of OpenCV's.  The scalar implementation mirrors the vector operations
+// exactly (including saturation), so all implementations produce identical
+// output.
+static constexpr int kY = 19071;    // 1.164
+static constexpr int kVR = 26149;   // 1.596
+static constexpr int kUG = -6406;   // -0.391
+static constexpr int kVG = -13320;  // -0.813
+static constexpr int kUB = 295;     // 2.018 (less 2, which is a shift)
+static constexpr int kRound = 32;   // 0.5 with 6 fractional bits
+
+// BGR to gray weights (0.114, 0.587, 0.299) in units of 2^-14; same as OpenCV
+static constexpr int kGrayB = 1868;
+static constexpr int kGrayG = 9617;
+static constexpr int kGrayR = 4899;
+static constexpr int kGrayShift = 14;
+
+namespace {
+
+struct Kernels {
+  const char* name;
+  void (*yuyvToBGR)(const uint8_t* src, uint8_t* dst, size_t pixels);
+  void (*yuyvToGray)(const uint8_t* src, uint8_t* dst, size_t pixels);
+  void (*bgrToRGB565)(const uint8_t* src, uint8_t* dst, size_t pixels);
+  void (*rgb565ToBGR)(const uint8_t* src, uint8_t* dst, size_t pixels);
+  void (*bgrToGray)(const uint8_t* src, uint8_t* dst, size_t pixels);
+  void (*grayToBGR)(const uint8_t* src, uint8_t* dst, size_t pixels);
+};
+
+}  // namespace
+
+//
+// Scalar implementation; also used for the tails of the vector versions
+//
+
+static inline int AddSat(int a, int b) {
+  return std::clamp(a + b, -32768, 32767);
+}
+
+static inline int MulHi(int a, int b) {
+  return (a * b) >> 16;
+}
+
+static inline uint8_t Descale(int value) {
+  return std::clamp(value >> 6, 0, 255);
+}
+
+static void YUYVToBGRScalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  for (size_t i = 0; i + 1 < pixels; i += 2, src += 4, dst += 6) {
+    int u = (src[1] - 128) * 256;
+    int v = (src[3] - 128) * 256;
+    int bu = u / 2 + MulHi(u, kUB);
+    int gu = MulHi(u, kUG) + MulHi(v, kVG);
+    int rv = MulHi(v, kVR);
+    for (int j = 0; j < 2; ++j) {
+      int y = MulHi(std::max(src[j * 2] - 16, 0) * 256, kY);
+      dst[j * 3] = Descale(AddSat(AddSat(y, bu), kRound));
+      dst[j * 3 + 1] = Descale(AddSat(AddSat(y, gu), kRound));
+      dst[j * 3 + 2] = Descale(AddSat(AddSat(y, rv), kRound));
+    }
+  }
+}
+
+static void YUYVToGrayScalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  for (size_t i = 0; i < pixels; ++i) {
+    dst[i] = src[i * 2];
+  }
+}
+
+static void BGRToRGB565Scalar(const uint8_t* src, uint8_t* dst,
+                              size_t pixels) {
+  for (size_t i = 0; i < pixels; ++i, src += 3, dst += 2) {
+    unsigned int value =
+        (src[2] >> 3) | ((src[1] >> 2) << 5) | ((src[0] >> 3) << 11);
+    dst[0] = value & 0xff;
+    dst[1] = value >> 8;
+  }
+}
+
+static void RGB565ToBGRScalar(const uint8_t* src, uint8_t* dst,
+                              size_t pixels) {
+  for (size_t i = 0; i < pixels; ++i, src += 2, dst += 3) {
+    unsigned int value = src[0] | (src[1] << 8);
+    dst[0] = (value >> 11) << 3;
+    dst[1] = ((value >> 5) & 0x3f) << 2;
+    dst[2] = (value & 0x1f) << 3;
+  }
+}
+
+static void BGRToGrayScalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  for (size_t i = 0; i < pixels; ++i, src += 3) {
+    dst[i] = (src[0] * kGrayB + src[1] * kGrayG + src[2] * kGrayR +
+              (1 << (kGrayShift - 1))) >>
+             kGrayShift;
+  }
+}
+
+static void GrayToBGRScalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  for (size_t i = 0; i < pixels; ++i, dst += 3) {
+    dst[0] = dst[1] = dst[2] = src[i];
+  }
+}
+
+static constexpr Kernels kScalarKernels{
+    "scalar",          YUYVToBGRScalar, YUYVToGrayScalar, BGRToRGB565Scalar,
+    RGB565ToBGRScalar, BGRToGrayScalar, GrayToBGRScalar};
+
+//
+// SSE2 implementation
+//
+// BGR data is handled 4 pixels (12 bytes) at a time as BGRx in 32-bit lanes.
+// The 16-byte loads and stores this requires read or write 4 bytes past the
+// end of each group, so the loops stop at least 2 pixels short of the end of
+// the image and leave the rest to the scalar code.
+//
+
+#ifdef CSCORE_COLOR_SSE2
+
+static inline __m128i LoadBGRx(const uint8_t* src) {
+  const __m128i lo = _mm_set_epi32(0, 0x00ffffff, 0, 0x00ffffff);
+  const __m128i hi = _mm_set_epi32(0x00ffffff, 0, 0x00ffffff, 0);
+  __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  // 64-bit lanes with 2 pixels each in the low 6 bytes
+  __m128i q = _mm_unpacklo_epi64(x, _mm_srli_si128(x, 6));
+  return _mm_or_si128(_mm_and_si128(q, lo),
+                      _mm_and_si128(_mm_slli_epi64(q, 8), hi));
+}
+
+static inline void StoreBGRx(uint8_t* dst, __m128i p) {
+  const __m128i lo = _mm_set_epi32(0, 0x00ffffff, 0, 0x00ffffff);
+  const __m128i hi = _mm_set_epi32(0x0000ffff, static_cast<int>(0xff000000),
+                                   0x0000ffff, static_cast<int>(0xff000000));
+  // pack each 64-bit lane into its low 6 bytes, then the lanes together
+  __m128i c = _mm_or_si128(_mm_and_si128(p, lo),
+                           _mm_and_si128(_mm_srli_epi64(p, 8), hi));
+  c = _mm_or_si128(_mm_move_epi64(c),
+                   _mm_slli_si128(_mm_srli_si128(c, 8), 6));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), c);
+}
+
+// Stores 16 pixels from B, G, and R planes
+static inline void StoreBGR16(uint8_t* dst, __m128i b, __m128i g, __m128i r) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i bg = _mm_unpacklo_epi8(b, g);
+  __m128i rz = _mm_unpacklo_epi8(r, zero);
+  StoreBGRx(dst, _mm_unpacklo_epi16(bg, rz));
+  StoreBGRx(dst + 12, _mm_unpackhi_epi16(bg, rz));
+  bg = _mm_unpackhi_epi8(b, g);
+  rz = _mm_unpackhi_epi8(r, zero);
+  StoreBGRx(dst + 24, _mm_unpacklo_epi16(bg, rz));
+  StoreBGRx(dst + 36, _mm_unpackhi_epi16(bg, rz));
+}
+
+// Converts 8 YUYV pixels to 16-bit B, G, and R
+static inline void YUYVToBGR8(__m128i in, __m128i* b, __m128i* g,
+                              __m128i* r) {
+  __m128i y = _mm_and_si128(in, _mm_set1_epi16(0xff));
+  __m128i uv = _mm_slli_epi16(
+      _mm_sub_epi16(_mm_srli_epi16(in, 8), _mm_set1_epi16(128)), 8);
+  __m128i u = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)),
+      _MM_SHUFFLE(2, 2, 0, 0));
+  __m128i v = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)),
+      _MM_SHUFFLE(3, 3, 1, 1));
+  y = _mm_max_epi16(_mm_sub_epi16(y, _mm_set1_epi16(16)), _mm_setzero_si128());
+  y = _mm_mulhi_epu16(_mm_slli_epi16(y, 8), _mm_set1_epi16(kY));
+
+  __m128i bu = _mm_add_epi16(_mm_srai_epi16(u, 1),
+                             _mm_mulhi_epi16(u, _mm_set1_epi16(kUB)));
+  __m128i gu = _mm_add_epi16(_mm_mulhi_epi16(u, _mm_set1_epi16(kUG)),
+                             _mm_mulhi_epi16(v, _mm_set1_epi16(kVG)));
+  __m128i rv = _mm_mulhi_epi16(v, _mm_set1_epi16(kVR));
+
+  const __m128i round = _mm_set1_epi16(kRound);
+  *b = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(y, bu), round), 6);
+  *g = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(y, gu), round), 6);
+  *r = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(y, rv), round), 6);
+}
+
+// Converts 4 BGRx pixels to gray in 32-bit lanes
+static inline __m128i BGRxToGray(__m128i p) {
+  __m128i br = _mm_and_si128(p, _mm_set1_epi32(0x00ff00ff));
+  __m128i g = _mm_srli_epi16(p, 8);
+  __m128i sum = _mm_add_epi32(
+      _mm_madd_epi16(br, _mm_set1_epi32((kGrayR << 16) | kGrayB)),
+      _mm_madd_epi16(g, _mm_set1_epi32(kGrayG)));
+  return _mm_srli_epi32(
+      _mm_add_epi32(sum, _mm_set1_epi32(1 << (kGrayShift - 1))), kGrayShift);
+}
+
+// Converts 4 BGRx pixels to RGB565 in 32-bit lanes, sign extended from 16 bits
+// so they can be narrowed with _mm_packs_epi32
+static inline __m128i BGRxToRGB565(__m128i p) {
+  __m128i r = _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x1f));
+  __m128i g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x7e0));
+  __m128i b = _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xf800));
+  __m128i value = _mm_or_si128(_mm_or_si128(r, g), b);
+  return _mm_srai_epi32(_mm_slli_epi32(value, 16), 16);
+}
+
+// Converts 8 RGB565 pixels to 16-bit B, G, and R
+static inline void RGB565ToBGR8(__m128i p, __m128i* b, __m128i* g,
+                                __m128i* r) {
+  *b = _mm_slli_epi16(_mm_srli_epi16(p, 11), 3);
+  *g = _mm_and_si128(_mm_srli_epi16(p, 3), _mm_set1_epi16(0xfc));
+  *r = _mm_and_si128(_mm_slli_epi16(p, 3), _mm_set1_epi16(0xf8));
+}
+
+static void YUYVToBGRSSE2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 18 <= pixels; i += 16, src += 32, dst += 48) {
+    __m128i b0, g0, r0, b1, g1, r1;
+    YUYVToBGR8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), &b0,
+               &g0, &r0);
+    YUYVToBGR8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)),
+               &b1, &g1, &r1);
+    StoreBGR16(dst, _mm_packus_epi16(b0, b1), _mm_packus_epi16(g0, g1),
+               _mm_packus_epi16(r0, r1));
+  }
+  YUYVToBGRScalar(src, dst, pixels - i);
+}
+
+static void YUYVToGraySSE2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  const __m128i mask = _mm_set1_epi16(0xff);
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16, src += 32, dst += 16) {
+    __m128i y0 = _mm_and_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), mask);
+    __m128i y1 = _mm_and_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)), mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_packus_epi16(y0, y1));
+  }
+  YUYVToGrayScalar(src, dst, pixels - i);
+}
+
+static void BGRToRGB565SSE2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 10 <= pixels; i += 8, src += 24, dst += 16) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_packs_epi32(BGRxToRGB565(LoadBGRx(src)),
+                                     BGRxToRGB565(LoadBGRx(src + 12))));
+  }
+  BGRToRGB565Scalar(src, dst, pixels - i);
+}
+
+static void RGB565ToBGRSSE2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 18 <= pixels; i += 16, src += 32, dst += 48) {
+    __m128i b0, g0, r0, b1, g1, r1;
+    RGB565ToBGR8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), &b0,
+                 &g0, &r0);
+    RGB565ToBGR8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)),
+                 &b1, &g1, &r1);
+    StoreBGR16(dst, _mm_packus_epi16(b0, b1), _mm_packus_epi16(g0, g1),
+               _mm_packus_epi16(r0, r1));
+  }
+  RGB565ToBGRScalar(src, dst, pixels - i);
+}
+
+static void BGRToGraySSE2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 18 <= pixels; i += 16, src += 48, dst += 16) {
+    __m128i y0 = _mm_packs_epi32(BGRxToGray(LoadBGRx(src)),
+                                 BGRxToGray(LoadBGRx(src + 12)));
+    __m128i y1 = _mm_packs_epi32(BGRxToGray(LoadBGRx(src + 24)),
+                                 BGRxToGray(LoadBGRx(src + 36)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_packus_epi16(y0, y1));
+  }
+  BGRToGrayScalar(src, dst, pixels - i);
+}
+
+static void GrayToBGRSSE2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 18 <= pixels; i += 16, src += 16, dst += 48) {
+    __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    StoreBGR16(dst, g, g, g);
+  }
+  GrayToBGRScalar(src, dst, pixels - i);
+}
+
+static constexpr Kernels kSSE2Kernels{
+    "sse2",          YUYVToBGRSSE2, YUYVToGraySSE2, BGRToRGB565SSE2,
+    RGB565ToBGRSSE2, BGRToGraySSE2, GrayToBGRSSE2};
+
+#endif  // CSCORE_COLOR_SSE2
+
+//
+// AVX2 implementation
+//
+// Same approach as SSE2, but most AVX2 operations work within 128-bit lanes,
+// so pixels are processed in lane-sized groups and reordered as needed.
+//
+
+#ifdef CSCORE_COLOR_AVX2
+
+static inline __m128i LoadU128(const uint8_t* src) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+static inline void StoreU128(uint8_t* dst, __m128i value) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value);
+}
+
+// Loads 8 BGR pixels as BGRx (pixels 0-3 in the low lane, 4-7 in the high)
+CSCORE_TARGET_AVX2 static inline __m256i LoadBGRx8(const uint8_t* src) {
+  const __m256i expand =
+      _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,  //
+                       0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(LoadU128(src)),
+                                      LoadU128(src + 12), 1);
+  return _mm256_shuffle_epi8(x, expand);
+}
+
+// Stores 32 pixels from B, G, and R planes.  The planes must be in the order
+// produced by _mm256_packus_epi16 of two vectors holding 16 pixels each
+// (pixels 0-7 and 16-23 in the low lane, 8-15 and 24-31 in the high lane).
+CSCORE_TARGET_AVX2 static inline void StoreBGR32(uint8_t* dst, __m256i b,
+                                                 __m256i g, __m256i r) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i compress = _mm256_setr_epi8(
+      0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,  //
+      0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  for (int half = 0; half < 2; ++half, dst += 48) {
+    __m256i bg = half == 0 ? _mm256_unpacklo_epi8(b, g)
+                           : _mm256_unpackhi_epi8(b, g);
+    __m256i rz = half == 0 ? _mm256_unpacklo_epi8(r, zero)
+                           : _mm256_unpackhi_epi8(r, zero);
+    // p0 has pixels 0-3 and 8-11 of the half, p1 has 4-7 and 12-15
+    __m256i p0 = _mm256_shuffle_epi8(_mm256_unpacklo_epi16(bg, rz), compress);
+    __m256i p1 = _mm256_shuffle_epi8(_mm256_unpackhi_epi16(bg, rz), compress);
+    StoreU128(dst, _mm256_castsi256_si128(p0));
+    StoreU128(dst + 12, _mm256_castsi256_si128(p1));
+    StoreU128(dst + 24, _mm256_extracti128_si256(p0, 1));
+    StoreU128(dst + 36, _mm256_extracti128_si256(p1, 1));
+  }
+}
+
+CSCORE_TARGET_AVX2 static inline void YUYVToBGR16(__m256i in, __m256i* b,
+                                                  __m256i* g, __m256i* r) {
+  __m256i y = _mm256_and_si256(in, _mm256_set1_epi16(0xff));
+  __m256i uv = _mm256_slli_epi16(
+      _mm256_sub_epi16(_mm256_srli_epi16(in, 8), _mm256_set1_epi16(128)), 8);
+  __m256i u = _mm256_shufflehi_epi16(
+      _mm256_shufflelo_epi16(uv, _MM_SHUFFLE(2, 2, 0, 0)),
+      _MM_SHUFFLE(2, 2, 0, 0));
+  __m256i v = _mm256_shufflehi_epi16(
+      _mm256_shufflelo_epi16(uv, _MM_SHUFFLE(3, 3, 1, 1)),
+      _MM_SHUFFLE(3, 3, 1, 1));
+  y = _mm256_max_epi16(_mm256_sub_epi16(y, _mm256_set1_epi16(16)),
+                       _mm256_setzero_si256());
+  y = _mm256_mulhi_epu16(_mm256_slli_epi16(y, 8), _mm256_set1_epi16(kY));
+
+  __m256i bu = _mm256_add_epi16(_mm256_srai_epi16(u, 1),
+                                _mm256_mulhi_epi16(u, _mm256_set1_epi16(kUB)));
+  __m256i gu = _mm256_add_epi16(_mm256_mulhi_epi16(u, _mm256_set1_epi16(kUG)),
+                                _mm256_mulhi_epi16(v, _mm256_set1_epi16(kVG)));
+  __m256i rv = _mm256_mulhi_epi16(v, _mm256_set1_epi16(kVR));
+
+  const __m256i round = _mm256_set1_epi16(kRound);
+  *b = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(y, bu), round),
+                         6);
+  *g = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(y, gu), round),
+                         6);
+  *r = _mm256_srai_epi16(_mm256_adds_epi16(_mm256_adds_epi16(y, rv), round),
+                         6);
+}
+
+CSCORE_TARGET_AVX2 static inline __m256i BGRxToGray8(__m256i p) {
+  __m256i br = _mm256_and_si256(p, _mm256_set1_epi32(0x00ff00ff));
+  __m256i g = _mm256_srli_epi16(p, 8);
+  __m256i sum = _mm256_add_epi32(
+      _mm256_madd_epi16(br, _mm256_set1_epi32((kGrayR << 16) | kGrayB)),
+      _mm256_madd_epi16(g, _mm256_set1_epi32(kGrayG)));
+  return _mm256_srli_epi32(
+      _mm256_add_epi32(sum, _mm256_set1_epi32(1 << (kGrayShift - 1))),
+      kGrayShift);
+}
+
+CSCORE_TARGET_AVX2 static inline __m256i BGRxToRGB565_8(__m256i p) {
+  __m256i r =
+      _mm256_and_si256(_mm256_srli_epi32(p, 19), _mm256_set1_epi32(0x1f));
+  __m256i g =
+      _mm256_and_si256(_mm256_srli_epi32(p, 5), _mm256_set1_epi32(0x7e0));
+  __m256i b =
+      _mm256_and_si256(_mm256_slli_epi32(p, 8), _mm256_set1_epi32(0xf800));
+  __m256i value = _mm256_or_si256(_mm256_or_si256(r, g), b);
+  return _mm256_srai_epi32(_mm256_slli_epi32(value, 16), 16);
+}
+
+CSCORE_TARGET_AVX2 static inline void RGB565ToBGR16(__m256i p, __m256i* b,
+                                                    __m256i* g, __m256i* r) {
+  *b = _mm256_slli_epi16(_mm256_srli_epi16(p, 11), 3);
+  *g = _mm256_and_si256(_mm256_srli_epi16(p, 3), _mm256_set1_epi16(0xfc));
+  *r = _mm256_and_si256(_mm256_slli_epi16(p, 3), _mm256_set1_epi16(0xf8));
+}
+
+CSCORE_TARGET_AVX2 static void YUYVToBGRAVX2(const uint8_t* src, uint8_t* dst,
+                                             size_t pixels) {
+  size_t i = 0;
+  for (; i + 34 <= pixels; i += 32, src += 64, dst += 96) {
+    __m256i b0, g0, r0, b1, g1, r1;
+    YUYVToBGR16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)),
+                &b0, &g0, &r0);
+    YUYVToBGR16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32)), &b1,
+        &g1, &r1);
+    StoreBGR32(dst, _mm256_packus_epi16(b0, b1), _mm256_packus_epi16(g0, g1),
+               _mm256_packus_epi16(r0, r1));
+  }
+  YUYVToBGRSSE2(src, dst, pixels - i);
+}
+
+CSCORE_TARGET_AVX2 static void YUYVToGrayAVX2(const uint8_t* src, uint8_t* dst,
+                                              size_t pixels) {
+  const __m256i mask = _mm256_set1_epi16(0xff);
+  size_t i = 0;
+  for (; i + 32 <= pixels; i += 32, src += 64, dst += 32) {
+    __m256i y0 = _mm256_and_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), mask);
+    __m256i y1 = _mm256_and_si256(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32)), mask);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                        _mm256_permute4x64_epi64(_mm256_packus_epi16(y0, y1),
+                                                 _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  YUYVToGraySSE2(src, dst, pixels - i);
+}
+
+CSCORE_TARGET_AVX2 static void BGRToRGB565AVX2(const uint8_t* src,
+                                               uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 18 <= pixels; i += 16, src += 48, dst += 32) {
+    __m256i value = _mm256_packs_epi32(BGRxToRGB565_8(LoadBGRx8(src)),
+                                       BGRxToRGB565_8(LoadBGRx8(src + 24)));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst),
+        _mm256_permute4x64_epi64(value, _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  BGRToRGB565SSE2(src, dst, pixels - i);
+}
+
+CSCORE_TARGET_AVX2 static void RGB565ToBGRAVX2(const uint8_t* src,
+                                               uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 34 <= pixels; i += 32, src += 64, dst += 96) {
+    __m256i b0, g0, r0, b1, g1, r1;
+    RGB565ToBGR16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)),
+                  &b0, &g0, &r0);
+    RGB565ToBGR16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32)), &b1,
+        &g1, &r1);
+    StoreBGR32(dst, _mm256_packus_epi16(b0, b1), _mm256_packus_epi16(g0, g1),
+               _mm256_packus_epi16(r0, r1));
+  }
+  RGB565ToBGRSSE2(src, dst, pixels - i);
+}
+
+CSCORE_TARGET_AVX2 static void BGRToGrayAVX2(const uint8_t* src, uint8_t* dst,
+                                             size_t pixels) {
+  const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  size_t i = 0;
+  for (; i + 34 <= pixels; i += 32, src += 96, dst += 32) {
+    __m256i y0 = _mm256_packs_epi32(BGRxToGray8(LoadBGRx8(src)),
+                                    BGRxToGray8(LoadBGRx8(src + 24)));
+    __m256i y1 = _mm256_packs_epi32(BGRxToGray8(LoadBGRx8(src + 48)),
+                                    BGRxToGray8(LoadBGRx8(src + 72)));
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst),
+        _mm256_permutevar8x32_epi32(_mm256_packus_epi16(y0, y1), order));
+  }
+  BGRToGraySSE2(src, dst, pixels - i);
+}
+
+CSCORE_TARGET_AVX2 static void GrayToBGRAVX2(const uint8_t* src, uint8_t* dst,
+                                             size_t pixels) {
+  size_t i = 0;
+  for (; i + 34 <= pixels; i += 32, src += 32, dst += 96) {
+    __m256i g = _mm256_permute4x64_epi64(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)),
+        _MM_SHUFFLE(3, 1, 2, 0));
+    StoreBGR32(dst, g, g, g);
+  }
+  GrayToBGRSSE2(src, dst, pixels - i);
+}
+
+static constexpr Kernels kAVX2Kernels{
+    "avx2",          YUYVToBGRAVX2, YUYVToGrayAVX2, BGRToRGB565AVX2,
+    RGB565ToBGRAVX2, BGRToGrayAVX2, GrayToBGRAVX2};
+
+static bool HasAVX2() {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  // the OS must also save the AVX registers (OSXSAVE and XCR0)
+  __cpuid(info, 1);
+  if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 ||
+      (_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif  // CSCORE_COLOR_AVX2
+
+//
+// NEON implementation
+//
+
+#ifdef CSCORE_COLOR_NEON
+
+static inline int16x8_t MulHi(int16x8_t a, int16_t b) {
+  return vcombine_s16(vshrn_n_s32(vmull_n_s16(vget_low_s16(a), b), 16),
+                      vshrn_n_s32(vmull_n_s16(vget_high_s16(a), b), 16));
+}
+
+// Converts 8 luma values and the matching chroma terms to B, G, and R
+static inline void YToBGR8(uint8x8_t y, int16x8_t bu, int16x8_t gu,
+                           int16x8_t rv, uint8x8_t* b, uint8x8_t* g,
+                           uint8x8_t* r) {
+  uint16x8_t ys = vshll_n_u8(vqsub_u8(y, vdup_n_u8(16)), 8);
+  int16x8_t yy = vreinterpretq_s16_u16(
+      vcombine_u16(vshrn_n_u32(vmull_n_u16(vget_low_u16(ys), kY), 16),
+                   vshrn_n_u32(vmull_n_u16(vget_high_u16(ys), kY), 16)));
+  const int16x8_t round = vdupq_n_s16(kRound);
+  *b = vqshrun_n_s16(vqaddq_s16(vqaddq_s16(yy, bu), round), 6);
+  *g = vqshrun_n_s16(vqaddq_s16(vqaddq_s16(yy, gu), round), 6);
+  *r = vqshrun_n_s16(vqaddq_s16(vqaddq_s16(yy, rv), round), 6);
+}
+
+static inline uint8x8_t Half(uint8x16_t value, int half) {
+  return half == 0 ? vget_low_u8(value) : vget_high_u8(value);
+}
+
+static void YUYVToBGRNEON(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 32 <= pixels; i += 32, src += 64, dst += 96) {
+    // Y (even pixels), U, Y (odd pixels), V
+    uint8x16x4_t in = vld4q_u8(src);
+    // indexed by [even/odd][half]
+    uint8x8_t b[2][2], g[2][2], r[2][2];
+    for (int half = 0; half < 2; ++half) {
+      const uint8x8_t center = vdup_n_u8(128);
+      int16x8_t u = vshlq_n_s16(
+          vreinterpretq_s16_u16(vsubl_u8(Half(in.val[1], half), center)), 8);
+      int16x8_t v = vshlq_n_s16(
+          vreinterpretq_s16_u16(vsubl_u8(Half(in.val[3], half), center)), 8);
+      int16x8_t bu = vaddq_s16(vshrq_n_s16(u, 1), MulHi(u, kUB));
+      int16x8_t gu = vaddq_s16(MulHi(u, kUG), MulHi(v, kVG));
+      int16x8_t rv = MulHi(v, kVR);
+      for (int j = 0; j < 2; ++j) {
+        YToBGR8(Half(in.val[j * 2], half), bu, gu, rv, &b[j][half],
+                &g[j][half], &r[j][half]);
+      }
+    }
+    // interleave even and odd pixels
+    uint8x16x2_t bz = vzipq_u8(vcombine_u8(b[0][0], b[0][1]),
+                               vcombine_u8(b[1][0], b[1][1]));
+    uint8x16x2_t gz = vzipq_u8(vcombine_u8(g[0][0], g[0][1]),
+                               vcombine_u8(g[1][0], g[1][1]));
+    uint8x16x2_t rz = vzipq_u8(vcombine_u8(r[0][0], r[0][1]),
+                               vcombine_u8(r[1][0], r[1][1]));
+    for (int k = 0; k < 2; ++k) {
+      uint8x16x3_t out;
+      out.val[0] = bz.val[k];
+      out.val[1] = gz.val[k];
+      out.val[2] = rz.val[k];
+      vst3q_u8(dst + k * 48, out);
+    }
+  }
+  YUYVToBGRScalar(src, dst, pixels - i);
+}
+
+static void YUYVToGrayNEON(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16, src += 32, dst += 16) {
+    vst1q_u8(dst, vld2q_u8(src).val[0]);
+  }
+  YUYVToGrayScalar(src, dst, pixels - i);
+}
+
+static void BGRToRGB565NEON(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16, src += 48, dst += 32) {
+    uint8x16x3_t in = vld3q_u8(src);
+    for (int half = 0; half < 2; ++half) {
+      uint16x8_t b =
+          vandq_u16(vshll_n_u8(Half(in.val[0], half), 8), vdupq_n_u16(0xf800));
+      uint16x8_t g =
+          vandq_u16(vshll_n_u8(Half(in.val[1], half), 3), vdupq_n_u16(0x7e0));
+      uint16x8_t r = vshrq_n_u16(vmovl_u8(Half(in.val[2], half)), 3);
+      uint16x8_t value = vorrq_u16(vorrq_u16(b, g), r);
+      vst1q_u8(dst + half * 16, vreinterpretq_u8_u16(value));
+    }
+  }
+  BGRToRGB565Scalar(src, dst, pixels - i);
+}
+
+static void RGB565ToBGRNEON(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16, src += 32, dst += 48) {
+    uint16x8_t p0 = vreinterpretq_u16_u8(vld1q_u8(src));
+    uint16x8_t p1 = vreinterpretq_u16_u8(vld1q_u8(src + 16));
+    uint8x16x3_t out;
+    out.val[0] = vandq_u8(
+        vcombine_u8(vshrn_n_u16(p0, 8), vshrn_n_u16(p1, 8)), vdupq_n_u8(0xf8));
+    out.val[1] = vandq_u8(
+        vcombine_u8(vshrn_n_u16(p0, 3), vshrn_n_u16(p1, 3)), vdupq_n_u8(0xfc));
+    out.val[2] = vcombine_u8(vmovn_u16(vshlq_n_u16(p0, 3)),
+                             vmovn_u16(vshlq_n_u16(p1, 3)));
+    vst3q_u8(dst, out);
+  }
+  RGB565ToBGRScalar(src, dst, pixels - i);
+}
+
+static void BGRToGrayNEON(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16, src += 48, dst += 16) {
+    uint8x16x3_t in = vld3q_u8(src);
+    uint16x8_t y[2];
+    for (int half = 0; half < 2; ++half) {
+      uint16x8_t b = vmovl_u8(Half(in.val[0], half));
+      uint16x8_t g = vmovl_u8(Half(in.val[1], half));
+      uint16x8_t r = vmovl_u8(Half(in.val[2], half));
+      uint32x4_t lo = vmull_n_u16(vget_low_u16(b), kGrayB);
+      lo = vmlal_n_u16(lo, vget_low_u16(g), kGrayG);
+      lo = vmlal_n_u16(lo, vget_low_u16(r), kGrayR);
+      uint32x4_t hi = vmull_n_u16(vget_high_u16(b), kGrayB);
+      hi = vmlal_n_u16(hi, vget_high_u16(g), kGrayG);
+      hi = vmlal_n_u16(hi, vget_high_u16(r), kGrayR);
+      y[half] = vcombine_u16(vrshrn_n_u32(lo, kGrayShift),
+                             vrshrn_n_u32(hi, kGrayShift));
+    }
+    vst1q_u8(dst, vcombine_u8(vmovn_u16(y[0]), vmovn_u16(y[1])));
+  }
+  BGRToGrayScalar(src, dst, pixels - i);
+}
+
+static void GrayToBGRNEON(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  size_t i = 0;
+  for (; i + 16 <= pixels; i += 16, src += 16, dst += 48) {
+    uint8x16x3_t out;
+    out.val[0] = out.val[1] = out.val[2] = vld1q_u8(src);
+    vst3q_u8(dst, out);
+  }
+  GrayToBGRScalar(src, dst, pixels - i);
+}
+
+static constexpr Kernels kNEONKernels{
+    "neon",          YUYVToBGRNEON, YUYVToGrayNEON, BGRToRGB565NEON,
+    RGB565ToBGRNEON, BGRToGrayNEON, GrayToBGRNEON};
+
+#endif  // CSCORE_COLOR_NEON
+
+// Available implementations, fastest first
+static const Kernels* const kAllKernels[] = {
+#ifdef CSCORE_COLOR_AVX2
+    &kAVX2Kernels,
+#endif
+#ifdef CSCORE_COLOR_SSE2
+    &kSSE2Kernels,
+#endif
+#ifdef CSCORE_COLOR_NEON
+    &kNEONKernels,
+#endif
+    &kScalarKernels};
+
+static bool IsSupported(const Kernels& kernels) {
+#ifdef CSCORE_COLOR_AVX2
+  if (&kernels == &kAVX2Kernels) {
+    return HasAVX2();
+  }
+#else
+  (void)kernels;
+#endif
+  return true;
+}
+
+// Only changed from the default for testing.  The kernels are constants, so
+// relaxed ordering is enough.
+static std::atomic<const Kernels*> gKernels{nullptr};
+
+static const Kernels& GetKernels() {
+  const Kernels* kernels = gKernels.load(std::memory_order_relaxed);
+  if (!kernels) {
+    for (auto&& available : kAllKernels) {
+      if (IsSupported(*available)) {
+        kernels = available;
+        break;
+      }
+    }
+    gKernels.store(kernels, std::memory_order_relaxed);
+  }
+  return *kernels;
+}
+
+namespace cs {
+
+void YUYVToBGR(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  GetKernels().yuyvToBGR(src, dst, pixels);
+}
+
+void YUYVToGray(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  GetKernels().yuyvToGray(src, dst, pixels);
+}
+
+void BGRToRGB565(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  GetKernels().bgrToRGB565(src, dst, pixels);
+}
+
+void RGB565ToBGR(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  GetKernels().rgb565ToBGR(src, dst, pixels);
+}
+
+void BGRToGray(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  GetKernels().bgrToGray(src, dst, pixels);
+}
+
+void GrayToBGR(const uint8_t* src, uint8_t* dst, size_t pixels) {
+  GetKernels().grayToBGR(src, dst, pixels);
+}
+
+const char* GetColorConvertImpl() {
+  return GetKernels().name;
+}
+
+bool SetColorConvertImpl(const char* name) {
+  for (auto&& kernels : kAllKernels) {
+    if (std::strcmp(kernels->name, name) == 0 && IsSupported(*kernels)) {
+      gKernels.store(kernels, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace cs
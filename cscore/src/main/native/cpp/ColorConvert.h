@@ -0,0 +1,45 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_COLORCONVERT_H_
+#define CSCORE_COLORCONVERT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace cs {
+
+// Pixel format conversion kernels.  These operate on whole images stored
+// without row padding (as cscore images are), so only the pixel count is
+// needed.  The fastest implementation available on the running CPU (AVX2 or
+// SSE2 on x86, NEON on ARM if compiled in) is selected on first use; all
+// implementations produce identical output.
+//
+// RGB565 uses the same byte layout as the OpenCV conversions cscore used
+// previously (COLOR_RGB2BGR565 applied to BGR data): red in the low 5 bits
+// and blue in the high 5 bits.
+
+// YUYV (YCbCr 4:2:2, BT.601 video range) to BGR.  pixels must be even.
+void YUYVToBGR(const uint8_t* src, uint8_t* dst, size_t pixels);
+
+// YUYV to grayscale; this just extracts the Y (luma) channel.
+void YUYVToGray(const uint8_t* src, uint8_t* dst, size_t pixels);
+
+void BGRToRGB565(const uint8_t* src, uint8_t* dst, size_t pixels);
+void RGB565ToBGR(const uint8_t* src, uint8_t* dst, size_t pixels);
+
+// Uses the same fixed-point weights as OpenCV's COLOR_BGR2GRAY.
+void BGRToGray(const uint8_t* src, uint8_t* dst, size_t pixels);
+void GrayToBGR(const uint8_t* src, uint8_t* dst, size_t pixels);
+
+// Name of the selected implementation ("avx2", "sse2", "neon", or "scalar")
+const char* GetColorConvertImpl();
+
+// Selects an implementation by name, for testing.  Returns false (leaving the
+// selection unchanged) if it isn't available on the running CPU.
+bool SetColorConvertImpl(const char* name);
+
+}  // namespace cs
+
+#endif  // CSCORE_COLORCONVERT_H_
@@ -38,6 +38,7 @@ bool ConfigurableSourceImpl::SetVideoMode(const VideoMode& mode,
     m_mode = mode;
     m_videoModes[0] = mode;
   }
+  PreallocateImages(mode);
   m_notifier.NotifySourceVideoMode(*this, mode);
   return true;
 }
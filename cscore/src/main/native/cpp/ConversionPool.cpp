@@ -0,0 +1,119 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ConversionPool.h"
+
+#include <algorithm>
+
+#include "SourceImpl.h"
+
+using namespace cs;
+
+// Maximum number of queued conversions; the oldest are dropped beyond this
+// (they would be stale by the time a worker got to them anyway).
+static constexpr size_t kMaxQueued = 64;
+
+// Default JPEG quality when the target doesn't specify one (same as the MJPEG
+// server default)
+static constexpr int kDefaultJpegQuality = 80;
+
+ConversionPool::~ConversionPool() {
+  Stop();
+}
+
+void ConversionPool::Submit(SourceImpl& source, const Frame& frame,
+                            wpi::ArrayRef<Target> targets) {
+  if (!frame || targets.empty()) {
+    return;
+  }
+  {
+    std::scoped_lock lock(m_mutex);
+    if (m_stopped) {
+      return;
+    }
+    if (!m_active) {
+      // start workers, leaving a core for the capture thread
+      size_t numThreads = std::thread::hardware_concurrency();
+      numThreads = std::clamp<size_t>(numThreads > 1 ? numThreads - 1 : 1, 1,
+                                      4);
+      m_active = true;
+      m_running.resize(numThreads, nullptr);
+      for (size_t i = 0; i < numThreads; ++i) {
+        m_threads.emplace_back([=] { WorkerMain(i); });
+      }
+    }
+    for (auto&& target : targets) {
+      if (m_tasks.size() >= kMaxQueued) {
+        m_tasks.pop_front();
+      }
+      m_tasks.push_back(Task{&source, frame, target});
+    }
+  }
+  m_taskCv.notify_all();
+}
+
+void ConversionPool::RemoveSource(const SourceImpl& source) {
+  std::unique_lock lock(m_mutex);
+  m_tasks.erase(
+      std::remove_if(m_tasks.begin(), m_tasks.end(),
+                     [&](const Task& task) { return task.source == &source; }),
+      m_tasks.end());
+  m_doneCv.wait(lock, [&] {
+    return std::find(m_running.begin(), m_running.end(), &source) ==
+           m_running.end();
+  });
+}
+
+void ConversionPool::Stop() {
+  {
+    std::scoped_lock lock(m_mutex);
+    m_stopped = true;
+    m_active = false;
+    m_tasks.clear();
+  }
+  m_taskCv.notify_all();
+  for (auto&& thread : m_threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  m_threads.clear();
+}
+
+void ConversionPool::WorkerMain(size_t index) {
+  std::unique_lock lock(m_mutex);
+  while (m_active) {
+    m_taskCv.wait(lock, [&] { return !m_active || !m_tasks.empty(); });
+    if (!m_active) {
+      break;
+    }
+    Task task = std::move(m_tasks.front());
+    m_tasks.pop_front();
+    m_running[index] = task.source;
+    lock.unlock();
+
+    // Skip frames that have already been replaced; sinks won't ask for them
+    if (task.source->GetCurFrame().GetSequence() == task.frame.GetSequence()) {
+      auto& target = task.target;
+      int width =
+          target.width != 0 ? target.width : task.frame.GetOriginalWidth();
+      int height =
+          target.height != 0 ? target.height : task.frame.GetOriginalHeight();
+      if (target.pixelFormat == VideoMode::kMJPEG) {
+        task.frame.GetImageMJPEG(width, height, target.jpegQuality,
+                                 target.jpegQuality == -1
+                                     ? kDefaultJpegQuality
+                                     : target.jpegQuality);
+      } else {
+        task.frame.GetImage(width, height, target.pixelFormat);
+      }
+    }
+    // release the frame before signaling the source is no longer in use
+    task.frame = Frame{};
+
+    lock.lock();
+    m_running[index] = nullptr;
+    m_doneCv.notify_all();
+  }
+}
@@ -0,0 +1,81 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_CONVERSIONPOOL_H_
+#define CSCORE_CONVERSIONPOOL_H_
+
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include <wpi/ArrayRef.h>
+#include <wpi/condition_variable.h>
+#include <wpi/mutex.h>
+
+#include "Frame.h"
+#include "cscore_cpp.h"
+
+namespace cs {
+
+class SourceImpl;
+
+// Instance-wide pool of worker threads that precompute derived images (e.g.
+// a low resolution MJPEG for dashboards) as soon as a frame is published, so
+// sinks asking for them find them already converted.
+//
+// Workers are started when the first conversion is submitted.  Conversions
+// for different frames (and different sources) run in parallel; conversions
+// of a single frame are serialized by the frame's mutex.
+class ConversionPool {
+ public:
+  // A derived image to precompute.  Zero width or height means the original
+  // frame size.  jpegQuality is only used for MJPEG (-1 for default).
+  struct Target {
+    VideoMode::PixelFormat pixelFormat = VideoMode::kMJPEG;
+    int width = 0;
+    int height = 0;
+    int jpegQuality = -1;
+  };
+
+  ConversionPool() = default;
+  ~ConversionPool();
+
+  ConversionPool(const ConversionPool&) = delete;
+  ConversionPool& operator=(const ConversionPool&) = delete;
+
+  // Queues conversions of a frame published by source.  If a newer frame
+  // has been published by the time a worker gets to it, the conversion is
+  // skipped.
+  void Submit(SourceImpl& source, const Frame& frame,
+              wpi::ArrayRef<Target> targets);
+
+  // Discards queued conversions for source and waits for any in progress to
+  // finish.  Must be called before the source is destroyed.
+  void RemoveSource(const SourceImpl& source);
+
+  void Stop();
+
+ private:
+  struct Task {
+    SourceImpl* source;
+    Frame frame;
+    Target target;
+  };
+
+  void WorkerMain(size_t index);
+
+  wpi::mutex m_mutex;
+  wpi::condition_variable m_taskCv;
+  wpi::condition_variable m_doneCv;
+  std::deque<Task> m_tasks;
+  std::vector<std::thread> m_threads;
+  // Source being converted by each worker (null if idle)
+  std::vector<const SourceImpl*> m_running;
+  bool m_active = false;
+  bool m_stopped = false;
+};
+
+}  // namespace cs
+
+#endif  // CSCORE_CONVERSIONPOOL_H_
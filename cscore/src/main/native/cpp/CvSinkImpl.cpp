@@ -65,12 +65,17 @@ uint64_t CvSinkImpl::GrabFrame(cv::Mat& image) {
     return 0;  // signal error
   }
 
-  if (!frame.GetCv(image)) {
+  Image* rawImage =
+      GetGrabImage(frame, frame.GetOriginalWidth(), frame.GetOriginalHeight(),
+                   VideoMode::kBGR);
+  if (!rawImage) {
     // Shouldn't happen, but just in case...
     std::this_thread::sleep_for(std::chrono::milliseconds(20));
     return 0;
   }
+  rawImage->AsMat().copyTo(image);
 
+  RecordFrameTelemetry(*source, frame);
   return frame.GetTime();
 }
 
@@ -91,15 +96,83 @@ uint64_t CvSinkImpl::GrabFrame(cv::Mat& image, double timeout) {
     return 0;  // signal error
   }
 
-  if (!frame.GetCv(image)) {
+  Image* rawImage =
+      GetGrabImage(frame, frame.GetOriginalWidth(), frame.GetOriginalHeight(),
+                   VideoMode::kBGR);
+  if (!rawImage) {
     // Shouldn't happen, but just in case...
     std::this_thread::sleep_for(std::chrono::milliseconds(20));
     return 0;
   }
+  rawImage->AsMat().copyTo(image);
 
+  RecordFrameTelemetry(*source, frame);
   return frame.GetTime();
 }
 
+uint64_t CvSinkImpl::GrabFrameDirect(cv::Mat& image) {
+  SetEnabled(true);
+
+  // the previous image is no longer needed
+  m_directFrame = Frame{};
+  m_directSource.reset();
+
+  auto source = GetSource();
+  if (!source) {
+    // Source disconnected; sleep for one second
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    return 0;
+  }
+
+  return GrabFrameDirectImpl(image, source,
+                             source->GetNextFrame());  // blocks
+}
+
+uint64_t CvSinkImpl::GrabFrameDirect(cv::Mat& image, double timeout) {
+  SetEnabled(true);
+
+  // the previous image is no longer needed
+  m_directFrame = Frame{};
+  m_directSource.reset();
+
+  auto source = GetSource();
+  if (!source) {
+    // Source disconnected; sleep for one second
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    return 0;
+  }
+
+  return GrabFrameDirectImpl(image, source,
+                             source->GetNextFrame(timeout));  // blocks
+}
+
+uint64_t CvSinkImpl::GrabFrameDirectImpl(
+    cv::Mat& image, const std::shared_ptr<SourceImpl>& source, Frame frame) {
+  if (!frame) {
+    // Bad frame; sleep for 20 ms so we don't consume all processor time.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return 0;  // signal error
+  }
+
+  Image* rawImage =
+      GetGrabImage(frame, frame.GetOriginalWidth(), frame.GetOriginalHeight(),
+                   VideoMode::kBGR);
+  if (!rawImage) {
+    // Shouldn't happen, but just in case...
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return 0;
+  }
+
+  // Images are never modified once added to a frame, so it's safe to hand
+  // out a header referencing the data for as long as the frame is alive.
+  image = rawImage->AsMat();
+  RecordFrameTelemetry(*source, frame);
+  uint64_t time = frame.GetTime();
+  m_directSource = source;
+  m_directFrame = std::move(frame);
+  return time;
+}
+
 // Send HTTP response and a stream of JPG-frames
 void CvSinkImpl::ThreadMain() {
   Enable();
@@ -174,6 +247,25 @@ uint64_t GrabSinkFrameTimeout(CS_Sink sink, cv::Mat& image, double timeout,
   return static_cast<CvSinkImpl&>(*data->sink).GrabFrame(image, timeout);
 }
 
+uint64_t GrabSinkFrameDirect(CS_Sink sink, cv::Mat& image, CS_Status* status) {
+  auto data = Instance::GetInstance().GetSink(sink);
+  if (!data || data->kind != CS_SINK_CV) {
+    *status = CS_INVALID_HANDLE;
+    return 0;
+  }
+  return static_cast<CvSinkImpl&>(*data->sink).GrabFrameDirect(image);
+}
+
+uint64_t GrabSinkFrameTimeoutDirect(CS_Sink sink, cv::Mat& image,
+                                    double timeout, CS_Status* status) {
+  auto data = Instance::GetInstance().GetSink(sink);
+  if (!data || data->kind != CS_SINK_CV) {
+    *status = CS_INVALID_HANDLE;
+    return 0;
+  }
+  return static_cast<CvSinkImpl&>(*data->sink).GrabFrameDirect(image, timeout);
+}
+
 std::string GetSinkError(CS_Sink sink, CS_Status* status) {
   auto data = Instance::GetInstance().GetSink(sink);
   if (!data || (data->kind & SinkMask) == 0) {
@@ -202,6 +294,48 @@ void SetSinkEnabled(CS_Sink sink, bool enabled, CS_Status* status) {
   static_cast<CvSinkImpl&>(*data->sink).SetEnabled(enabled);
 }
 
+void SetSinkROI(CS_Sink sink, int x, int y, int width, int height,
+                CS_Status* status) {
+  auto data = Instance::GetInstance().GetSink(sink);
+  if (!data || (data->kind & SinkMask) == 0) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  data->sink->SetROI(x, y, width, height);
+}
+
+void GetSinkROI(CS_Sink sink, int* x, int* y, int* width, int* height,
+                CS_Status* status) {
+  auto data = Instance::GetInstance().GetSink(sink);
+  if (!data || (data->kind & SinkMask) == 0) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  auto region = data->sink->GetRegion();
+  *x = region.x;
+  *y = region.y;
+  *width = region.width;
+  *height = region.height;
+}
+
+void SetSinkDecimation(CS_Sink sink, int decimation, CS_Status* status) {
+  auto data = Instance::GetInstance().GetSink(sink);
+  if (!data || (data->kind & SinkMask) == 0) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  data->sink->SetDecimation(decimation);
+}
+
+int GetSinkDecimation(CS_Sink sink, CS_Status* status) {
+  auto data = Instance::GetInstance().GetSink(sink);
+  if (!data || (data->kind & SinkMask) == 0) {
+    *status = CS_INVALID_HANDLE;
+    return 0;
+  }
+  return data->sink->GetRegion().decimation;
+}
+
 }  // namespace cs
 
 extern "C" {
@@ -258,4 +392,22 @@ void CS_SetSinkEnabled(CS_Sink sink, CS_Bool enabled, CS_Status* status) {
   return cs::SetSinkEnabled(sink, enabled, status);
 }
 
+void CS_SetSinkROI(CS_Sink sink, int x, int y, int width, int height,
+                   CS_Status* status) {
+  return cs::SetSinkROI(sink, x, y, width, height, status);
+}
+
+void CS_GetSinkROI(CS_Sink sink, int* x, int* y, int* width, int* height,
+                   CS_Status* status) {
+  return cs::GetSinkROI(sink, x, y, width, height, status);
+}
+
+void CS_SetSinkDecimation(CS_Sink sink, int decimation, CS_Status* status) {
+  return cs::SetSinkDecimation(sink, decimation, status);
+}
+
+int CS_GetSinkDecimation(CS_Sink sink, CS_Status* status) {
+  return cs::GetSinkDecimation(sink, status);
+}
+
 }  // extern "C"
@@ -9,6 +9,7 @@
 
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <thread>
 
 #include <opencv2/core/core.hpp>
@@ -36,9 +37,24 @@ class CvSinkImpl : public SinkImpl {
   uint64_t GrabFrame(cv::Mat& image);
   uint64_t GrabFrame(cv::Mat& image, double timeout);
 
+  // Like GrabFrame(), but image references the frame's data instead of a
+  // copy.  The frame is kept alive until the next grab.
+  uint64_t GrabFrameDirect(cv::Mat& image);
+  uint64_t GrabFrameDirect(cv::Mat& image, double timeout);
+
  private:
   void ThreadMain();
 
+  uint64_t GrabFrameDirectImpl(cv::Mat& image,
+                               const std::shared_ptr<SourceImpl>& source,
+                               Frame frame);
+
+  // Frame referenced by the last GrabFrameDirect() image, and its source,
+  // which the frame refers to (declared first so it outlives the frame, as
+  // the sink's source may be changed while the frame is held)
+  std::shared_ptr<SourceImpl> m_directSource;
+  Frame m_directFrame;
+
   std::atomic_bool m_active;  // set to false to terminate threads
   std::thread m_thread;
   std::function<void(uint64_t time)> m_processFrame;
@@ -0,0 +1,296 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "FileSourceImpl.h"
+
+#include <chrono>
+#include <cmath>
+
+#include <wpi/timestamp.h>
+
+#include "Instance.h"
+#include "Log.h"
+#include "Notifier.h"
+#include "c_util.h"
+#include "cscore_cpp.h"
+
+using namespace cs;
+
+FileSourceImpl::FileSourceImpl(const wpi::Twine& name, wpi::Logger& logger,
+                               Notifier& notifier, Telemetry& telemetry,
+                               const wpi::Twine& path, CS_PlaybackMode mode)
+    : SourceImpl{name, logger, notifier, telemetry}, m_playbackMode{mode} {
+  std::string error;
+  if (!m_reader.Open(path, &error)) {
+    SERROR("could not open '" << path << "': " << error);
+    return;
+  }
+
+  // The video mode is that of the first frame, at the average recorded rate
+  RecordingFrameHeader header;
+  if (!m_reader.ReadFrameHeader(0, &header)) {
+    SERROR("could not read '" << path << "'");
+    return;
+  }
+  m_mode.pixelFormat = header.pixelFormat;
+  m_mode.width = header.width;
+  m_mode.height = header.height;
+  m_mode.fps = 0;
+  size_t numFrames = m_reader.GetNumFrames();
+  uint64_t duration =
+      m_reader.GetFrameTime(numFrames - 1) - m_reader.GetFrameTime(0);
+  if (numFrames > 1 && duration > 0) {
+    m_mode.fps = std::lround((numFrames - 1) * 1.0e6 / duration);
+  }
+  m_videoModes.push_back(m_mode);
+  m_open = true;
+}
+
+FileSourceImpl::~FileSourceImpl() {
+  m_active = false;
+  {
+    std::scoped_lock lock(m_mutex);
+    m_playbackCv.notify_all();
+  }
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+void FileSourceImpl::Start() {
+  if (!m_open) {
+    return;
+  }
+  SetConnected(true);
+  m_notifier.NotifySource(*this, CS_SOURCE_VIDEOMODES_UPDATED);
+  m_notifier.NotifySourceVideoMode(*this, m_mode);
+  m_thread = std::thread(&FileSourceImpl::ThreadMain, this);
+}
+
+bool FileSourceImpl::SetVideoMode(const VideoMode& mode, CS_Status* status) {
+  // The recording can only be played back as it was recorded
+  std::scoped_lock lock(m_mutex);
+  if (mode != m_mode) {
+    *status = CS_UNSUPPORTED_MODE;
+    return false;
+  }
+  return true;
+}
+
+void FileSourceImpl::NumSinksChanged() {
+  // ignore
+}
+
+void FileSourceImpl::NumSinksEnabledChanged() {
+  // pauses or resumes playback
+  std::scoped_lock lock(m_mutex);
+  ++m_playbackGeneration;
+  m_playbackCv.notify_all();
+}
+
+void FileSourceImpl::SetPlaybackMode(CS_PlaybackMode mode) {
+  std::scoped_lock lock(m_mutex);
+  m_playbackMode = mode;
+  m_steps = 0;
+  ++m_playbackGeneration;
+  m_playbackCv.notify_all();
+}
+
+CS_PlaybackMode FileSourceImpl::GetPlaybackMode() const {
+  std::scoped_lock lock(m_mutex);
+  return m_playbackMode;
+}
+
+void FileSourceImpl::SetLoop(bool loop) {
+  std::scoped_lock lock(m_mutex);
+  m_loop = loop;
+  m_playbackCv.notify_all();
+}
+
+void FileSourceImpl::Step() {
+  std::scoped_lock lock(m_mutex);
+  ++m_steps;
+  m_playbackCv.notify_all();
+}
+
+void FileSourceImpl::Seek(double time) {
+  if (!m_open) {
+    return;
+  }
+  uint64_t offset = time > 0 ? static_cast<uint64_t>(time * 1.0e6) : 0;
+  std::scoped_lock lock(m_mutex);
+  m_nextFrame = m_reader.FindFrame(m_reader.GetFrameTime(0) + offset);
+  ++m_playbackGeneration;
+  m_playbackCv.notify_all();
+}
+
+void FileSourceImpl::ThreadMain() {
+  size_t numFrames = m_reader.GetNumFrames();
+
+  // Wall clock time corresponding to startFrameTime for original rate
+  // playback; reset whenever the playback generation changes.
+  uint64_t generation = 0;
+  bool synced = false;
+  uint64_t startTime = 0;
+  uint64_t startFrameTime = 0;
+
+  std::unique_lock lock(m_mutex);
+  while (m_active) {
+    // The connection strategy can change without notification, so poll
+    // while paused
+    if (!m_playbackCv.wait_for(lock, std::chrono::milliseconds(100), [&] {
+          return !m_active ||
+                 (IsEnabled() &&
+                  (m_playbackMode != CS_PLAYBACK_STEPPED || m_steps > 0) &&
+                  (m_nextFrame < numFrames || m_loop));
+        })) {
+      synced = false;
+      continue;
+    }
+    if (!m_active) {
+      break;
+    }
+    if (m_nextFrame >= numFrames) {
+      m_nextFrame = 0;
+      ++m_playbackGeneration;
+    }
+    size_t frameNum = m_nextFrame;
+
+    if (m_playbackMode == CS_PLAYBACK_ORIGINAL_RATE) {
+      uint64_t frameTime = m_reader.GetFrameTime(frameNum);
+      uint64_t now = wpi::Now();
+      if (!synced || generation != m_playbackGeneration ||
+          frameTime < startFrameTime) {
+        synced = true;
+        generation = m_playbackGeneration;
+        startTime = now;
+        startFrameTime = frameTime;
+      }
+      uint64_t target = startTime + (frameTime - startFrameTime);
+      if (target > now) {
+        // wait (waking early if playback is changed), then start over
+        m_playbackCv.wait_for(lock, std::chrono::microseconds(target - now));
+        continue;
+      }
+    }
+
+    ++m_nextFrame;
+    if (m_playbackMode == CS_PLAYBACK_STEPPED) {
+      --m_steps;
+    }
+    lock.unlock();
+
+    // Only this thread reads frame data, so the reader doesn't need the lock
+    RecordingFrameHeader header;
+    std::unique_ptr<Image> image;
+    if (m_reader.ReadFrameHeader(frameNum, &header)) {
+      image = AllocImage(header.pixelFormat, header.width, header.height,
+                         header.size);
+      if (!m_reader.ReadFrameData(image->data(), header.size)) {
+        image.reset();
+      }
+    }
+    if (image) {
+      PutFrame(std::move(image), wpi::Now());
+    } else {
+      PutError("error reading frame", wpi::Now());
+    }
+
+    lock.lock();
+  }
+}
+
+namespace cs {
+
+CS_Source CreateFileSource(const wpi::Twine& name, const wpi::Twine& path,
+                           CS_PlaybackMode mode, CS_Status* status) {
+  auto& inst = Instance::GetInstance();
+  auto source = std::make_shared<FileSourceImpl>(
+      name, inst.logger, inst.notifier, inst.telemetry, path, mode);
+  if (!source->IsOpen()) {
+    *status = CS_READ_FAILED;
+    return 0;
+  }
+  return inst.CreateSource(CS_SOURCE_FILE, source);
+}
+
+void SetFileSourcePlaybackMode(CS_Source source, CS_PlaybackMode mode,
+                               CS_Status* status) {
+  auto data = Instance::GetInstance().GetSource(source);
+  if (!data || data->kind != CS_SOURCE_FILE) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  static_cast<FileSourceImpl&>(*data->source).SetPlaybackMode(mode);
+}
+
+CS_PlaybackMode GetFileSourcePlaybackMode(CS_Source source,
+                                          CS_Status* status) {
+  auto data = Instance::GetInstance().GetSource(source);
+  if (!data || data->kind != CS_SOURCE_FILE) {
+    *status = CS_INVALID_HANDLE;
+    return CS_PLAYBACK_ORIGINAL_RATE;
+  }
+  return static_cast<FileSourceImpl&>(*data->source).GetPlaybackMode();
+}
+
+void SetFileSourceLoop(CS_Source source, bool loop, CS_Status* status) {
+  auto data = Instance::GetInstance().GetSource(source);
+  if (!data || data->kind != CS_SOURCE_FILE) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  static_cast<FileSourceImpl&>(*data->source).SetLoop(loop);
+}
+
+void StepFileSource(CS_Source source, CS_Status* status) {
+  auto data = Instance::GetInstance().GetSource(source);
+  if (!data || data->kind != CS_SOURCE_FILE) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  static_cast<FileSourceImpl&>(*data->source).Step();
+}
+
+void SeekFileSource(CS_Source source, double time, CS_Status* status) {
+  auto data = Instance::GetInstance().GetSource(source);
+  if (!data || data->kind != CS_SOURCE_FILE) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  static_cast<FileSourceImpl&>(*data->source).Seek(time);
+}
+
+}  // namespace cs
+
+extern "C" {
+
+CS_Source CS_CreateFileSource(const char* name, const char* path,
+                              enum CS_PlaybackMode mode, CS_Status* status) {
+  return cs::CreateFileSource(name, path, mode, status);
+}
+
+void CS_SetFileSourcePlaybackMode(CS_Source source, enum CS_PlaybackMode mode,
+                                  CS_Status* status) {
+  return cs::SetFileSourcePlaybackMode(source, mode, status);
+}
+
+enum CS_PlaybackMode CS_GetFileSourcePlaybackMode(CS_Source source,
+                                                  CS_Status* status) {
+  return cs::GetFileSourcePlaybackMode(source, status);
+}
+
+void CS_SetFileSourceLoop(CS_Source source, CS_Bool loop, CS_Status* status) {
+  return cs::SetFileSourceLoop(source, loop, status);
+}
+
+void CS_StepFileSource(CS_Source source, CS_Status* status) {
+  return cs::StepFileSource(source, status);
+}
+
+void CS_SeekFileSource(CS_Source source, double time, CS_Status* status) {
+  return cs::SeekFileSource(source, time, status);
+}
+
+}  // extern "C"
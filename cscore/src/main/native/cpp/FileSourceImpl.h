@@ -0,0 +1,73 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_FILESOURCEIMPL_H_
+#define CSCORE_FILESOURCEIMPL_H_
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <wpi/Twine.h>
+#include <wpi/condition_variable.h>
+
+#include "RecordingFile.h"
+#include "SourceImpl.h"
+
+namespace cs {
+
+// Plays back a file written by a recording sink.
+class FileSourceImpl : public SourceImpl {
+ public:
+  FileSourceImpl(const wpi::Twine& name, wpi::Logger& logger,
+                 Notifier& notifier, Telemetry& telemetry,
+                 const wpi::Twine& path, CS_PlaybackMode mode);
+  ~FileSourceImpl() override;
+
+  bool IsOpen() const { return m_open; }
+
+  void Start() override;
+
+  bool SetVideoMode(const VideoMode& mode, CS_Status* status) override;
+
+  void NumSinksChanged() override;
+  void NumSinksEnabledChanged() override;
+
+  void SetPlaybackMode(CS_PlaybackMode mode);
+  CS_PlaybackMode GetPlaybackMode() const;
+  void SetLoop(bool loop);
+
+  // Plays the next frame (in stepped mode).
+  void Step();
+
+  // Continues playback from the first frame at or after time (in seconds
+  // from the start of the recording).
+  void Seek(double time);
+
+ private:
+  void ThreadMain();
+
+  RecordingReader m_reader;
+  bool m_open{false};
+
+  //
+  // Variables protected by m_mutex
+  //
+  CS_PlaybackMode m_playbackMode;
+  bool m_loop{false};
+  size_t m_nextFrame{0};
+  // Number of frames requested by Step() but not yet played
+  int m_steps{0};
+  // Incremented by anything that invalidates the current playback timing
+  // (seeking, mode changes, pausing)
+  uint64_t m_playbackGeneration{0};
+  wpi::condition_variable m_playbackCv;
+
+  std::atomic_bool m_active{true};  // set to false to terminate thread
+  std::thread m_thread;
+};
+
+}  // namespace cs
+
+#endif  // CSCORE_FILESOURCEIMPL_H_
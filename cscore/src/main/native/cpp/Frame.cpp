@@ -4,23 +4,152 @@
 
 #include "Frame.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
+#include <wpi/Trace.h>
+#include <wpi/timestamp.h>
+
+#include "ColorConvert.h"
 #include "Instance.h"
 #include "Log.h"
 #include "SourceImpl.h"
+#include "Telemetry.h"
 
 using namespace cs;
 
+static int GetConvertTimeKind(VideoMode::PixelFormat pixelFormat) {
+  switch (pixelFormat) {
+    case VideoMode::kMJPEG:
+      return CS_SOURCE_CONVERT_TIME_MJPEG;
+    case VideoMode::kRGB565:
+      return CS_SOURCE_CONVERT_TIME_RGB565;
+    case VideoMode::kBGR:
+      return CS_SOURCE_CONVERT_TIME_BGR;
+    case VideoMode::kGray:
+      return CS_SOURCE_CONVERT_TIME_GRAY;
+    default:
+      return 0;
+  }
+}
+
+// Returns the largest JPEG decode scale (1, 2, 4, or 8) that still results
+// in an image at least as large as the requested size.
+static int GetJpegDecodeScale(const Image& image, int width, int height) {
+  for (int scale : {8, 4, 2}) {
+    if (width * scale <= image.width && height * scale <= image.height) {
+      return scale;
+    }
+  }
+  return 1;
+}
+
+static int GetJpegDecodeFlags(bool color, int scale) {
+  switch (scale) {
+    case 2:
+      return color ? cv::IMREAD_REDUCED_COLOR_2
+                   : cv::IMREAD_REDUCED_GRAYSCALE_2;
+    case 4:
+      return color ? cv::IMREAD_REDUCED_COLOR_4
+                   : cv::IMREAD_REDUCED_GRAYSCALE_4;
+    case 8:
+      return color ? cv::IMREAD_REDUCED_COLOR_8
+                   : cv::IMREAD_REDUCED_GRAYSCALE_8;
+    default:
+      return color ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE;
+  }
+}
+
+static int GetBytesPerPixel(VideoMode::PixelFormat pixelFormat) {
+  switch (pixelFormat) {
+    case VideoMode::kYUYV:
+    case VideoMode::kRGB565:
+      return 2;
+    case VideoMode::kBGR:
+      return 3;
+    default:
+      return 1;
+  }
+}
+
+static void ConvertToBGR(VideoMode::PixelFormat from, const uint8_t* src,
+                         uint8_t* dst, size_t pixels) {
+  switch (from) {
+    case VideoMode::kYUYV:
+      YUYVToBGR(src, dst, pixels);
+      break;
+    case VideoMode::kRGB565:
+      RGB565ToBGR(src, dst, pixels);
+      break;
+    case VideoMode::kGray:
+      GrayToBGR(src, dst, pixels);
+      break;
+    default:
+      std::memcpy(dst, src, pixels * 3);
+      break;
+  }
+}
+
+static void ConvertFromBGR(VideoMode::PixelFormat to, const uint8_t* src,
+                           uint8_t* dst, size_t pixels) {
+  switch (to) {
+    case VideoMode::kRGB565:
+      BGRToRGB565(src, dst, pixels);
+      break;
+    case VideoMode::kGray:
+      BGRToGray(src, dst, pixels);
+      break;
+    default:
+      std::memcpy(dst, src, pixels * 3);
+      break;
+  }
+}
+
+// Copies every step'th pixel
+static void Decimate(const uint8_t* src, uint8_t* dst, int pixels, int step,
+                     int bytesPerPixel) {
+  if (step == 1) {
+    std::memcpy(dst, src, pixels * bytesPerPixel);
+    return;
+  }
+  size_t stride = step * bytesPerPixel;
+  for (int i = 0; i < pixels; ++i, src += stride, dst += bytesPerPixel) {
+    std::memcpy(dst, src, bytesPerPixel);
+  }
+}
+
+// Converts a run of pixels between uncompressed formats, going through BGR
+// (in the bgr buffer) if there's no direct conversion
+static void ConvertPixels(VideoMode::PixelFormat from,
+                          VideoMode::PixelFormat to, const uint8_t* src,
+                          uint8_t* dst, size_t pixels,
+                          std::vector<uint8_t>& bgr) {
+  if (from == to) {
+    std::memcpy(dst, src, pixels * GetBytesPerPixel(from));
+  } else if (to == VideoMode::kBGR) {
+    ConvertToBGR(from, src, dst, pixels);
+  } else if (from == VideoMode::kBGR) {
+    ConvertFromBGR(to, src, dst, pixels);
+  } else if (from == VideoMode::kYUYV && to == VideoMode::kGray) {
+    YUYVToGray(src, dst, pixels);
+  } else {
+    bgr.resize(pixels * 3);
+    ConvertToBGR(from, src, bgr.data(), pixels);
+    ConvertFromBGR(to, bgr.data(), dst, pixels);
+  }
+}
+
 Frame::Frame(SourceImpl& source, const wpi::Twine& error, Time time)
     : m_impl{source.AllocFrameImpl().release()} {
   m_impl->refcount = 1;
   m_impl->error = error.str();
   m_impl->time = time;
+  m_impl->sequence = 0;
 }
 
 Frame::Frame(SourceImpl& source, std::unique_ptr<Image> image, Time time)
@@ -28,6 +157,7 @@ Frame::Frame(SourceImpl& source, std::unique_ptr<Image> image, Time time)
   m_impl->refcount = 1;
   m_impl->error.resize(0);
   m_impl->time = time;
+  m_impl->sequence = 0;
   m_impl->images.push_back(image.release());
 }
 
@@ -201,6 +331,7 @@ Image* Frame::ConvertImpl(Image* image, VideoMode::PixelFormat pixelFormat,
                           requiredJpegQuality)) {
     return image;
   }
+  WPI_TRACE_SPAN("cscore convert");
   Image* cur = image;
 
   // If the source image is a JPEG, we need to decode it before we can do
@@ -237,15 +368,10 @@ Image* Frame::ConvertImpl(Image* image, VideoMode::PixelFormat pixelFormat,
       }
       return ConvertBGRToRGB565(cur);
     case VideoMode::kGray:
-      // If source is YUYV or RGB565, need to convert to BGR first
+      // YUYV already has a luma channel; otherwise, if source is RGB565, need
+      // to convert to BGR first
       if (cur->pixelFormat == VideoMode::kYUYV) {
-        // Check to see if BGR version already exists...
-        if (Image* newImage =
-                GetExistingImage(cur->width, cur->height, VideoMode::kBGR)) {
-          cur = newImage;
-        } else {
-          cur = ConvertYUYVToBGR(cur);
-        }
+        return ConvertYUYVToGray(cur);
       } else if (cur->pixelFormat == VideoMode::kRGB565) {
         // Check to see if BGR version already exists...
         if (Image* newImage =
@@ -259,6 +385,13 @@ Image* Frame::ConvertImpl(Image* image, VideoMode::PixelFormat pixelFormat,
     case VideoMode::kBGR:
     case VideoMode::kMJPEG:
       if (cur->pixelFormat == VideoMode::kYUYV) {
+        // Compress directly if possible rather than going through BGR
+        if (pixelFormat == VideoMode::kMJPEG &&
+            JpegEncoder::IsSupported(VideoMode::kYUYV)) {
+          if (Image* newImage = ConvertYUYVToMJPEG(cur, defaultJpegQuality)) {
+            return newImage;
+          }
+        }
         cur = ConvertYUYVToBGR(cur);
       } else if (cur->pixelFormat == VideoMode::kRGB565) {
         cur = ConvertRGB565ToBGR(cur);
@@ -283,19 +416,30 @@ Image* Frame::ConvertImpl(Image* image, VideoMode::PixelFormat pixelFormat,
   return cur;
 }
 
-Image* Frame::ConvertMJPEGToBGR(Image* image) {
+Image* Frame::ConvertMJPEGToBGR(Image* image, int scale) {
   if (!image || image->pixelFormat != VideoMode::kMJPEG) {
     return nullptr;
   }
 
-  // Allocate an BGR image
-  auto newImage =
-      m_impl->source.AllocImage(VideoMode::kBGR, image->width, image->height,
-                                image->width * image->height * 3);
+  // Allocate an BGR image.  Scaled decoding happens in the DCT domain and
+  // rounds the size up.
+  int width = (image->width + scale - 1) / scale;
+  int height = (image->height + scale - 1) / scale;
+  auto newImage = m_impl->source.AllocImage(VideoMode::kBGR, width, height,
+                                            width * height * 3);
 
   // Decode
   cv::Mat newMat = newImage->AsMat();
-  cv::imdecode(image->AsInputArray(), cv::IMREAD_COLOR, &newMat);
+  cv::imdecode(image->AsInputArray(), GetJpegDecodeFlags(true, scale),
+               &newMat);
+  if (newMat.data != reinterpret_cast<uchar*>(newImage->data())) {
+    // The decoder produced a different size than expected and reallocated
+    newImage = m_impl->source.AllocImage(VideoMode::kBGR, newMat.cols,
+                                         newMat.rows,
+                                         newMat.total() * newMat.elemSize());
+    cv::Mat copyMat = newImage->AsMat();
+    newMat.copyTo(copyMat);
+  }
 
   // Save the result
   Image* rv = newImage.release();
@@ -306,19 +450,30 @@ Image* Frame::ConvertMJPEGToBGR(Image* image) {
   return rv;
 }
 
-Image* Frame::ConvertMJPEGToGray(Image* image) {
+Image* Frame::ConvertMJPEGToGray(Image* image, int scale) {
   if (!image || image->pixelFormat != VideoMode::kMJPEG) {
     return nullptr;
   }
 
-  // Allocate an grayscale image
-  auto newImage =
-      m_impl->source.AllocImage(VideoMode::kGray, image->width, image->height,
-                                image->width * image->height);
+  // Allocate an grayscale image.  Scaled decoding happens in the DCT domain and
+  // rounds the size up.
+  int width = (image->width + scale - 1) / scale;
+  int height = (image->height + scale - 1) / scale;
+  auto newImage = m_impl->source.AllocImage(VideoMode::kGray, width, height,
+                                            width * height);
 
   // Decode
   cv::Mat newMat = newImage->AsMat();
-  cv::imdecode(image->AsInputArray(), cv::IMREAD_GRAYSCALE, &newMat);
+  cv::imdecode(image->AsInputArray(), GetJpegDecodeFlags(false, scale),
+               &newMat);
+  if (newMat.data != reinterpret_cast<uchar*>(newImage->data())) {
+    // The decoder produced a different size than expected and reallocated
+    newImage = m_impl->source.AllocImage(VideoMode::kGray, newMat.cols,
+                                         newMat.rows,
+                                         newMat.total() * newMat.elemSize());
+    cv::Mat copyMat = newImage->AsMat();
+    newMat.copyTo(copyMat);
+  }
 
   // Save the result
   Image* rv = newImage.release();
@@ -340,7 +495,33 @@ Image* Frame::ConvertYUYVToBGR(Image* image) {
                                 image->width * image->height * 3);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_YUV2BGR_YUYV);
+  YUYVToBGR(reinterpret_cast<const uint8_t*>(image->data()),
+            reinterpret_cast<uint8_t*>(newImage->data()),
+            image->width * image->height);
+
+  // Save the result
+  Image* rv = newImage.release();
+  if (m_impl) {
+    std::scoped_lock lock(m_impl->mutex);
+    m_impl->images.push_back(rv);
+  }
+  return rv;
+}
+
+Image* Frame::ConvertYUYVToGray(Image* image) {
+  if (!image || image->pixelFormat != VideoMode::kYUYV) {
+    return nullptr;
+  }
+
+  // Allocate a Grayscale image
+  auto newImage =
+      m_impl->source.AllocImage(VideoMode::kGray, image->width, image->height,
+                                image->width * image->height);
+
+  // Extract the Y channel
+  YUYVToGray(reinterpret_cast<const uint8_t*>(image->data()),
+             reinterpret_cast<uint8_t*>(newImage->data()),
+             image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -362,7 +543,9 @@ Image* Frame::ConvertBGRToRGB565(Image* image) {
                                 image->width * image->height * 2);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_RGB2BGR565);
+  BGRToRGB565(reinterpret_cast<const uint8_t*>(image->data()),
+              reinterpret_cast<uint8_t*>(newImage->data()),
+              image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -384,7 +567,9 @@ Image* Frame::ConvertRGB565ToBGR(Image* image) {
                                 image->width * image->height * 3);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_BGR5652RGB);
+  RGB565ToBGR(reinterpret_cast<const uint8_t*>(image->data()),
+              reinterpret_cast<uint8_t*>(newImage->data()),
+              image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -406,7 +591,9 @@ Image* Frame::ConvertBGRToGray(Image* image) {
                                 image->width * image->height);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_BGR2GRAY);
+  BGRToGray(reinterpret_cast<const uint8_t*>(image->data()),
+            reinterpret_cast<uint8_t*>(newImage->data()),
+            image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -428,7 +615,9 @@ Image* Frame::ConvertGrayToBGR(Image* image) {
                                 image->width * image->height * 3);
 
   // Convert
-  cv::cvtColor(image->AsMat(), newImage->AsMat(), cv::COLOR_GRAY2BGR);
+  GrayToBGR(reinterpret_cast<const uint8_t*>(image->data()),
+            reinterpret_cast<uint8_t*>(newImage->data()),
+            image->width * image->height);
 
   // Save the result
   Image* rv = newImage.release();
@@ -458,15 +647,18 @@ Image* Frame::ConvertBGRToMJPEG(Image* image, int quality) {
       m_impl->source.AllocImage(VideoMode::kMJPEG, image->width, image->height,
                                 image->width * image->height * 1.5);
 
-  // Compress
-  if (m_impl->compressionParams.empty()) {
-    m_impl->compressionParams.push_back(cv::IMWRITE_JPEG_QUALITY);
-    m_impl->compressionParams.push_back(quality);
-  } else {
-    m_impl->compressionParams[1] = quality;
+  // Compress (falling back to OpenCV if the direct encoder is unavailable)
+  if (!m_impl->source.GetJpegEncoder().Encode(*image, newImage.get(),
+                                              quality)) {
+    if (m_impl->compressionParams.empty()) {
+      m_impl->compressionParams.push_back(cv::IMWRITE_JPEG_QUALITY);
+      m_impl->compressionParams.push_back(quality);
+    } else {
+      m_impl->compressionParams[1] = quality;
+    }
+    cv::imencode(".jpg", image->AsMat(), newImage->vec(),
+                 m_impl->compressionParams);
   }
-  cv::imencode(".jpg", image->AsMat(), newImage->vec(),
-               m_impl->compressionParams);
 
   // Save the result
   Image* rv = newImage.release();
@@ -493,15 +685,46 @@ Image* Frame::ConvertGrayToMJPEG(Image* image, int quality) {
       m_impl->source.AllocImage(VideoMode::kMJPEG, image->width, image->height,
                                 image->width * image->height * 0.75);
 
-  // Compress
-  if (m_impl->compressionParams.empty()) {
-    m_impl->compressionParams.push_back(cv::IMWRITE_JPEG_QUALITY);
-    m_impl->compressionParams.push_back(quality);
-  } else {
-    m_impl->compressionParams[1] = quality;
+  // Compress (falling back to OpenCV if the direct encoder is unavailable)
+  if (!m_impl->source.GetJpegEncoder().Encode(*image, newImage.get(),
+                                              quality)) {
+    if (m_impl->compressionParams.empty()) {
+      m_impl->compressionParams.push_back(cv::IMWRITE_JPEG_QUALITY);
+      m_impl->compressionParams.push_back(quality);
+    } else {
+      m_impl->compressionParams[1] = quality;
+    }
+    cv::imencode(".jpg", image->AsMat(), newImage->vec(),
+                 m_impl->compressionParams);
+  }
+
+  // Save the result
+  Image* rv = newImage.release();
+  m_impl->images.push_back(rv);
+  return rv;
+}
+
+Image* Frame::ConvertYUYVToMJPEG(Image* image, int quality) {
+  if (!image || image->pixelFormat != VideoMode::kYUYV) {
+    return nullptr;
+  }
+  if (!m_impl) {
+    return nullptr;
+  }
+  std::scoped_lock lock(m_impl->mutex);
+
+  // Allocate a JPEG image.  As with BGR, assume 50% space savings over the
+  // equivalent BGR image.
+  auto newImage =
+      m_impl->source.AllocImage(VideoMode::kMJPEG, image->width, image->height,
+                                image->width * image->height * 1.5);
+
+  // Compress directly from YCbCr 4:2:2; there is no OpenCV equivalent, so
+  // the caller needs to convert to BGR if this fails.
+  if (!m_impl->source.GetJpegEncoder().Encode(*image, newImage.get(),
+                                              quality)) {
+    return nullptr;
   }
-  cv::imencode(".jpg", image->AsMat(), newImage->vec(),
-               m_impl->compressionParams);
 
   // Save the result
   Image* rv = newImage.release();
@@ -526,16 +749,24 @@ Image* Frame::GetImageImpl(int width, int height,
                                       << " type " << cur->pixelFormat << " to "
                                       << width << "x" << height << " type "
                                       << pixelFormat);
+  uint64_t start = wpi::Now();
 
   // If the source image is a JPEG, we need to decode it before we can do
   // anything else with it.  Note that if the destination format is JPEG, we
   // still need to do this (unless the width/height/compression were the same,
-  // in which case we already returned the existing JPEG above).
+  // in which case we already returned the existing JPEG above).  If the
+  // destination is at most half the size, decode at a reduced scale; this is
+  // much cheaper than decoding at full size and resizing.
   if (cur->pixelFormat == VideoMode::kMJPEG) {
-    cur = ConvertMJPEGToBGR(cur);
+    int scale = GetJpegDecodeScale(*cur, width, height);
+    if (pixelFormat == VideoMode::kGray) {
+      cur = ConvertMJPEGToGray(cur, scale);
+    } else {
+      cur = ConvertMJPEGToBGR(cur, scale);
+    }
   }
 
-  // Resize
+  // Resize (any residual after scaled decoding)
   if (!cur->Is(width, height)) {
     // Allocate an image.
     auto newImage = m_impl->source.AllocImage(
@@ -552,7 +783,205 @@ Image* Frame::GetImageImpl(int width, int height,
   }
 
   // Convert to output format
-  return ConvertImpl(cur, pixelFormat, requiredJpegQuality, defaultJpegQuality);
+  cur = ConvertImpl(cur, pixelFormat, requiredJpegQuality, defaultJpegQuality);
+
+  if (int kind = GetConvertTimeKind(pixelFormat)) {
+    m_impl->source.GetTelemetryCounters()->Record(
+        static_cast<CS_TelemetryKind>(kind), wpi::Now() - start);
+  }
+  return cur;
+}
+
+static bool IsSameRegion(const Frame::Region& a, const Frame::Region& b) {
+  return a.x == b.x && a.y == b.y && a.width == b.width &&
+         a.height == b.height && a.decimation == b.decimation;
+}
+
+Image* Frame::GetRegionImage(const Region& region,
+                             VideoMode::PixelFormat pixelFormat) {
+  if (!m_impl) {
+    return nullptr;
+  }
+  std::scoped_lock lock(m_impl->mutex);
+  if (m_impl->images.empty()) {
+    return nullptr;
+  }
+  Image* original = m_impl->images[0];
+  int origWidth = original->width;
+  int origHeight = original->height;
+
+  // Clip to the image
+  Region r = region;
+  if (r.width <= 0 || r.height <= 0) {
+    r.x = 0;
+    r.y = 0;
+    r.width = origWidth;
+    r.height = origHeight;
+  }
+  int x2 = std::clamp(r.x + r.width, 0, origWidth);
+  int y2 = std::clamp(r.y + r.height, 0, origHeight);
+  r.x = std::clamp(r.x, 0, origWidth);
+  r.y = std::clamp(r.y, 0, origHeight);
+  r.width = x2 - r.x;
+  r.height = y2 - r.y;
+  if (r.width <= 0 || r.height <= 0) {
+    return nullptr;
+  }
+  r.decimation = (std::max)(r.decimation, 1);
+  int width = (std::max)(r.width / r.decimation, 1);
+  int height = (std::max)(r.height / r.decimation, 1);
+
+  // Whole image; use the normal conversion path, which also shares the
+  // result with other sinks
+  if (r.width == origWidth && r.height == origHeight) {
+    return GetImageImpl(width, height, pixelFormat, -1, 80);
+  }
+
+  // Nothing is converted to YUYV, whole image or not
+  if (pixelFormat != VideoMode::kBGR && pixelFormat != VideoMode::kGray &&
+      pixelFormat != VideoMode::kRGB565 && pixelFormat != VideoMode::kMJPEG) {
+    return nullptr;
+  }
+
+  for (auto&& [key, image] : m_impl->regionImages) {
+    if (IsSameRegion(key, r) && image->pixelFormat == pixelFormat) {
+      return image;
+    }
+  }
+
+  uint64_t start = wpi::Now();
+
+  // Compressed regions are cropped in BGR and then encoded
+  if (pixelFormat == VideoMode::kMJPEG) {
+    Image* jpeg = ConvertBGRToMJPEG(GetRegionImage(r, VideoMode::kBGR), 80);
+    if (!jpeg) {
+      return nullptr;
+    }
+    // Keep it with the region images rather than the whole frame images, so
+    // it isn't mistaken for the whole frame scaled to the region's size
+    m_impl->images.pop_back();
+    m_impl->regionImages.emplace_back(r, jpeg);
+    m_impl->source.GetTelemetryCounters()->Record(
+        CS_SOURCE_CONVERT_TIME_MJPEG, wpi::Now() - start);
+    return jpeg;
+  }
+
+  std::unique_ptr<Image> newImage;
+
+  // Prefer cropping a full size uncompressed image, ideally one that's
+  // already in the right format
+  Image* cur = GetExistingImage(origWidth, origHeight, pixelFormat);
+  if (!cur) {
+    for (auto i : m_impl->images) {
+      if (i->Is(origWidth, origHeight) && i->pixelFormat != VideoMode::kMJPEG) {
+        cur = i;
+        break;
+      }
+    }
+  }
+  if (cur) {
+    newImage = ExtractRegion(*cur, r.x, r.y, r.width, r.height, r.decimation,
+                             pixelFormat);
+  } else if (original->pixelFormat == VideoMode::kMJPEG) {
+    // Decode at a reduced scale if the decimation allows it
+    int scale = 1;
+    for (int s : {8, 4, 2}) {
+      if (r.decimation % s == 0 && r.width >= s && r.height >= s) {
+        scale = s;
+        break;
+      }
+    }
+    auto decodeFormat = pixelFormat == VideoMode::kGray ? VideoMode::kGray
+                                                        : VideoMode::kBGR;
+    int decodeWidth = r.width / scale;
+    int decodeHeight = r.height / scale;
+    int decimation = r.decimation / scale;
+
+    // Decode only the region if possible
+    auto decoded = m_impl->source.AllocImage(
+        decodeFormat, decodeWidth, decodeHeight,
+        decodeWidth * decodeHeight * GetBytesPerPixel(decodeFormat));
+    if (m_impl->source.GetJpegDecoder().DecodeRegion(
+            *original, scale, r.x / scale, r.y / scale, decoded.get())) {
+      if (decimation == 1 && decodeFormat == pixelFormat) {
+        newImage = std::move(decoded);
+      } else {
+        newImage = ExtractRegion(*decoded, 0, 0, decodeWidth, decodeHeight,
+                                 decimation, pixelFormat);
+        m_impl->source.ReleaseImage(std::move(decoded));
+      }
+    } else {
+      m_impl->source.ReleaseImage(std::move(decoded));
+      // Decode the whole image and crop it
+      if (Image* full = GetImageImpl(origWidth / scale, origHeight / scale,
+                                     decodeFormat, -1, 80)) {
+        newImage = ExtractRegion(*full, r.x / scale, r.y / scale, decodeWidth,
+                                 decodeHeight, decimation, pixelFormat);
+      }
+    }
+  }
+  if (!newImage) {
+    return nullptr;
+  }
+
+  if (int kind = GetConvertTimeKind(pixelFormat)) {
+    m_impl->source.GetTelemetryCounters()->Record(
+        static_cast<CS_TelemetryKind>(kind), wpi::Now() - start);
+  }
+
+  // Save the result
+  Image* rv = newImage.release();
+  m_impl->regionImages.emplace_back(r, rv);
+  return rv;
+}
+
+std::unique_ptr<Image> Frame::ExtractRegion(
+    const Image& image, int x, int y, int width, int height, int decimation,
+    VideoMode::PixelFormat pixelFormat) {
+  int outWidth = (std::max)(width / decimation, 1);
+  int outHeight = (std::max)(height / decimation, 1);
+  int inBpp = GetBytesPerPixel(image.pixelFormat);
+  int outBpp = GetBytesPerPixel(pixelFormat);
+  auto newImage = m_impl->source.AllocImage(pixelFormat, outWidth, outHeight,
+                                            outWidth * outHeight * outBpp);
+
+  // YUYV pixels come in pairs, so the span of each row covering the region
+  // is converted before picking pixels.  For other formats, pixels are picked
+  // first so only those are converted.
+  int x1 = x;
+  size_t span = 0;
+  std::vector<uint8_t> row;
+  if (image.pixelFormat == VideoMode::kYUYV) {
+    x1 &= ~1;
+    int x2 = x + (outWidth - 1) * decimation + 1;
+    span = (std::min)((x2 + 1) & ~1, image.width) - x1;
+    row.resize(span * outBpp);
+  } else if (decimation > 1) {
+    row.resize(outWidth * inBpp);
+  }
+  std::vector<uint8_t> bgr;
+
+  auto in = reinterpret_cast<const uint8_t*>(image.data());
+  auto out = reinterpret_cast<uint8_t*>(newImage->data());
+  for (int i = 0; i < outHeight; ++i) {
+    const uint8_t* src =
+        in + (static_cast<size_t>(y + i * decimation) * image.width + x1) *
+                 inBpp;
+    uint8_t* dst = out + static_cast<size_t>(i) * outWidth * outBpp;
+    if (image.pixelFormat == VideoMode::kYUYV) {
+      ConvertPixels(image.pixelFormat, pixelFormat, src, row.data(), span,
+                    bgr);
+      Decimate(row.data() + (x - x1) * outBpp, dst, outWidth, decimation,
+               outBpp);
+    } else if (decimation == 1) {
+      ConvertPixels(image.pixelFormat, pixelFormat, src, dst, outWidth, bgr);
+    } else {
+      Decimate(src, row.data(), outWidth, decimation, inBpp);
+      ConvertPixels(image.pixelFormat, pixelFormat, row.data(), dst, outWidth,
+                    bgr);
+    }
+  }
+  return newImage;
 }
 
 bool Frame::GetCv(cv::Mat& image, int width, int height) {
@@ -569,6 +998,10 @@ void Frame::ReleaseFrame() {
     m_impl->source.ReleaseImage(std::unique_ptr<Image>(image));
   }
   m_impl->images.clear();
+  for (auto&& regionImage : m_impl->regionImages) {
+    m_impl->source.ReleaseImage(std::unique_ptr<Image>(regionImage.second));
+  }
+  m_impl->regionImages.clear();
   m_impl->source.ReleaseFrameImpl(std::unique_ptr<Impl>(m_impl));
   m_impl = nullptr;
 }
@@ -28,6 +28,17 @@ class Frame {
  public:
   using Time = uint64_t;
 
+  // A rectangle of the original image, decimated by an integer factor (the
+  // resulting image is width / decimation by height / decimation).  A zero
+  // width or height means the whole image.
+  struct Region {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+    int decimation = 1;
+  };
+
  private:
   struct Impl {
     explicit Impl(SourceImpl& source_) : source(source_) {}
@@ -35,9 +46,13 @@ class Frame {
     wpi::recursive_mutex mutex;
     std::atomic_int refcount{0};
     Time time{0};
+    uint64_t sequence{0};
     SourceImpl& source;
     std::string error;
     wpi::SmallVector<Image*, 4> images;
+    // Images of part of the frame (see GetRegionImage()); kept separately as
+    // they can't be used as the source for other conversions
+    wpi::SmallVector<std::pair<Region, Image*>, 2> regionImages;
     std::vector<int> compressionParams;
   };
 
@@ -72,6 +87,10 @@ class Frame {
 
   Time GetTime() const { return m_impl ? m_impl->time : 0; }
 
+  // Sequence number assigned by the source when the frame was published
+  // (0 for error frames).  Sinks use this to count dropped frames.
+  uint64_t GetSequence() const { return m_impl ? m_impl->sequence : 0; }
+
   wpi::StringRef GetError() const {
     if (!m_impl) {
       return {};
@@ -192,15 +211,18 @@ class Frame {
     return ConvertImpl(image, VideoMode::kMJPEG, requiredQuality,
                        defaultQuality);
   }
-  Image* ConvertMJPEGToBGR(Image* image);
-  Image* ConvertMJPEGToGray(Image* image);
+  // The scale (1, 2, 4, or 8) reduces the decoded size by that factor
+  Image* ConvertMJPEGToBGR(Image* image, int scale = 1);
+  Image* ConvertMJPEGToGray(Image* image, int scale = 1);
   Image* ConvertYUYVToBGR(Image* image);
+  Image* ConvertYUYVToGray(Image* image);
   Image* ConvertBGRToRGB565(Image* image);
   Image* ConvertRGB565ToBGR(Image* image);
   Image* ConvertBGRToGray(Image* image);
   Image* ConvertGrayToBGR(Image* image);
   Image* ConvertBGRToMJPEG(Image* image, int quality);
   Image* ConvertGrayToMJPEG(Image* image, int quality);
+  Image* ConvertYUYVToMJPEG(Image* image, int quality);
 
   Image* GetImage(int width, int height, VideoMode::PixelFormat pixelFormat) {
     if (pixelFormat == VideoMode::kMJPEG) {
@@ -214,6 +236,13 @@ class Frame {
                         defaultQuality);
   }
 
+  // Gets an image of a region of the frame.  Cropped regions are supported
+  // in the BGR, grayscale, RGB565 and MJPEG formats (MJPEG regions are
+  // cropped in BGR and then encoded).  Returns nullptr if the region is
+  // outside the image or the format is not supported.
+  Image* GetRegionImage(const Region& region,
+                        VideoMode::PixelFormat pixelFormat);
+
   bool GetCv(cv::Mat& image) {
     return GetCv(image, GetOriginalWidth(), GetOriginalHeight());
   }
@@ -224,6 +253,9 @@ class Frame {
                      int requiredJpegQuality, int defaultJpegQuality);
   Image* GetImageImpl(int width, int height, VideoMode::PixelFormat pixelFormat,
                       int requiredJpegQuality, int defaultJpegQuality);
+  std::unique_ptr<Image> ExtractRegion(const Image& image, int x, int y,
+                                       int width, int height, int decimation,
+                                       VideoMode::PixelFormat pixelFormat);
   void DecRef() {
     if (m_impl && --(m_impl->refcount) == 0) {
       ReleaseFrame();
@@ -4,9 +4,15 @@
 
 #include "HttpCameraImpl.h"
 
+#include <cstring>
+
+#include <wpi/HttpParser.h>
 #include <wpi/MemAlloc.h>
 #include <wpi/TCPConnector.h>
 #include <wpi/timestamp.h>
+#include <wpi/uv/GetAddrInfo.h>
+#include <wpi/uv/Tcp.h>
+#include <wpi/uv/Timer.h>
 
 #include "Handle.h"
 #include "Instance.h"
@@ -18,6 +24,80 @@
 
 using namespace cs;
 
+// Receives a camera stream on the instance event loop, so that any number of
+// HTTP cameras can share one thread.  The response and each multipart part
+// are parsed in place as data arrives; part bodies with a Content-Length are
+// read from the socket directly into the image that is published.
+//
+// Other than construction, everything is called on the event loop thread.
+class HttpCameraImpl::LoopStream
+    : public std::enable_shared_from_this<LoopStream> {
+ public:
+  explicit LoopStream(HttpCameraImpl& camera)
+      : m_camera{camera}, m_logger{camera.m_logger} {}
+
+  // Connects or disconnects as needed after the camera is enabled or
+  // disabled, or its URLs or stream settings change
+  void Update(wpi::uv::Loop& loop);
+
+  // Closes the connection; nothing further happens after this
+  void Stop();
+
+ private:
+  enum State {
+    kIdle,
+    kResponse,     // waiting for the HTTP response headers
+    kBoundary,     // looking for the next part boundary
+    kPartHeaders,  // reading part headers
+    kPartBody,     // reading a part of known length
+    kPartScan      // reading a part of unknown length (up to the boundary)
+  };
+
+  void Connect();
+  void Disconnect();
+  void Retry(std::chrono::milliseconds delay = std::chrono::milliseconds{250});
+  void SendRequest();
+
+  wpi::uv::Buffer AllocBuffer(size_t size);
+  void HandleData(wpi::StringRef data);
+  bool HandleResponse();
+  void HandleBody(wpi::StringRef data);
+  void HandlePartHeader(wpi::StringRef line);
+  void StartPart();
+  void FinishPart(std::unique_ptr<Image> image);
+  void PartError(const wpi::Twine& msg);
+
+  wpi::StringRef GetName() { return m_camera.GetName(); }
+
+  HttpCameraImpl& m_camera;
+  wpi::Logger& m_logger;
+  bool m_stopped = false;
+
+  std::shared_ptr<wpi::uv::Timer> m_retryTimer;
+  std::shared_ptr<wpi::uv::Timer> m_monitorTimer;
+  int m_frameCount = 0;  // frames since the last monitor check
+
+  // The connection
+  std::shared_ptr<wpi::uv::Tcp> m_tcp;
+  wpi::HttpRequest m_request;
+  State m_state = kIdle;
+  wpi::HttpParser m_parser{wpi::HttpParser::kResponse};
+  wpi::SmallString<64> m_contentType;
+  bool m_chunked = false;
+  wpi::HttpMultipartScanner m_scanner{""};
+  int m_numErrors = 0;  // consecutive bad parts
+
+  // Receive buffer for everything but part bodies of known length
+  std::vector<char> m_readBuf;
+
+  // Current part
+  wpi::SmallString<128> m_line;
+  wpi::SmallString<64> m_partContentType;
+  wpi::SmallString<16> m_partContentLength;
+  std::unique_ptr<Image> m_image;
+  size_t m_filled = 0;
+};
+
 HttpCameraImpl::HttpCameraImpl(const wpi::Twine& name, CS_HttpCameraKind kind,
                                wpi::Logger& logger, Notifier& notifier,
                                Telemetry& telemetry)
@@ -26,6 +106,13 @@ HttpCameraImpl::HttpCameraImpl(const wpi::Twine& name, CS_HttpCameraKind kind,
 HttpCameraImpl::~HttpCameraImpl() {
   m_active = false;
 
+  // stop the shared stream; nothing on the event loop references this
+  // camera after this
+  if (m_loopStream) {
+    Instance::GetInstance().eventLoop.ExecSync(
+        [&](wpi::uv::Loop&) { m_loopStream->Stop(); });
+  }
+
   // force wakeup of monitor thread
   m_monitorCond.notify_one();
 
@@ -97,6 +184,14 @@ void HttpCameraImpl::MonitorThreadMain() {
 
 void HttpCameraImpl::StreamThreadMain() {
   while (m_active) {
+    // the event loop receives the stream instead while shared
+    if (m_sharedStreaming) {
+      std::unique_lock lock(m_mutex);
+      m_sinkEnabledCond.wait(lock,
+                             [=] { return !m_active || !m_sharedStreaming; });
+      continue;
+    }
+
     SetConnected(false);
 
     // sleep between retries
@@ -109,10 +204,15 @@ void HttpCameraImpl::StreamThreadMain() {
         m_streamConn->stream->close();
       }
       // Wait for enable
-      m_sinkEnabledCond.wait(lock, [=] { return !m_active || IsEnabled(); });
+      m_sinkEnabledCond.wait(lock, [=] {
+        return !m_active || IsEnabled() || m_sharedStreaming;
+      });
       if (!m_active) {
         return;
       }
+      if (m_sharedStreaming) {
+        continue;
+      }
     }
 
     // connect
@@ -238,7 +338,7 @@ void HttpCameraImpl::DeviceStream(wpi::raw_istream& is,
 
   // streaming loop
   while (m_active && !is.has_error() && IsEnabled() && numErrors < 3 &&
-         !m_streamSettingsUpdated) {
+         !m_streamSettingsUpdated && !m_sharedStreaming) {
     if (!FindMultipartBoundary(is, boundary, nullptr)) {
       break;
     }
@@ -326,6 +426,437 @@ bool HttpCameraImpl::DeviceStreamFrame(wpi::raw_istream& is,
   return true;
 }
 
+// Largest part of unknown length accepted
+static constexpr size_t kMaxScanSize = 16 * 1024 * 1024;
+
+// Size of the receive buffer used outside of part bodies of known length
+static constexpr size_t kReadBufferSize = 64 * 1024;
+
+// Idle time before TCP keep-alive probes are sent, in seconds
+static constexpr unsigned int kKeepAliveDelay = 5;
+
+void HttpCameraImpl::LoopStream::Update(wpi::uv::Loop& loop) {
+  if (m_stopped) {
+    return;
+  }
+
+  if (!m_retryTimer) {
+    m_retryTimer = wpi::uv::Timer::Create(loop);
+    m_monitorTimer = wpi::uv::Timer::Create(loop);
+    if (!m_retryTimer || !m_monitorTimer) {
+      SERROR("could not create event loop timers");
+      m_retryTimer.reset();
+      return;
+    }
+    m_readBuf.resize(kReadBufferSize);
+
+    m_parser.header.connect([this](wpi::StringRef name, wpi::StringRef value) {
+      if (name.equals_lower("content-type")) {
+        m_contentType = value;
+      } else if (name.equals_lower("transfer-encoding") &&
+                 value.contains_lower("chunked")) {
+        m_chunked = true;
+      }
+    });
+    m_parser.headersComplete.connect([this](bool) {
+      if (!HandleResponse()) {
+        m_parser.Abort();
+      }
+    });
+    m_parser.body.connect([this](wpi::StringRef data, bool) {
+      HandleBody(data);
+      if (!m_tcp) {
+        m_parser.Abort();
+      }
+    });
+    m_parser.messageComplete.connect([this](bool) {
+      SDEBUG("stream ended");
+      Retry();
+      m_parser.Abort();
+    });
+
+    m_retryTimer->timeout.connect([this] {
+      if (!m_tcp && m_camera.m_sharedStreaming && m_camera.IsEnabled()) {
+        Connect();
+      }
+    });
+
+    // Like the monitor thread, disconnect (and reconnect) if no frames have
+    // been received in the last second
+    m_monitorTimer->timeout.connect([this] {
+      if (m_tcp && m_frameCount == 0) {
+        SWARNING("Monitor detected stream hung, disconnecting");
+        Retry();
+      }
+      m_frameCount = 0;
+    });
+    m_monitorTimer->Start(wpi::uv::Timer::Time{1000},
+                          wpi::uv::Timer::Time{1000});
+  }
+
+  if (!m_camera.m_sharedStreaming || !m_camera.IsEnabled()) {
+    m_retryTimer->Stop();
+    Disconnect();
+  } else if (!m_tcp || m_camera.m_streamSettingsUpdated) {
+    Disconnect();
+    Connect();
+  }
+}
+
+void HttpCameraImpl::LoopStream::Stop() {
+  m_stopped = true;
+  Disconnect();
+  if (m_retryTimer) {
+    m_retryTimer->Close();
+    m_monitorTimer->Close();
+  }
+}
+
+void HttpCameraImpl::LoopStream::Connect() {
+  bool haveLocation = false;
+  {
+    std::scoped_lock lock(m_camera.m_mutex);
+    if (!m_camera.m_locations.empty()) {
+      if (m_camera.m_nextLocation >= m_camera.m_locations.size()) {
+        m_camera.m_nextLocation = 0;
+      }
+      m_request = wpi::HttpRequest{
+          m_camera.m_locations[m_camera.m_nextLocation++],
+          m_camera.m_streamSettings};
+      m_camera.m_streamSettingsUpdated = false;
+      haveLocation = true;
+    }
+  }
+  if (!haveLocation) {
+    SERROR("locations array is empty!?");
+    Retry(std::chrono::seconds{1});
+    return;
+  }
+
+  auto& loop = m_retryTimer->GetLoopRef();
+  m_tcp = wpi::uv::Tcp::Create(loop);
+  if (!m_tcp) {
+    Retry();
+    return;
+  }
+  m_frameCount = 1;  // give the connection a full monitor period
+  m_state = kIdle;
+
+  // Part bodies are received in place, so buffers are never freed here
+  m_tcp->SetBufferAllocator([this](size_t size) { return AllocBuffer(size); },
+                            [](wpi::uv::Buffer&) {});
+
+  // Events for an old connection may still be delivered after it has been
+  // closed (or this object has been stopped), so check before handling them.
+  std::weak_ptr<LoopStream> weak = weak_from_this();
+  std::weak_ptr<wpi::uv::Tcp> tcpWeak = m_tcp;
+  auto current = [weak, tcpWeak]() -> std::shared_ptr<LoopStream> {
+    auto self = weak.lock();
+    auto tcp = tcpWeak.lock();
+    if (!self || !tcp || tcp != self->m_tcp) {
+      return nullptr;
+    }
+    return self;
+  };
+
+  m_tcp->data.connect([this, current](wpi::uv::Buffer& buf, size_t size) {
+    if (current()) {
+      HandleData(wpi::StringRef{buf.base, size});
+    }
+  });
+  m_tcp->end.connect([this, current] {
+    if (current()) {
+      SDEBUG("stream disconnected");
+      Retry();
+    }
+  });
+  m_tcp->error.connect([current](wpi::uv::Error err) {
+    if (auto self = current()) {
+      WPI_DEBUG(self->m_logger,
+                self->GetName() << ": stream error: " << err.str());
+      self->Retry();
+    }
+  });
+
+  wpi::SmallString<16> portBuf;
+  wpi::raw_svector_ostream port{portBuf};
+  port << m_request.port;
+  wpi::uv::GetAddrInfo(
+      loop,
+      [current](const addrinfo& addr) {
+        auto self = current();
+        if (!self) {
+          return;
+        }
+        auto req = std::make_shared<wpi::uv::TcpConnectReq>();
+        req->connected.connect([current] {
+          if (auto self = current()) {
+            self->SendRequest();
+          }
+        });
+        req->error = [current](wpi::uv::Error err) {
+          if (auto self = current()) {
+            WPI_DEBUG(self->m_logger,
+                      self->GetName() << ": connect failed: " << err.str());
+            self->Retry();
+          }
+        };
+        self->m_tcp->Connect(*addr.ai_addr, req);
+      },
+      m_request.host, port.str());
+}
+
+void HttpCameraImpl::LoopStream::Disconnect() {
+  if (m_tcp) {
+    m_tcp->Close();
+    m_tcp.reset();
+  }
+  m_state = kIdle;
+  m_image.reset();
+  m_camera.SetConnected(false);
+}
+
+void HttpCameraImpl::LoopStream::Retry(std::chrono::milliseconds delay) {
+  Disconnect();
+  if (!m_stopped) {
+    m_retryTimer->Start(wpi::uv::Timer::Time{delay.count()});
+  }
+}
+
+void HttpCameraImpl::LoopStream::SendRequest() {
+  m_tcp->SetKeepAlive(true, wpi::uv::Tcp::Time{kKeepAliveDelay});
+
+  m_state = kResponse;
+  m_parser.Reset(wpi::HttpParser::kResponse);
+  m_contentType.clear();
+  m_chunked = false;
+  m_numErrors = 0;
+
+  // Same request as wpi::HttpConnection::Handshake()
+  wpi::SmallString<256> reqBuf;
+  wpi::raw_svector_ostream os{reqBuf};
+  os << "GET /" << m_request.path << " HTTP/1.1\r\n";
+  os << "Host: " << m_request.host << "\r\n";
+  if (!m_request.auth.empty()) {
+    os << "Authorization: Basic " << m_request.auth << "\r\n";
+  }
+  os << "\r\n";
+  m_tcp->Write({wpi::uv::Buffer::Dup(os.str())},
+               [](auto bufs, wpi::uv::Error) {
+                 for (auto buf : bufs) {
+                   buf.Deallocate();
+                 }
+               });
+  m_tcp->StartRead();
+}
+
+wpi::uv::Buffer HttpCameraImpl::LoopStream::AllocBuffer(size_t size) {
+  // Read the rest of a part body straight into its image.  A chunked
+  // response has chunk framing mixed into the body, so that's read into
+  // the receive buffer and copied.
+  if (m_state == kPartBody && !m_chunked) {
+    return wpi::uv::Buffer{m_image->data() + m_filled,
+                           m_image->size() - m_filled};
+  }
+  return wpi::uv::Buffer{m_readBuf.data(), m_readBuf.size()};
+}
+
+void HttpCameraImpl::LoopStream::HandleData(wpi::StringRef data) {
+  m_parser.Execute(data);
+  if (m_tcp && m_parser.HasError()) {
+    SWARNING("error parsing HTTP response: "
+             << http_errno_name(m_parser.GetError()));
+    Retry();
+  }
+}
+
+bool HttpCameraImpl::LoopStream::HandleResponse() {
+  if (m_parser.GetStatusCode() != 200) {
+    SWARNING("received " << m_parser.GetStatusCode() << " response");
+    Retry();
+    return false;
+  }
+
+  // Parse Content-Type header to get the boundary
+  wpi::StringRef mediaType, contentType;
+  std::tie(mediaType, contentType) = m_contentType.str().split(';');
+  mediaType = mediaType.trim();
+  if (mediaType != "multipart/x-mixed-replace") {
+    SWARNING("\"" << m_request.host << "\": unrecognized Content-Type \""
+                  << mediaType << "\"");
+    Retry();
+    return false;
+  }
+  wpi::SmallString<64> boundary;
+  while (!contentType.empty()) {
+    wpi::StringRef keyvalue;
+    std::tie(keyvalue, contentType) = contentType.split(';');
+    contentType = contentType.ltrim();
+    wpi::StringRef key, value;
+    std::tie(key, value) = keyvalue.split('=');
+    if (key.trim() == "boundary") {
+      value = value.trim().trim('"');  // value may be quoted
+      if (value.startswith("--")) {
+        value = value.substr(2);
+      }
+      boundary.append(value.begin(), value.end());
+    }
+  }
+  if (boundary.empty()) {
+    SWARNING("\"" << m_request.host
+                  << "\": empty multi-part boundary or no Content-Type");
+    Retry();
+    return false;
+  }
+
+  // The first boundary may not be preceded by a newline
+  m_scanner.SetBoundary(boundary);
+  m_scanner.Reset();
+  m_scanner.Execute("\n");
+  m_state = kBoundary;
+  m_camera.SetConnected(true);
+  return true;
+}
+
+void HttpCameraImpl::LoopStream::HandleBody(wpi::StringRef data) {
+  while (!data.empty() && m_tcp) {
+    switch (m_state) {
+      case kBoundary:
+        data = m_scanner.Execute(data);
+        if (m_scanner.IsDone()) {
+          m_state = kPartHeaders;
+          m_line.clear();
+          m_partContentType.clear();
+          m_partContentLength.clear();
+        }
+        break;
+      case kPartHeaders: {
+        size_t eol = data.find('\n');
+        m_line += data.substr(0, eol);
+        if (eol == wpi::StringRef::npos) {
+          data = wpi::StringRef{};
+          if (m_line.size() > 4096) {
+            SWARNING("part header too long");
+            Retry();
+          }
+          break;
+        }
+        data = data.drop_front(eol + 1);
+        wpi::StringRef line = m_line.str().rtrim();
+        if (line.empty()) {
+          StartPart();
+        } else {
+          HandlePartHeader(line);
+        }
+        m_line.clear();
+        break;
+      }
+      case kPartBody: {
+        size_t count = (std::min)(data.size(), m_image->size() - m_filled);
+        char* dest = m_image->data() + m_filled;
+        // no copy is needed if the data was received in place
+        if (data.data() != dest) {
+          std::memcpy(dest, data.data(), count);
+        }
+        m_filled += count;
+        data = data.drop_front(count);
+        if (m_filled == m_image->size()) {
+          m_state = kBoundary;
+          FinishPart(std::move(m_image));
+        }
+        break;
+      }
+      case kPartScan: {
+        data = m_scanner.Execute(data);
+        wpi::StringRef skipped = m_scanner.GetSkipped();
+        if (!m_scanner.IsDone()) {
+          if (skipped.size() > kMaxScanSize) {
+            SWARNING("did not receive a JPEG image");
+            Retry();
+          }
+          break;
+        }
+        // The boundary follows the image; trim it off after the EOI marker
+        m_state = kPartHeaders;
+        m_line.clear();
+        m_partContentType.clear();
+        m_partContentLength.clear();
+        size_t end = skipped.rfind("\xff\xd9");
+        if (end == wpi::StringRef::npos) {
+          PartError("did not receive a JPEG image");
+          break;
+        }
+        auto image =
+            m_camera.AllocImage(VideoMode::PixelFormat::kMJPEG, 0, 0, end + 2);
+        std::memcpy(image->data(), skipped.data(), end + 2);
+        FinishPart(std::move(image));
+        break;
+      }
+      default:
+        return;
+    }
+  }
+}
+
+void HttpCameraImpl::LoopStream::HandlePartHeader(wpi::StringRef line) {
+  wpi::StringRef name, value;
+  std::tie(name, value) = line.split(':');
+  name = name.trim();
+  value = value.trim();
+  if (name.equals_lower("content-type")) {
+    m_partContentType = value;
+  } else if (name.equals_lower("content-length")) {
+    m_partContentLength = value;
+  }
+}
+
+void HttpCameraImpl::LoopStream::StartPart() {
+  // Check the content type (if present)
+  if (!m_partContentType.empty() &&
+      !m_partContentType.str().startswith("image/jpeg")) {
+    m_state = kBoundary;
+    PartError("received unknown Content-Type \"" + m_partContentType + "\"");
+    return;
+  }
+
+  unsigned int contentLength = 0;
+  if (m_partContentLength.str().getAsInteger(10, contentLength) ||
+      contentLength == 0) {
+    // No Content-Length; the part ends at the next boundary
+    m_scanner.Reset(true);
+    m_state = kPartScan;
+    return;
+  }
+
+  m_image = m_camera.AllocImage(VideoMode::PixelFormat::kMJPEG, 0, 0,
+                                contentLength);
+  m_filled = 0;
+  m_state = kPartBody;
+}
+
+void HttpCameraImpl::LoopStream::FinishPart(std::unique_ptr<Image> image) {
+  int width, height;
+  if (!GetJpegSize(image->str(), &width, &height)) {
+    PartError("did not receive a JPEG image");
+    return;
+  }
+  image->width = width;
+  image->height = height;
+  m_camera.PutFrame(std::move(image), wpi::Now());
+  ++m_camera.m_frameCount;
+  ++m_frameCount;
+  m_numErrors = 0;
+}
+
+void HttpCameraImpl::LoopStream::PartError(const wpi::Twine& msg) {
+  SWARNING(msg);
+  m_camera.PutError(msg, wpi::Now());
+  // if we receive 3 bad images in a row, reconnect
+  if (++m_numErrors >= 3) {
+    Retry();
+  }
+}
+
 void HttpCameraImpl::SettingsThreadMain() {
   for (;;) {
     wpi::HttpRequest req;
@@ -394,13 +925,54 @@ bool HttpCameraImpl::SetUrls(wpi::ArrayRef<std::string> urls,
     }
   }
 
-  std::scoped_lock lock(m_mutex);
-  m_locations.swap(locations);
-  m_nextLocation = 0;
-  m_streamSettingsUpdated = true;
+  {
+    std::scoped_lock lock(m_mutex);
+    m_locations.swap(locations);
+    m_nextLocation = 0;
+    m_streamSettingsUpdated = true;
+  }
+  UpdateLoopStream();
   return true;
 }
 
+void HttpCameraImpl::SetSharedStreaming(bool enabled) {
+  {
+    std::scoped_lock lock(m_mutex);
+    if (m_sharedStreaming == enabled) {
+      return;
+    }
+    m_sharedStreaming = enabled;
+    if (enabled) {
+      if (!m_loopStream) {
+        m_loopStream = std::make_shared<LoopStream>(*this);
+      }
+      // kick the stream thread out of any blocking read
+      if (m_streamConn) {
+        m_streamConn->stream->close();
+      }
+    }
+  }
+  m_sinkEnabledCond.notify_one();
+  UpdateLoopStream();
+}
+
+void HttpCameraImpl::UpdateLoopStream() {
+  std::weak_ptr<LoopStream> loopStream;
+  {
+    std::scoped_lock lock(m_mutex);
+    loopStream = m_loopStream;
+  }
+  if (loopStream.expired()) {
+    return;
+  }
+  Instance::GetInstance().eventLoop.ExecAsync(
+      [loopStream](wpi::uv::Loop& loop) {
+        if (auto stream = loopStream.lock()) {
+          stream->Update(loop);
+        }
+      });
+}
+
 std::vector<std::string> HttpCameraImpl::GetUrls() const {
   std::scoped_lock lock(m_mutex);
   std::vector<std::string> urls;
@@ -516,9 +1088,12 @@ bool HttpCameraImpl::SetVideoMode(const VideoMode& mode, CS_Status* status) {
   if (mode.pixelFormat != VideoMode::kMJPEG) {
     return false;
   }
-  std::scoped_lock lock(m_mutex);
-  m_mode = mode;
-  m_streamSettingsUpdated = true;
+  {
+    std::scoped_lock lock(m_mutex);
+    m_mode = mode;
+    m_streamSettingsUpdated = true;
+  }
+  UpdateLoopStream();
   return true;
 }
 
@@ -528,6 +1103,7 @@ void HttpCameraImpl::NumSinksChanged() {
 
 void HttpCameraImpl::NumSinksEnabledChanged() {
   m_sinkEnabledCond.notify_one();
+  UpdateLoopStream();
 }
 
 bool AxisCameraImpl::CacheProperties(CS_Status* status) const {
@@ -629,6 +1205,16 @@ std::vector<std::string> GetHttpCameraUrls(CS_Source source,
   return static_cast<HttpCameraImpl&>(*data->source).GetUrls();
 }
 
+void SetHttpCameraSharedStreaming(CS_Source source, bool enabled,
+                                  CS_Status* status) {
+  auto data = Instance::GetInstance().GetSource(source);
+  if (!data || data->kind != CS_SOURCE_HTTP) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  static_cast<HttpCameraImpl&>(*data->source).SetSharedStreaming(enabled);
+}
+
 }  // namespace cs
 
 extern "C" {
@@ -674,6 +1260,11 @@ char** CS_GetHttpCameraUrls(CS_Source source, int* count, CS_Status* status) {
   return out;
 }
 
+void CS_SetHttpCameraSharedStreaming(CS_Source source, CS_Bool enabled,
+                                     CS_Status* status) {
+  return cs::SetHttpCameraSharedStreaming(source, enabled, status);
+}
+
 void CS_FreeHttpCameraUrls(char** urls, int count) {
   if (!urls) {
     return;
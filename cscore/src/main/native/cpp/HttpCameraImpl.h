@@ -57,6 +57,10 @@ class HttpCameraImpl : public SourceImpl {
   bool SetUrls(wpi::ArrayRef<std::string> urls, CS_Status* status);
   std::vector<std::string> GetUrls() const;
 
+  // Receive the stream on the instance event loop, shared with other HTTP
+  // cameras, rather than on a thread of this camera's own.
+  void SetSharedStreaming(bool enabled);
+
   // Property data
   class PropertyData : public PropertyImpl {
    public:
@@ -95,6 +99,8 @@ class HttpCameraImpl : public SourceImpl {
                           std::initializer_list<T> choices) const;
 
  private:
+  class LoopStream;
+
   // The camera streaming thread
   void StreamThreadMain();
 
@@ -111,6 +117,9 @@ class HttpCameraImpl : public SourceImpl {
   // The monitor thread
   void MonitorThreadMain();
 
+  // Has the event loop connect or disconnect the shared stream as needed
+  void UpdateLoopStream();
+
   std::atomic_bool m_connected{false};
   std::atomic_bool m_active{true};  // set to false to terminate thread
   std::thread m_streamThread;
@@ -141,6 +150,10 @@ class HttpCameraImpl : public SourceImpl {
   wpi::StringMap<wpi::SmallString<16>> m_streamSettings;
   std::atomic_bool m_streamSettingsUpdated{false};
 
+  // Shared streaming; m_loopStream is only used on the event loop thread
+  std::atomic_bool m_sharedStreaming{false};
+  std::shared_ptr<LoopStream> m_loopStream;
+
   wpi::condition_variable m_monitorCond;
 };
 
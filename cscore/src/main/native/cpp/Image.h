@@ -5,6 +5,8 @@
 #ifndef CSCORE_IMAGE_H_
 #define CSCORE_IMAGE_H_
 
+#include <functional>
+#include <utility>
 #include <vector>
 
 #include <opencv2/core/core.hpp>
@@ -30,18 +32,38 @@ class Image {
   }
 #endif
 
+  // Creates an image that references externally owned data (e.g. a camera
+  // driver buffer) instead of owning a copy of it.  The release function is
+  // called when the image is destroyed.  External images must be treated as
+  // read-only and are never returned to the image pool.
+  Image(const char* data, size_t size, std::function<void()> release)
+      : m_extData{reinterpret_cast<uchar*>(const_cast<char*>(data))},
+        m_extSize{size},
+        m_release{std::move(release)} {}
+
+  ~Image() {
+    if (m_release) {
+      m_release();
+    }
+  }
+
   Image(const Image&) = delete;
   Image& operator=(const Image&) = delete;
 
+  bool IsExternal() const { return m_extData != nullptr; }
+
   // Getters
   operator wpi::StringRef() const { return str(); }  // NOLINT
   wpi::StringRef str() const { return wpi::StringRef(data(), size()); }
   size_t capacity() const { return m_data.capacity(); }
   const char* data() const {
-    return reinterpret_cast<const char*>(m_data.data());
+    return reinterpret_cast<const char*>(m_extData ? m_extData
+                                                   : m_data.data());
   }
-  char* data() { return reinterpret_cast<char*>(m_data.data()); }
-  size_t size() const { return m_data.size(); }
+  char* data() {
+    return reinterpret_cast<char*>(m_extData ? m_extData : m_data.data());
+  }
+  size_t size() const { return m_extData ? m_extSize : m_data.size(); }
 
   const std::vector<uchar>& vec() const { return m_data; }
   std::vector<uchar>& vec() { return m_data; }
@@ -65,10 +87,15 @@ class Image {
         type = CV_8UC1;
         break;
     }
-    return cv::Mat{height, width, type, m_data.data()};
+    return cv::Mat{height, width, type, data()};
   }
 
-  cv::_InputArray AsInputArray() { return cv::_InputArray{m_data}; }
+  cv::_InputArray AsInputArray() {
+    if (m_extData) {
+      return cv::_InputArray{m_extData, static_cast<int>(m_extSize)};
+    }
+    return cv::_InputArray{m_data};
+  }
 
   bool Is(int width_, int height_) {
     return width == width_ && height == height_;
@@ -95,6 +122,9 @@ class Image {
 
  private:
   std::vector<uchar> m_data;
+  uchar* m_extData{nullptr};
+  size_t m_extSize{0};
+  std::function<void()> m_release;
 
  public:
   VideoMode::PixelFormat pixelFormat{VideoMode::kUnknown};
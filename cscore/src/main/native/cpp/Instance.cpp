@@ -52,6 +52,7 @@ Instance& Instance::GetInstance() {
 
 void Instance::Shutdown() {
   eventLoop.Stop();
+  conversionPool.Stop();
   m_sinks.FreeAll();
   m_sources.FreeAll();
   networkListener.Stop();
@@ -79,6 +80,7 @@ std::pair<CS_Sink, std::shared_ptr<SinkData>> Instance::FindSink(
 CS_Source Instance::CreateSource(CS_SourceKind kind,
                                  std::shared_ptr<SourceImpl> source) {
   auto handle = m_sources.Allocate(kind, source);
+  telemetry.Register(handle, source->GetTelemetryCounters());
   notifier.NotifySource(source->GetName(), handle, CS_SOURCE_CREATED);
   source->Start();
   return handle;
@@ -86,6 +88,7 @@ CS_Source Instance::CreateSource(CS_SourceKind kind,
 
 CS_Sink Instance::CreateSink(CS_SinkKind kind, std::shared_ptr<SinkImpl> sink) {
   auto handle = m_sinks.Allocate(kind, sink);
+  telemetry.Register(handle, sink->GetTelemetryCounters());
   notifier.NotifySink(sink->GetName(), handle, CS_SINK_CREATED);
   return handle;
 }
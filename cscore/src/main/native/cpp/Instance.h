@@ -11,6 +11,7 @@
 #include <wpi/EventLoopRunner.h>
 #include <wpi/Logger.h>
 
+#include "ConversionPool.h"
 #include "Log.h"
 #include "NetworkListener.h"
 #include "Notifier.h"
@@ -56,6 +57,7 @@ class Instance {
   Telemetry telemetry;
   NetworkListener networkListener;
   UsbCameraListener usbCameraListener;
+  ConversionPool conversionPool;
 
  private:
   UnlimitedHandleResource<Handle, SourceData, Handle::kSource> m_sources;
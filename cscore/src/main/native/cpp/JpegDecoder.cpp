@@ -0,0 +1,163 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "JpegDecoder.h"
+
+#include "Image.h"
+
+#ifdef CSCORE_USE_LIBJPEG_TURBO
+
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+
+#include <jpeglib.h>
+
+using namespace cs;
+
+namespace {
+
+// Error manager that returns control to the decoder instead of exiting
+struct ErrorManager {
+  struct jpeg_error_mgr pub;
+  std::jmp_buf jmp;
+};
+
+}  // namespace
+
+static void ErrorExit(j_common_ptr cinfo) {
+  std::longjmp(reinterpret_cast<ErrorManager*>(cinfo->err)->jmp, 1);
+}
+
+static void OutputMessage(j_common_ptr) {}
+
+struct JpegDecoder::Decompressor {
+  Decompressor();
+  ~Decompressor() { jpeg_destroy_decompress(&cinfo); }
+
+  bool DecodeRegion(const Image& image, int scale, int x, int y, Image* out);
+
+  struct jpeg_decompress_struct cinfo;
+  ErrorManager err;
+
+  // Reused row buffer (the decoded row is widened to MCU boundaries)
+  std::vector<JSAMPLE> row;
+};
+
+JpegDecoder::Decompressor::Decompressor() {
+  cinfo.err = jpeg_std_error(&err.pub);
+  err.pub.error_exit = ErrorExit;
+  err.pub.output_message = OutputMessage;
+  jpeg_create_decompress(&cinfo);
+}
+
+bool JpegDecoder::Decompressor::DecodeRegion(const Image& image, int scale,
+                                             int x, int y, Image* out) {
+  if (setjmp(err.jmp)) {
+    jpeg_abort_decompress(&cinfo);
+    return false;
+  }
+
+  // libjpeg doesn't modify the input, it's just not const-correct
+  auto data = reinterpret_cast<unsigned char*>(const_cast<char*>(image.data()));
+  jpeg_mem_src(&cinfo, data, image.size());
+  jpeg_read_header(&cinfo, TRUE);
+  cinfo.out_color_space =
+      out->pixelFormat == VideoMode::kGray ? JCS_GRAYSCALE : JCS_EXT_BGR;
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = scale;
+  jpeg_start_decompress(&cinfo);
+
+  int width = out->width;
+  int height = out->height;
+  if (x < 0 || y < 0 || width <= 0 || height <= 0 ||
+      static_cast<JDIMENSION>(x + width) > cinfo.output_width ||
+      static_cast<JDIMENSION>(y + height) > cinfo.output_height) {
+    jpeg_abort_decompress(&cinfo);
+    return false;
+  }
+
+  // Only decode the MCU columns covering the region; this moves xoffset and
+  // widens cropWidth to MCU boundaries
+  JDIMENSION xoffset = x;
+  JDIMENSION cropWidth = width;
+  jpeg_crop_scanline(&cinfo, &xoffset, &cropWidth);
+  if (y > 0) {
+    jpeg_skip_scanlines(&cinfo, y);
+  }
+
+  int components = cinfo.output_components;
+  row.resize(cropWidth * components);
+  JSAMPROW rowPtr = row.data();
+  const JSAMPLE* rowStart = row.data() + (x - xoffset) * components;
+  size_t rowSize = width * components;
+  char* dst = out->data();
+  for (int i = 0; i < height; ++i, dst += rowSize) {
+    jpeg_read_scanlines(&cinfo, &rowPtr, 1);
+    std::memcpy(dst, rowStart, rowSize);
+  }
+
+  // The rest of the image isn't needed
+  jpeg_abort_decompress(&cinfo);
+  return true;
+}
+
+JpegDecoder::JpegDecoder() = default;
+
+JpegDecoder::~JpegDecoder() = default;
+
+bool JpegDecoder::IsSupported() {
+  return true;
+}
+
+std::unique_ptr<JpegDecoder::Decompressor> JpegDecoder::GetDecompressor() {
+  {
+    std::scoped_lock lock(m_mutex);
+    if (!m_decompressors.empty()) {
+      auto decompressor = std::move(m_decompressors.back());
+      m_decompressors.pop_back();
+      return decompressor;
+    }
+  }
+  return std::make_unique<Decompressor>();
+}
+
+bool JpegDecoder::DecodeRegion(const Image& image, int scale, int x, int y,
+                               Image* out) {
+  if (!IsSupported() || image.pixelFormat != VideoMode::kMJPEG ||
+      (out->pixelFormat != VideoMode::kBGR &&
+       out->pixelFormat != VideoMode::kGray)) {
+    return false;
+  }
+  auto decompressor = GetDecompressor();
+  bool rv = decompressor->DecodeRegion(image, scale, x, y, out);
+  std::scoped_lock lock(m_mutex);
+  m_decompressors.emplace_back(std::move(decompressor));
+  return rv;
+}
+
+#else  // CSCORE_USE_LIBJPEG_TURBO
+
+using namespace cs;
+
+struct JpegDecoder::Decompressor {};
+
+JpegDecoder::JpegDecoder() = default;
+
+JpegDecoder::~JpegDecoder() = default;
+
+bool JpegDecoder::IsSupported() {
+  return false;
+}
+
+std::unique_ptr<JpegDecoder::Decompressor> JpegDecoder::GetDecompressor() {
+  return nullptr;
+}
+
+bool JpegDecoder::DecodeRegion(const Image& image, int scale, int x, int y,
+                               Image* out) {
+  return false;
+}
+
+#endif  // CSCORE_USE_LIBJPEG_TURBO
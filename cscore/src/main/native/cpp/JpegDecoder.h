@@ -0,0 +1,56 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_JPEGDECODER_H_
+#define CSCORE_JPEGDECODER_H_
+
+#include <memory>
+#include <vector>
+
+#include <wpi/mutex.h>
+
+namespace cs {
+
+class Image;
+
+// Direct JPEG decoder using the libjpeg-turbo API.  Unlike cv::imdecode, this
+// can decode just a rectangular region of the image: rows above the region
+// are skipped without being fully decoded, decoding stops after the last row
+// of the region, and only the MCU columns covering the region are decoded.
+//
+// Decompressors are kept and reused between calls; concurrent calls each get
+// their own decompressor.
+//
+// Requires libjpeg-turbo 1.5 or later (for jpeg_crop_scanline() and
+// jpeg_skip_scanlines()).  Only available when built with
+// CSCORE_USE_LIBJPEG_TURBO; otherwise IsSupported() always returns false and
+// callers should fall back to OpenCV.
+class JpegDecoder {
+ public:
+  JpegDecoder();
+  ~JpegDecoder();
+
+  JpegDecoder(const JpegDecoder&) = delete;
+  JpegDecoder& operator=(const JpegDecoder&) = delete;
+
+  static bool IsSupported();
+
+  // Decodes the region of a JPEG image at (x, y) and the size of out (which
+  // must be a BGR or grayscale image) into out.  The image is scaled down by
+  // scale (1, 2, 4, or 8) during decoding; the region is in scaled
+  // coordinates.  Returns false if decoding failed.
+  bool DecodeRegion(const Image& image, int scale, int x, int y, Image* out);
+
+ private:
+  struct Decompressor;
+
+  std::unique_ptr<Decompressor> GetDecompressor();
+
+  wpi::mutex m_mutex;
+  std::vector<std::unique_ptr<Decompressor>> m_decompressors;
+};
+
+}  // namespace cs
+
+#endif  // CSCORE_JPEGDECODER_H_
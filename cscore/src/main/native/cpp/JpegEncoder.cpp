@@ -0,0 +1,271 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "JpegEncoder.h"
+
+#include "Image.h"
+
+#ifdef CSCORE_USE_LIBJPEG_TURBO
+
+#include <csetjmp>
+#include <cstdio>
+
+#include <jpeglib.h>
+
+#include <algorithm>
+
+using namespace cs;
+
+namespace {
+
+// Error manager that returns control to the encoder instead of exiting
+struct ErrorManager {
+  struct jpeg_error_mgr pub;
+  std::jmp_buf jmp;
+};
+
+// Destination manager that writes directly into an Image, growing it as
+// needed
+struct Destination {
+  struct jpeg_destination_mgr pub;
+  Image* image;
+};
+
+}  // namespace
+
+static void ErrorExit(j_common_ptr cinfo) {
+  std::longjmp(reinterpret_cast<ErrorManager*>(cinfo->err)->jmp, 1);
+}
+
+static void OutputMessage(j_common_ptr) {}
+
+static void InitDestination(j_compress_ptr cinfo) {
+  auto dest = reinterpret_cast<Destination*>(cinfo->dest);
+  auto& vec = dest->image->vec();
+  vec.resize((std::max)(vec.capacity(), static_cast<size_t>(4096)));
+  dest->pub.next_output_byte = vec.data();
+  dest->pub.free_in_buffer = vec.size();
+}
+
+static boolean EmptyOutputBuffer(j_compress_ptr cinfo) {
+  auto dest = reinterpret_cast<Destination*>(cinfo->dest);
+  auto& vec = dest->image->vec();
+  size_t oldSize = vec.size();
+  vec.resize(oldSize * 2);
+  dest->pub.next_output_byte = vec.data() + oldSize;
+  dest->pub.free_in_buffer = vec.size() - oldSize;
+  return TRUE;
+}
+
+static void TermDestination(j_compress_ptr cinfo) {
+  auto dest = reinterpret_cast<Destination*>(cinfo->dest);
+  auto& vec = dest->image->vec();
+  vec.resize(vec.size() - dest->pub.free_in_buffer);
+}
+
+struct JpegEncoder::Compressor {
+  Compressor();
+  ~Compressor() { jpeg_destroy_compress(&cinfo); }
+
+  bool Encode(const Image& image, Image* out, int quality);
+  void WriteYUYV(const Image& image);
+  void WriteScanlines(const Image& image, int stride);
+
+  struct jpeg_compress_struct cinfo;
+  ErrorManager err;
+  Destination dest;
+
+  // Reused row buffers for raw (planar) YCbCr data
+  std::vector<JSAMPLE> planes[3];
+  JSAMPROW rows[3][DCTSIZE];
+  std::vector<JSAMPROW> scanlines;
+};
+
+JpegEncoder::Compressor::Compressor() {
+  cinfo.err = jpeg_std_error(&err.pub);
+  err.pub.error_exit = ErrorExit;
+  err.pub.output_message = OutputMessage;
+  jpeg_create_compress(&cinfo);
+  dest.pub.init_destination = InitDestination;
+  dest.pub.empty_output_buffer = EmptyOutputBuffer;
+  dest.pub.term_destination = TermDestination;
+  cinfo.dest = &dest.pub;
+}
+
+bool JpegEncoder::Compressor::Encode(const Image& image, Image* out,
+                                     int quality) {
+  dest.image = out;
+
+  if (setjmp(err.jmp)) {
+    jpeg_abort_compress(&cinfo);
+    return false;
+  }
+
+  cinfo.image_width = image.width;
+  cinfo.image_height = image.height;
+  switch (image.pixelFormat) {
+    case VideoMode::kYUYV:
+      cinfo.input_components = 3;
+      cinfo.in_color_space = JCS_YCbCr;
+      break;
+    case VideoMode::kGray:
+      cinfo.input_components = 1;
+      cinfo.in_color_space = JCS_GRAYSCALE;
+      break;
+#ifdef JCS_EXTENSIONS
+    case VideoMode::kBGR:
+      cinfo.input_components = 3;
+      cinfo.in_color_space = JCS_EXT_BGR;
+      break;
+#endif
+    default:
+      return false;
+  }
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, quality, TRUE);
+
+  if (image.pixelFormat == VideoMode::kYUYV) {
+    // Feed 4:2:2 data directly; Y is sampled 2x horizontally
+    cinfo.raw_data_in = TRUE;
+    cinfo.comp_info[0].h_samp_factor = 2;
+    cinfo.comp_info[0].v_samp_factor = 1;
+    cinfo.comp_info[1].h_samp_factor = 1;
+    cinfo.comp_info[1].v_samp_factor = 1;
+    cinfo.comp_info[2].h_samp_factor = 1;
+    cinfo.comp_info[2].v_samp_factor = 1;
+    jpeg_start_compress(&cinfo, TRUE);
+    WriteYUYV(image);
+  } else {
+    jpeg_start_compress(&cinfo, TRUE);
+    WriteScanlines(image, image.width * cinfo.input_components);
+  }
+
+  jpeg_finish_compress(&cinfo);
+  return true;
+}
+
+void JpegEncoder::Compressor::WriteYUYV(const Image& image) {
+  int width = image.width;
+  int height = image.height;
+
+  // Raw data rows must be padded to a full MCU (16 pixels for 4:2:2)
+  size_t yWidth = (width + 15) & ~15;
+  size_t cWidth = yWidth / 2;
+  planes[0].resize(yWidth * DCTSIZE);
+  planes[1].resize(cWidth * DCTSIZE);
+  planes[2].resize(cWidth * DCTSIZE);
+  for (int i = 0; i < DCTSIZE; ++i) {
+    rows[0][i] = &planes[0][i * yWidth];
+    rows[1][i] = &planes[1][i * cWidth];
+    rows[2][i] = &planes[2][i * cWidth];
+  }
+  JSAMPARRAY data[3] = {rows[0], rows[1], rows[2]};
+
+  auto src = reinterpret_cast<const JSAMPLE*>(image.data());
+  size_t stride = width * 2;
+  for (int row = 0; row < height; row += DCTSIZE) {
+    for (int i = 0; i < DCTSIZE; ++i) {
+      // replicate the last row to fill out the final MCU row
+      const JSAMPLE* in = src + (std::min)(row + i, height - 1) * stride;
+      JSAMPLE* y = rows[0][i];
+      JSAMPLE* cb = rows[1][i];
+      JSAMPLE* cr = rows[2][i];
+      int x = 0;
+      for (; x < width / 2; ++x) {
+        y[2 * x] = in[4 * x];
+        cb[x] = in[4 * x + 1];
+        y[2 * x + 1] = in[4 * x + 2];
+        cr[x] = in[4 * x + 3];
+      }
+      // replicate the last column to fill out the final MCU
+      for (size_t p = 2 * x; p < yWidth; ++p) {
+        y[p] = y[2 * x - 1];
+      }
+      for (size_t p = x; p < cWidth; ++p) {
+        cb[p] = cb[x - 1];
+        cr[p] = cr[x - 1];
+      }
+    }
+    jpeg_write_raw_data(&cinfo, data, DCTSIZE);
+  }
+}
+
+void JpegEncoder::Compressor::WriteScanlines(const Image& image, int stride) {
+  // libjpeg doesn't modify the input, it's just not const-correct
+  auto src = reinterpret_cast<JSAMPLE*>(const_cast<char*>(image.data()));
+  scanlines.resize(image.height);
+  for (int i = 0; i < image.height; ++i) {
+    scanlines[i] = src + i * stride;
+  }
+  while (cinfo.next_scanline < cinfo.image_height) {
+    jpeg_write_scanlines(&cinfo, &scanlines[cinfo.next_scanline],
+                         cinfo.image_height - cinfo.next_scanline);
+  }
+}
+
+JpegEncoder::JpegEncoder() = default;
+
+JpegEncoder::~JpegEncoder() = default;
+
+bool JpegEncoder::IsSupported(VideoMode::PixelFormat pixelFormat) {
+  switch (pixelFormat) {
+    case VideoMode::kYUYV:
+    case VideoMode::kGray:
+#ifdef JCS_EXTENSIONS
+    case VideoMode::kBGR:
+#endif
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::unique_ptr<JpegEncoder::Compressor> JpegEncoder::GetCompressor() {
+  {
+    std::scoped_lock lock(m_mutex);
+    if (!m_compressors.empty()) {
+      auto compressor = std::move(m_compressors.back());
+      m_compressors.pop_back();
+      return compressor;
+    }
+  }
+  return std::make_unique<Compressor>();
+}
+
+bool JpegEncoder::Encode(const Image& image, Image* out, int quality) {
+  if (!IsSupported(image.pixelFormat) || image.width <= 0 ||
+      image.height <= 0 ||
+      (image.pixelFormat == VideoMode::kYUYV && (image.width % 2) != 0)) {
+    return false;
+  }
+  auto compressor = GetCompressor();
+  bool rv = compressor->Encode(image, out, quality);
+  std::scoped_lock lock(m_mutex);
+  m_compressors.emplace_back(std::move(compressor));
+  return rv;
+}
+
+#else  // CSCORE_USE_LIBJPEG_TURBO
+
+using namespace cs;
+
+struct JpegEncoder::Compressor {};
+
+JpegEncoder::JpegEncoder() = default;
+
+JpegEncoder::~JpegEncoder() = default;
+
+bool JpegEncoder::IsSupported(VideoMode::PixelFormat pixelFormat) {
+  return false;
+}
+
+std::unique_ptr<JpegEncoder::Compressor> JpegEncoder::GetCompressor() {
+  return nullptr;
+}
+
+bool JpegEncoder::Encode(const Image& image, Image* out, int quality) {
+  return false;
+}
+
+#endif  // CSCORE_USE_LIBJPEG_TURBO
@@ -0,0 +1,53 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_JPEGENCODER_H_
+#define CSCORE_JPEGENCODER_H_
+
+#include <memory>
+#include <vector>
+
+#include <wpi/mutex.h>
+
+#include "cscore_cpp.h"
+
+namespace cs {
+
+class Image;
+
+// Direct JPEG encoder using the libjpeg(-turbo) API.  YUYV images are fed to
+// the compressor as raw YCbCr 4:2:2 data and grayscale images as single
+// component scanlines, so no intermediate BGR image is created.
+//
+// Compressors are kept and reused between calls; concurrent Encode() calls
+// each get their own compressor.
+//
+// Only available when built with CSCORE_USE_LIBJPEG_TURBO; otherwise
+// IsSupported() always returns false and callers should fall back to OpenCV.
+class JpegEncoder {
+ public:
+  JpegEncoder();
+  ~JpegEncoder();
+
+  JpegEncoder(const JpegEncoder&) = delete;
+  JpegEncoder& operator=(const JpegEncoder&) = delete;
+
+  static bool IsSupported(VideoMode::PixelFormat pixelFormat);
+
+  // Compresses image into out (which must be an MJPEG image).  Returns false
+  // if the pixel format is not supported or compression failed.
+  bool Encode(const Image& image, Image* out, int quality);
+
+ private:
+  struct Compressor;
+
+  std::unique_ptr<Compressor> GetCompressor();
+
+  wpi::mutex m_mutex;
+  std::vector<std::unique_ptr<Compressor>> m_compressors;
+};
+
+}  // namespace cs
+
+#endif  // CSCORE_JPEGENCODER_H_
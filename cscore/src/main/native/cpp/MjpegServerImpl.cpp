@@ -4,6 +4,7 @@
 
 #include "MjpegServerImpl.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include <wpi/HttpUtil.h>
@@ -11,6 +12,7 @@
 #include <wpi/TCPAcceptor.h>
 #include <wpi/raw_socket_istream.h>
 #include <wpi/raw_socket_ostream.h>
+#include <wpi/timestamp.h>
 
 #include "Handle.h"
 #include "Instance.h"
@@ -18,6 +20,7 @@
 #include "Log.h"
 #include "Notifier.h"
 #include "SourceImpl.h"
+#include "Telemetry.h"
 #include "c_util.h"
 #include "cscore_cpp.h"
 
@@ -27,6 +30,9 @@ using namespace cs;
 // It separates the multipart stream of pictures
 #define BOUNDARY "boundarydonotcross"
 
+// Maximum bandwidth setting, in kbit/s (1 Gbit/s)
+static constexpr int kMaxBandwidth = 1000000;
+
 // A bare-bones HTML webpage for user friendliness.
 static const char* emptyRootPage =
     "</head><body>"
@@ -72,8 +78,11 @@ static const char* endRootPage = "</div></body></html>";
 
 class MjpegServerImpl::ConnThread : public wpi::SafeThread {
  public:
-  explicit ConnThread(const wpi::Twine& name, wpi::Logger& logger)
-      : m_name(name.str()), m_logger(logger) {}
+  ConnThread(const wpi::Twine& name, wpi::Logger& logger,
+             std::shared_ptr<TelemetryCounters> telemetry)
+      : m_name(name.str()),
+        m_logger(logger),
+        m_telemetry(std::move(telemetry)) {}
 
   void Main() override;
 
@@ -87,6 +96,7 @@ class MjpegServerImpl::ConnThread : public wpi::SafeThread {
 
   std::unique_ptr<wpi::NetworkStream> m_stream;
   std::shared_ptr<SourceImpl> m_source;
+  std::shared_ptr<StreamThread> m_streamThread;  // null if not shared
   bool m_streaming = false;
   bool m_noStreaming = false;
   int m_width = 0;
@@ -94,10 +104,17 @@ class MjpegServerImpl::ConnThread : public wpi::SafeThread {
   int m_compression = -1;
   int m_defaultCompression = 80;
   int m_fps = 0;
+  bool m_adaptive = false;
+  int m_bandwidth = 0;  // kbit/s, 0 for unlimited
+  std::shared_ptr<BandwidthLimiter> m_bandwidthLimiter;
 
  private:
   std::string m_name;
   wpi::Logger& m_logger;
+  std::shared_ptr<TelemetryCounters> m_telemetry;  // server sink counters
+  bool m_handoff = false;  // hand off stream to m_streamThread when done
+
+  void HandoffStream();
 
   wpi::StringRef GetName() { return m_name; }
 
@@ -123,6 +140,79 @@ class MjpegServerImpl::ConnThread : public wpi::SafeThread {
   }
 };
 
+// Shared streaming thread.  Instead of each streaming client blocking in its
+// own ConnThread, clients are handed off to this thread once the HTTP headers
+// have been sent.  A single wait for the next source frame then serves all
+// clients; per-client frame rates are handled by scheduling, and writes are
+// non-blocking, so frames are dropped for a slow client rather than stalling
+// every other client.
+class MjpegServerImpl::StreamThread : public wpi::SafeThread {
+ public:
+  StreamThread(const wpi::Twine& name, wpi::Logger& logger,
+               std::shared_ptr<TelemetryCounters> telemetry)
+      : m_name(name.str()),
+        m_logger(logger),
+        m_telemetry(std::move(telemetry)) {}
+
+  struct Client {
+    std::unique_ptr<wpi::NetworkStream> stream;
+    int width = 0;
+    int height = 0;
+    int compression = -1;
+    int defaultCompression = 80;
+
+    // Frame rate scheduling
+    Frame::Time timePerFrame = 0;
+    Frame::Time averagePeriod = 1000000;  // 1 second window
+    Frame::Time averageFrameTime = 0;
+    Frame::Time lastFrameTime = 0;
+
+    // Part currently being sent.  The image data is referenced directly from
+    // the frame (which is kept alive until the part has been fully sent).
+    Frame frame;
+    Image* image = nullptr;
+    wpi::SmallString<128> header;
+    bool addDHT = false;
+    size_t locSOF = 0;
+    size_t size = 0;
+    size_t sent = 0;
+    size_t total = 0;
+
+    // Frames dropped since the last frame sent (for telemetry)
+    int dropped = 0;
+
+    StreamRateControl rateControl;
+
+    bool HasBacklog() const { return sent < total; }
+  };
+
+  void Main() override;
+
+  void AddClient(std::unique_ptr<Client> client);
+  void SetSource(std::shared_ptr<SourceImpl> source);
+  int GetNumClients() const {
+    std::scoped_lock lock(m_mutex);
+    return m_numClients;
+  }
+
+ private:
+  std::string m_name;
+  wpi::Logger& m_logger;
+  std::shared_ptr<TelemetryCounters> m_telemetry;  // server sink counters
+
+  wpi::StringRef GetName() { return m_name; }
+
+  bool ScheduleFrame(Client& client, Frame::Time thisFrameTime);
+  void StartFrame(Client& client, const Frame& frame, Image* image);
+  void StartKeepAlive(Client& client);
+  bool SendPending(Client& client);
+
+  // Protected by m_mutex
+  std::shared_ptr<SourceImpl> m_source;
+  std::vector<std::unique_ptr<Client>> m_newClients;
+  int m_numClients = 0;  // clients enabled on m_source
+};
+
 // Standard header to send along with other header information like mimetype.
 //
 // The parameters should ensure the browser does not cache our answer.
@@ -239,8 +329,8 @@ bool MjpegServerImpl::ConnThread::ProcessCommand(wpi::raw_ostream& os,
       return false;
     }
 
-    // Handle resolution, compression, and FPS.  These are handled locally
-    // rather than passed to the source.
+    // Handle resolution, compression, FPS, and bandwidth.  These are handled
+    // locally rather than passed to the source.
     if (param == "resolution") {
       wpi::StringRef widthStr, heightStr;
       std::tie(widthStr, heightStr) = value.split('x');
@@ -291,6 +381,25 @@ bool MjpegServerImpl::ConnThread::ProcessCommand(wpi::raw_ostream& os,
       continue;
     }
 
+    if (param == "bandwidth") {
+      int bandwidth;
+      if (value.getAsInteger(10, bandwidth)) {
+        response << param << ": \"invalid integer\"\r\n";
+        SWARNING("HTTP parameter \"" << param << "\" value \"" << value
+                                     << "\" is not an integer");
+        continue;
+      } else if (bandwidth < 0) {
+        response << param << ": \"negative value\"\r\n";
+        SWARNING("HTTP parameter \"" << param << "\" value \"" << value
+                                     << "\" is negative");
+        continue;
+      } else {
+        m_bandwidth = (std::min)(bandwidth, kMaxBandwidth);
+        response << param << ": \"ok\"\r\n";
+      }
+      continue;
+    }
+
     // ignore name parameter
     if (param == "name") {
       continue;
@@ -595,7 +704,8 @@ MjpegServerImpl::MjpegServerImpl(const wpi::Twine& name, wpi::Logger& logger,
     : SinkImpl{name, logger, notifier, telemetry},
       m_listenAddress(listenAddress.str()),
       m_port(port),
-      m_acceptor{std::move(acceptor)} {
+      m_acceptor{std::move(acceptor)},
+      m_bandwidthLimiter{std::make_shared<BandwidthLimiter>()} {
   m_active = true;
 
   wpi::SmallString<128> descBuf;
@@ -621,6 +731,22 @@ MjpegServerImpl::MjpegServerImpl(const wpi::Twine& name, wpi::Logger& logger,
   m_fpsProp = CreateProperty("fps", [] {
     return std::make_unique<PropertyImpl>("fps", CS_PROP_INTEGER, 1, 0, 0);
   });
+  m_sharedStreamingProp = CreateProperty("shared_streaming", [] {
+    return std::make_unique<PropertyImpl>("shared_streaming", CS_PROP_BOOLEAN,
+                                          0, 1, 1, 0, 0);
+  });
+  m_adaptiveStreamingProp = CreateProperty("adaptive_streaming", [] {
+    return std::make_unique<PropertyImpl>("adaptive_streaming",
+                                          CS_PROP_BOOLEAN, 0, 1, 1, 0, 0);
+  });
+  m_streamBandwidthProp = CreateProperty("stream_bandwidth", [] {
+    return std::make_unique<PropertyImpl>("stream_bandwidth", CS_PROP_INTEGER,
+                                          0, kMaxBandwidth, 1, 0, 0);
+  });
+  m_maxBandwidthProp = CreateProperty("max_bandwidth", [] {
+    return std::make_unique<PropertyImpl>("max_bandwidth", CS_PROP_INTEGER, 0,
+                                          kMaxBandwidth, 1, 0, 0);
+  });
 
   m_serverThread = std::thread(&MjpegServerImpl::ServerThreadMain, this);
 }
@@ -650,12 +776,24 @@ void MjpegServerImpl::Stop() {
     connThread.Stop();
   }
 
+  // stop shared streaming thread (this closes its streams)
+  m_streamThread.Stop();
+
   // wake up connection threads by forcing an empty frame to be sent
   if (auto source = GetSource()) {
     source->Wakeup();
   }
 }
 
+void MjpegServerImpl::SetProperty(int property, int value, CS_Status* status) {
+  SinkImpl::SetProperty(property, value, status);
+  // The bandwidth cap applies to already connected clients as well
+  if (property == m_maxBandwidthProp && *status == CS_OK) {
+    m_bandwidthLimiter->SetRate(
+        static_cast<int64_t>(GetProperty(property, status)) * 125);
+  }
+}
+
 // Send HTTP response and a stream of JPG-frames
 void MjpegServerImpl::ConnThread::SendStream(wpi::raw_socket_ostream& os) {
   if (m_noStreaming) {
@@ -674,7 +812,15 @@ void MjpegServerImpl::ConnThread::SendStream(wpi::raw_socket_ostream& os) {
 
   SDEBUG("Headers send, sending stream now");
 
+  if (m_streamThread) {
+    // The stream can't be handed off until the request streams are done with
+    // it, so just flag it here; Main() does the actual handoff.
+    m_handoff = true;
+    return;
+  }
+
   Frame::Time lastFrameTime = 0;
+  uint64_t lastSequence = 0;
   Frame::Time timePerFrame = 0;
   if (m_fps != 0) {
     timePerFrame = 1000000.0 / m_fps;
@@ -685,6 +831,13 @@ void MjpegServerImpl::ConnThread::SendStream(wpi::raw_socket_ostream& os) {
     averagePeriod = timePerFrame * 10;
   }
 
+  StreamRateControl rateControl;
+  rateControl.Configure(
+      m_compression == -1 ? m_defaultCompression : m_compression,
+      static_cast<int64_t>(m_bandwidth) * 125, m_adaptive,
+      m_bandwidthLimiter);
+  int dropped = 0;
+
   StartStream();
   while (m_active && !os.has_error()) {
     auto source = GetSource();
@@ -706,6 +859,8 @@ void MjpegServerImpl::ConnThread::SendStream(wpi::raw_socket_ostream& os) {
       continue;
     }
 
+    m_telemetry->RecordDropped(frame.GetSequence(), &lastSequence);
+
     auto thisFrameTime = frame.GetTime();
     if (thisFrameTime != 0 && timePerFrame != 0 && lastFrameTime != 0) {
       Frame::Time deltaTime = thisFrameTime - lastFrameTime;
@@ -728,11 +883,28 @@ void MjpegServerImpl::ConnThread::SendStream(wpi::raw_socket_ostream& os) {
       }
     }
 
+    if (rateControl.IsEnabled() &&
+        !rateControl.StartFrame(
+            wpi::Now(), GetUnsentBytes(m_stream->getNativeHandle()))) {
+      SDEBUG4("skipping frame to limit bandwidth");
+      ++dropped;
+      continue;
+    }
+
+    source->GetTelemetryCounters()->RecordLatency(CS_SOURCE_CAPTURE_LATENCY,
+                                                  thisFrameTime);
+
     int width = m_width != 0 ? m_width : frame.GetOriginalWidth();
     int height = m_height != 0 ? m_height : frame.GetOriginalHeight();
+    int compression = m_compression;
+    if (rateControl.IsReduced()) {
+      width = (std::max)(width / rateControl.GetScale(), 1);
+      height = (std::max)(height / rateControl.GetScale(), 1);
+      compression = rateControl.GetQuality();
+    }
     Image* image = frame.GetImageMJPEG(
-        width, height, m_compression,
-        m_compression == -1 ? m_defaultCompression : m_compression);
+        width, height, compression,
+        compression == -1 ? m_defaultCompression : compression);
     if (!image) {
       // Shouldn't happen, but just in case...
       std::this_thread::sleep_for(std::chrono::milliseconds(20));
@@ -780,13 +952,23 @@ void MjpegServerImpl::ConnThread::SendStream(wpi::raw_socket_ostream& os) {
       os << wpi::StringRef(data, size);
     }
     // os.flush();
+
+    m_telemetry->Add(CS_SINK_BYTES_SENT, header.size() + size);
+    if (rateControl.IsEnabled()) {
+      rateControl.FrameSent(wpi::Now(), header.size() + size);
+    }
+    if (dropped != 0) {
+      m_telemetry->Record(CS_SINK_FRAMES_DROPPED, dropped);
+      dropped = 0;
+    }
   }
   StopStream();
 }
 
 void MjpegServerImpl::ConnThread::ProcessRequest() {
+  // Closing is left to the caller, as the stream may be handed off.
   wpi::raw_socket_istream is{*m_stream};
-  wpi::raw_socket_ostream os{*m_stream, true};
+  wpi::raw_socket_ostream os{*m_stream, false};
 
   // Read the request string from the stream
   wpi::SmallString<128> reqBuf;
@@ -923,10 +1105,323 @@ void MjpegServerImpl::ConnThread::Main() {
     lock.unlock();
     ProcessRequest();
     lock.lock();
+    if (m_handoff) {
+      m_handoff = false;
+      HandoffStream();
+    }
     m_stream = nullptr;
   }
 }
 
+void MjpegServerImpl::ConnThread::HandoffStream() {
+  if (!m_streamThread || !m_stream || !m_stream->setBlocking(false)) {
+    return;
+  }
+  auto client = std::make_unique<StreamThread::Client>();
+  client->stream = std::move(m_stream);
+  client->width = m_width;
+  client->height = m_height;
+  client->compression = m_compression;
+  client->defaultCompression = m_defaultCompression;
+  if (m_fps != 0) {
+    client->timePerFrame = 1000000.0 / m_fps;
+  }
+  if (client->averagePeriod < client->timePerFrame) {
+    client->averagePeriod = client->timePerFrame * 10;
+  }
+  client->rateControl.Configure(
+      m_compression == -1 ? m_defaultCompression : m_compression,
+      static_cast<int64_t>(m_bandwidth) * 125, m_adaptive,
+      m_bandwidthLimiter);
+  SDEBUG("handing off stream to shared streaming thread");
+  m_streamThread->AddClient(std::move(client));
+}
+
+void MjpegServerImpl::StreamThread::AddClient(std::unique_ptr<Client> client) {
+  std::scoped_lock lock(m_mutex);
+  if (!m_active) {
+    return;
+  }
+  if (m_source) {
+    m_source->EnableSink();
+  }
+  ++m_numClients;
+  m_newClients.emplace_back(std::move(client));
+  m_cond.notify_one();
+}
+
+void MjpegServerImpl::StreamThread::SetSource(
+    std::shared_ptr<SourceImpl> source) {
+  std::scoped_lock lock(m_mutex);
+  if (m_source == source) {
+    return;
+  }
+  // Move the enabled counts for all of our clients to the new source
+  for (int i = 0; i < m_numClients; ++i) {
+    if (m_source) {
+      m_source->DisableSink();
+    }
+    if (source) {
+      source->EnableSink();
+    }
+  }
+  m_source = std::move(source);
+}
+
+// Returns true if a frame should be sent to the client based on its desired
+// frame rate.  This is the same algorithm as ConnThread::SendStream() uses.
+bool MjpegServerImpl::StreamThread::ScheduleFrame(Client& client,
+                                                  Frame::Time thisFrameTime) {
+  if (thisFrameTime != 0 && client.timePerFrame != 0 &&
+      client.lastFrameTime != 0) {
+    Frame::Time deltaTime = thisFrameTime - client.lastFrameTime;
+
+    // drop frame if it is early compared to the desired frame rate AND
+    // the current average is higher than the desired average
+    if (deltaTime < client.timePerFrame &&
+        client.averageFrameTime < client.timePerFrame) {
+      return false;
+    }
+
+    // update average
+    if (client.averageFrameTime != 0) {
+      client.averageFrameTime =
+          client.averageFrameTime *
+              (client.averagePeriod - client.timePerFrame) /
+              client.averagePeriod +
+          deltaTime * client.timePerFrame / client.averagePeriod;
+    } else {
+      client.averageFrameTime = deltaTime;
+    }
+  }
+  client.lastFrameTime = thisFrameTime;
+  return true;
+}
+
+void MjpegServerImpl::StreamThread::StartFrame(Client& client,
+                                               const Frame& frame,
+                                               Image* image) {
+  client.frame = frame;
+  client.image = image;
+  client.size = image->size();
+  client.locSOF = client.size;
+  client.addDHT = JpegNeedsDHT(image->data(), &client.size, &client.locSOF);
+
+  double timestamp = client.lastFrameTime / 1000000.0;
+  client.header.clear();
+  wpi::raw_svector_ostream oss{client.header};
+  oss << "\r\n--" BOUNDARY "\r\n"
+      << "Content-Type: image/jpeg\r\n"
+      << "Content-Length: " << client.size << "\r\n"
+      << "X-Timestamp: " << timestamp << "\r\n"
+      << "\r\n";
+
+  client.sent = 0;
+  client.total = client.header.size();
+  if (client.addDHT) {
+    client.total += image->size() + JpegGetDHT().size();
+  } else {
+    client.total += client.size;
+  }
+}
+
+void MjpegServerImpl::StreamThread::StartKeepAlive(Client& client) {
+  client.frame = Frame{};
+  client.image = nullptr;
+  client.header = "\r\n";
+  client.sent = 0;
+  client.total = client.header.size();
+}
+
+// Sends as much of the current part as possible without blocking.
+// Returns false if the connection had an error.
+bool MjpegServerImpl::StreamThread::SendPending(Client& client) {
+  wpi::StringRef pieces[4];
+  size_t numPieces = 0;
+  pieces[numPieces++] = client.header;
+  if (client.image) {
+    wpi::StringRef data = client.image->str();
+    if (client.addDHT) {
+      // Insert DHT data immediately before SOF
+      pieces[numPieces++] = data.substr(0, client.locSOF);
+      pieces[numPieces++] = JpegGetDHT();
+      pieces[numPieces++] = data.substr(client.locSOF);
+    } else {
+      pieces[numPieces++] = data.substr(0, client.size);
+    }
+  }
+
+  size_t offset = 0;
+  for (size_t i = 0; i < numPieces; ++i) {
+    wpi::StringRef piece = pieces[i];
+    while (client.sent < offset + piece.size()) {
+      size_t pos = client.sent - offset;
+      wpi::NetworkStream::Error err = wpi::NetworkStream::kConnectionClosed;
+      size_t count =
+          client.stream->send(piece.data() + pos, piece.size() - pos, &err);
+      if (count == 0) {
+        return err == wpi::NetworkStream::kWouldBlock;
+      }
+      client.sent += count;
+      m_telemetry->Add(CS_SINK_BYTES_SENT, count);
+    }
+    offset += piece.size();
+  }
+
+  // Fully sent; release the frame so its images can be reused
+  client.frame = Frame{};
+  client.image = nullptr;
+  return true;
+}
+
+void MjpegServerImpl::StreamThread::Main() {
+  std::vector<std::unique_ptr<Client>> clients;
+  Frame::Time lastFrameTime = 0;
+  uint64_t lastSequence = 0;
+
+  std::unique_lock lock(m_mutex);
+  while (m_active) {
+    // Pick up any newly handed off clients
+    for (auto&& client : m_newClients) {
+      clients.emplace_back(std::move(client));
+    }
+    m_newClients.clear();
+    if (clients.empty()) {
+      m_cond.wait(lock);
+      continue;
+    }
+    auto source = m_source;
+    lock.unlock();
+
+    // Wait for the next frame; wake up more often if there's data left over
+    // from previous frames that needs to be flushed.
+    bool backlog = std::any_of(
+        clients.begin(), clients.end(),
+        [](const std::unique_ptr<Client>& c) { return c->HasBacklog(); });
+    Frame frame;
+    if (source) {
+      SDEBUG4("waiting for frame");
+      frame = source->GetNextFrame(lastFrameTime, backlog ? 0.01 : 0.225);
+    } else {
+      // Source disconnected; sleep so we don't consume all processor time.
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(backlog ? 10 : 200));
+    }
+    if (!m_active) {
+      lock.lock();
+      break;
+    }
+
+    // Flush data left over from previous frames
+    for (auto&& client : clients) {
+      if (client->HasBacklog() && !SendPending(*client)) {
+        client->stream.reset();
+      }
+    }
+
+    bool newFrame = source && frame.GetTime() != lastFrameTime;
+    if (newFrame) {
+      lastFrameTime = frame.GetTime();
+      m_telemetry->RecordDropped(frame.GetSequence(), &lastSequence);
+    }
+    if (!source || (newFrame && !frame)) {
+      // Source disconnected or bad frame; keep idle connections alive
+      for (auto&& client : clients) {
+        if (client->stream && !client->HasBacklog()) {
+          StartKeepAlive(*client);
+          if (!SendPending(*client)) {
+            client->stream.reset();
+          }
+        }
+      }
+    } else if (newFrame) {
+      for (auto&& client : clients) {
+        if (!client->stream) {
+          continue;
+        }
+        size_t unsent = client->total - client->sent;
+        m_telemetry->Record(CS_SINK_SEND_BACKLOG, unsent);
+        // Rate control sees every frame, even ones dropped for backlog, so
+        // that it can react to the congestion
+        bool send = !client->HasBacklog();
+        if (client->rateControl.IsEnabled()) {
+          unsent += GetUnsentBytes(client->stream->getNativeHandle());
+          if (!client->rateControl.StartFrame(wpi::Now(), unsent)) {
+            send = false;
+          }
+        }
+        if (!send) {
+          // Previous frame is still being sent, or over budget; drop this one
+          SDEBUG4("dropping frame for slow client");
+          ++client->dropped;
+          continue;
+        }
+        if (!ScheduleFrame(*client, lastFrameTime)) {
+          continue;
+        }
+
+        int width =
+            client->width != 0 ? client->width : frame.GetOriginalWidth();
+        int height =
+            client->height != 0 ? client->height : frame.GetOriginalHeight();
+        int compression = client->compression;
+        if (client->rateControl.IsReduced()) {
+          width = (std::max)(width / client->rateControl.GetScale(), 1);
+          height = (std::max)(height / client->rateControl.GetScale(), 1);
+          compression = client->rateControl.GetQuality();
+        }
+        Image* image = frame.GetImageMJPEG(
+            width, height, compression,
+            compression == -1 ? client->defaultCompression : compression);
+        if (!image || image->pixelFormat != VideoMode::kMJPEG) {
+          continue;
+        }
+
+        StartFrame(*client, frame, image);
+        if (client->rateControl.IsEnabled()) {
+          client->rateControl.FrameSent(wpi::Now(), client->total);
+        }
+        source->GetTelemetryCounters()->RecordLatency(
+            CS_SOURCE_CAPTURE_LATENCY, frame.GetTime());
+        if (client->dropped != 0) {
+          m_telemetry->Record(CS_SINK_FRAMES_DROPPED, client->dropped);
+          client->dropped = 0;
+        }
+        SDEBUG4("sending frame size=" << client->size
+                                      << " addDHT=" << client->addDHT);
+        if (!SendPending(*client)) {
+          client->stream.reset();
+        }
+      }
+    }
+
+    lock.lock();
+
+    // Remove closed clients
+    auto it = std::remove_if(
+        clients.begin(), clients.end(),
+        [](const std::unique_ptr<Client>& c) { return !c->stream; });
+    for (auto i = it; i != clients.end(); ++i) {
+      SDEBUG("stream client disconnected");
+      if (m_source) {
+        m_source->DisableSink();
+      }
+      --m_numClients;
+    }
+    clients.erase(it, clients.end());
+  }
+
+  // Thread is terminating; disable all remaining clients
+  for (int i = 0; i < m_numClients; ++i) {
+    if (m_source) {
+      m_source->DisableSink();
+    }
+  }
+  m_numClients = 0;
+  m_newClients.clear();
+  SDEBUG("leaving shared streaming thread");
+}
+
 // Main server thread
 void MjpegServerImpl::ServerThreadMain() {
   if (m_acceptor->start() != 0) {
@@ -962,7 +1457,16 @@ void MjpegServerImpl::ServerThreadMain() {
     }
 
     // Start it if not already started
-    it->Start(GetName(), m_logger);
+    it->Start(GetName(), m_logger, m_telemetryCounters);
+
+    std::shared_ptr<StreamThread> streamThread;
+    if (GetProperty(m_sharedStreamingProp)->value) {
+      m_streamThread.Start(GetName(), m_logger, m_telemetryCounters);
+      streamThread = m_streamThread.GetThreadSharedPtr();
+      if (streamThread) {
+        streamThread->SetSource(source);
+      }
+    }
 
     auto nstreams =
         std::count_if(m_connThreads.begin(), m_connThreads.end(),
@@ -970,17 +1474,24 @@ void MjpegServerImpl::ServerThreadMain() {
                         auto thr = owner.GetThread();
                         return thr && thr->m_streaming;
                       });
+    if (auto thr = m_streamThread.GetThreadSharedPtr()) {
+      nstreams += thr->GetNumClients();
+    }
 
     // Hand off connection to it
     auto thr = it->GetThread();
     thr->m_stream = std::move(stream);
     thr->m_source = source;
+    thr->m_streamThread = streamThread;
     thr->m_noStreaming = nstreams >= 10;
     thr->m_width = GetProperty(m_widthProp)->value;
     thr->m_height = GetProperty(m_heightProp)->value;
     thr->m_compression = GetProperty(m_compressionProp)->value;
     thr->m_defaultCompression = GetProperty(m_defaultCompressionProp)->value;
     thr->m_fps = GetProperty(m_fpsProp)->value;
+    thr->m_adaptive = GetProperty(m_adaptiveStreamingProp)->value;
+    thr->m_bandwidth = GetProperty(m_streamBandwidthProp)->value;
+    thr->m_bandwidthLimiter = m_bandwidthLimiter;
     thr->m_cond.notify_one();
   }
 
@@ -1003,6 +1514,9 @@ void MjpegServerImpl::SetSourceImpl(std::shared_ptr<SourceImpl> source) {
       }
     }
   }
+  if (auto thr = m_streamThread.GetThreadSharedPtr()) {
+    thr->SetSource(source);
+  }
 }
 
 namespace cs {
@@ -21,6 +21,7 @@
 #include <wpi/raw_socket_ostream.h>
 
 #include "SinkImpl.h"
+#include "StreamRateControl.h"
 
 namespace cs {
 
@@ -38,12 +39,15 @@ class MjpegServerImpl : public SinkImpl {
   std::string GetListenAddress() { return m_listenAddress; }
   int GetPort() { return m_port; }
 
+  void SetProperty(int property, int value, CS_Status* status) override;
+
  private:
   void SetSourceImpl(std::shared_ptr<SourceImpl> source) override;
 
   void ServerThreadMain();
 
   class ConnThread;
+  class StreamThread;
 
   // Never changed, so not protected by mutex
   std::string m_listenAddress;
@@ -55,12 +59,22 @@ class MjpegServerImpl : public SinkImpl {
 
   std::vector<wpi::SafeThreadOwner<ConnThread>> m_connThreads;
 
+  // Shared streaming thread; only started if shared streaming is enabled
+  wpi::SafeThreadOwner<StreamThread> m_streamThread;
+
+  // Bandwidth cap shared by all clients
+  std::shared_ptr<BandwidthLimiter> m_bandwidthLimiter;
+
   // property indices
   int m_widthProp;
   int m_heightProp;
   int m_compressionProp;
   int m_defaultCompressionProp;
   int m_fpsProp;
+  int m_sharedStreamingProp;
+  int m_adaptiveStreamingProp;
+  int m_streamBandwidthProp;
+  int m_maxBandwidthProp;
 };
 
 }  // namespace cs
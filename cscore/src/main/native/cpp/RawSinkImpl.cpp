@@ -57,6 +57,7 @@ uint64_t RawSinkImpl::GrabFrame(CS_RawFrame& image) {
     return 0;  // signal error
   }
 
+  RecordFrameTelemetry(*source, frame);
   return GrabFrameImpl(image, frame);
 }
 
@@ -77,11 +78,64 @@ uint64_t RawSinkImpl::GrabFrame(CS_RawFrame& image, double timeout) {
     return 0;  // signal error
   }
 
+  RecordFrameTelemetry(*source, frame);
   return GrabFrameImpl(image, frame);
 }
 
+uint64_t RawSinkImpl::GrabFrameDirect(CS_RawFrame& image) {
+  SetEnabled(true);
+
+  // the previous image is no longer needed
+  m_directFrame = Frame{};
+  m_directSource.reset();
+
+  auto source = GetSource();
+  if (!source) {
+    // Source disconnected; sleep for one second
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    return 0;
+  }
+
+  auto frame = source->GetNextFrame();  // blocks
+  if (!frame) {
+    // Bad frame; sleep for 20 ms so we don't consume all processor time.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return 0;  // signal error
+  }
+
+  RecordFrameTelemetry(*source, frame);
+  m_directSource = source;
+  return GrabFrameImpl(image, frame, true);
+}
+
+uint64_t RawSinkImpl::GrabFrameDirect(CS_RawFrame& image, double timeout) {
+  SetEnabled(true);
+
+  // the previous image is no longer needed
+  m_directFrame = Frame{};
+  m_directSource.reset();
+
+  auto source = GetSource();
+  if (!source) {
+    // Source disconnected; sleep for one second
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    return 0;
+  }
+
+  auto frame = source->GetNextFrame(timeout);  // blocks
+  if (!frame) {
+    // Bad frame; sleep for 20 ms so we don't consume all processor time.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return 0;  // signal error
+  }
+
+  RecordFrameTelemetry(*source, frame);
+  m_directSource = source;
+  return GrabFrameImpl(image, frame, true);
+}
+
 uint64_t RawSinkImpl::GrabFrameImpl(CS_RawFrame& rawFrame,
-                                    Frame& incomingFrame) {
+                                    Frame& incomingFrame, bool direct) {
   Image* newImage = nullptr;
 
   if (rawFrame.pixelFormat == CS_PixelFormat::CS_PIXFMT_UNKNOWN) {
@@ -97,7 +151,7 @@ uint64_t RawSinkImpl::GrabFrameImpl(CS_RawFrame& rawFrame,
       width = incomingFrame.GetOriginalWidth();
       height = incomingFrame.GetOriginalHeight();
     }
-    newImage = incomingFrame.GetImage(width, height, pixelFormat);
+    newImage = GetGrabImage(incomingFrame, width, height, pixelFormat);
   }
 
   if (!newImage) {
@@ -106,13 +160,25 @@ uint64_t RawSinkImpl::GrabFrameImpl(CS_RawFrame& rawFrame,
     return 0;
   }
 
-  CS_AllocateRawFrameData(&rawFrame, newImage->size());
+  if (direct) {
+    // Reference the image data (images are never modified once added to a
+    // frame); keep the frame alive until the next grab.
+    CS_FreeRawFrameData(&rawFrame);
+    rawFrame.data = const_cast<char*>(newImage->data());
+    rawFrame.dataLength = 0;
+  } else {
+    CS_AllocateRawFrameData(&rawFrame, newImage->size());
+  }
   rawFrame.height = newImage->height;
   rawFrame.width = newImage->width;
   rawFrame.pixelFormat = newImage->pixelFormat;
   rawFrame.totalData = newImage->size();
-  std::copy(newImage->data(), newImage->data() + rawFrame.totalData,
-            rawFrame.data);
+  if (direct) {
+    m_directFrame = incomingFrame;
+  } else {
+    std::copy(newImage->data(), newImage->data() + rawFrame.totalData,
+              rawFrame.data);
+  }
 
   return incomingFrame.GetTime();
 }
@@ -177,6 +243,27 @@ uint64_t GrabSinkFrameTimeout(CS_Sink sink, CS_RawFrame& image, double timeout,
   }
   return static_cast<RawSinkImpl&>(*data->sink).GrabFrame(image, timeout);
 }
+
+uint64_t GrabSinkFrameDirect(CS_Sink sink, CS_RawFrame& image,
+                             CS_Status* status) {
+  auto data = Instance::GetInstance().GetSink(sink);
+  if (!data || data->kind != CS_SINK_RAW) {
+    *status = CS_INVALID_HANDLE;
+    return 0;
+  }
+  return static_cast<RawSinkImpl&>(*data->sink).GrabFrameDirect(image);
+}
+
+uint64_t GrabSinkFrameTimeoutDirect(CS_Sink sink, CS_RawFrame& image,
+                                    double timeout, CS_Status* status) {
+  auto data = Instance::GetInstance().GetSink(sink);
+  if (!data || data->kind != CS_SINK_RAW) {
+    *status = CS_INVALID_HANDLE;
+    return 0;
+  }
+  return static_cast<RawSinkImpl&>(*data->sink).GrabFrameDirect(image,
+                                                                timeout);
+}
 }  // namespace cs
 
 extern "C" {
@@ -201,4 +288,15 @@ uint64_t CS_GrabRawSinkFrameTimeout(CS_Sink sink, struct CS_RawFrame* image,
                                     double timeout, CS_Status* status) {
   return cs::GrabSinkFrameTimeout(sink, *image, timeout, status);
 }
+
+uint64_t CS_GrabRawSinkFrameDirect(CS_Sink sink, struct CS_RawFrame* image,
+                                   CS_Status* status) {
+  return cs::GrabSinkFrameDirect(sink, *image, status);
+}
+
+uint64_t CS_GrabRawSinkFrameTimeoutDirect(CS_Sink sink,
+                                          struct CS_RawFrame* image,
+                                          double timeout, CS_Status* status) {
+  return cs::GrabSinkFrameTimeoutDirect(sink, *image, timeout, status);
+}
 }  // extern "C"
@@ -9,6 +9,7 @@
 
 #include <atomic>
 #include <functional>
+#include <memory>
 #include <thread>
 
 #include <wpi/Twine.h>
@@ -35,10 +36,23 @@ class RawSinkImpl : public SinkImpl {
   uint64_t GrabFrame(CS_RawFrame& frame);
   uint64_t GrabFrame(CS_RawFrame& frame, double timeout);
 
+  // Like GrabFrame(), but frame.data references the frame's data instead of
+  // a copy (with frame.dataLength set to 0 to indicate it is not owned).
+  // The frame is kept alive until the next grab.
+  uint64_t GrabFrameDirect(CS_RawFrame& frame);
+  uint64_t GrabFrameDirect(CS_RawFrame& frame, double timeout);
+
  private:
   void ThreadMain();
 
-  uint64_t GrabFrameImpl(CS_RawFrame& rawFrame, Frame& incomingFrame);
+  uint64_t GrabFrameImpl(CS_RawFrame& rawFrame, Frame& incomingFrame,
+                         bool direct = false);
+
+  // Frame referenced by the last GrabFrameDirect() image, and its source,
+  // which the frame refers to (declared first so it outlives the frame, as
+  // the sink's source may be changed while the frame is held)
+  std::shared_ptr<SourceImpl> m_directSource;
+  Frame m_directFrame;
 
   std::atomic_bool m_active;  // set to false to terminate threads
   std::thread m_thread;
@@ -0,0 +1,255 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "RecordingFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <wpi/Endian.h>
+#include <wpi/FileSystem.h>
+#include <wpi/SmallString.h>
+#include <wpi/raw_ostream.h>
+
+using namespace cs;
+
+namespace endian = wpi::support::endian;
+
+static constexpr char kFileMagic[6] = {'C', 'S', 'R', 'E', 'C', 1};
+static constexpr size_t kFileHeaderSize = 8;
+static constexpr char kIndexMagic[6] = {'C', 'S', 'R', 'I', 'D', 'X'};
+static constexpr size_t kIndexEntrySize = 16;
+static constexpr size_t kTrailerSize = 24;
+
+// Frames are appended through a buffer of this size; larger frames are
+// written directly.
+static constexpr size_t kWriteBufferSize = 1024 * 1024;
+
+// Initial index capacity (about 9 minutes at 30 fps)
+static constexpr size_t kInitialIndexSize = 16384;
+
+static void EncodeFrameHeader(const RecordingFrameHeader& header, char* buf) {
+  endian::write32le(buf, header.size);
+  endian::write32le(buf + 4, static_cast<uint32_t>(header.pixelFormat));
+  endian::write32le(buf + 8, static_cast<uint32_t>(header.width));
+  endian::write32le(buf + 12, static_cast<uint32_t>(header.height));
+  endian::write64le(buf + 16, header.time);
+}
+
+// Returns the size of an uncompressed image, or 0 if not known in advance.
+static uint64_t GetImageSize(VideoMode::PixelFormat pixelFormat, int width,
+                             int height) {
+  uint64_t pixels = static_cast<uint64_t>(width) * height;
+  switch (pixelFormat) {
+    case VideoMode::kYUYV:
+    case VideoMode::kRGB565:
+      return pixels * 2;
+    case VideoMode::kBGR:
+      return pixels * 3;
+    case VideoMode::kGray:
+      return pixels;
+    default:
+      return 0;
+  }
+}
+
+// maxSize is the number of bytes left in the file after the header.
+static bool DecodeFrameHeader(const char* buf, uint64_t maxSize,
+                              RecordingFrameHeader* header) {
+  header->size = endian::read32le(buf);
+  uint32_t pixelFormat = endian::read32le(buf + 4);
+  header->width = endian::read32le(buf + 8);
+  header->height = endian::read32le(buf + 12);
+  header->time = endian::read64le(buf + 16);
+  if (pixelFormat > VideoMode::kGray || header->width <= 0 ||
+      header->height <= 0 || header->size > maxSize) {
+    return false;
+  }
+  header->pixelFormat = static_cast<VideoMode::PixelFormat>(pixelFormat);
+  // the data is allocated and converted based on its size and dimensions
+  // respectively, so they must agree
+  if (header->size <
+      GetImageSize(header->pixelFormat, header->width, header->height)) {
+    return false;
+  }
+  return true;
+}
+
+RecordingWriter::RecordingWriter() = default;
+
+RecordingWriter::~RecordingWriter() {
+  Close();
+}
+
+bool RecordingWriter::Open(const wpi::Twine& path, std::string* error) {
+  Close();
+  wpi::SmallString<128> pathBuf;
+  std::error_code ec;
+  auto os = std::make_unique<wpi::raw_fd_ostream>(
+      path.toStringRef(pathBuf), ec, wpi::sys::fs::CD_CreateAlways);
+  if (ec) {
+    *error = ec.message();
+    os->clear_error();
+    return false;
+  }
+  os->SetBufferSize(kWriteBufferSize);
+
+  char header[kFileHeaderSize] = {};
+  std::memcpy(header, kFileMagic, sizeof(kFileMagic));
+  os->write(header, sizeof(header));
+
+  m_os = std::move(os);
+  m_index.clear();
+  m_index.reserve(kInitialIndexSize);
+  return true;
+}
+
+bool RecordingWriter::WriteFrame(const RecordingFrameHeader& header,
+                                 const char* data) {
+  if (!m_os || m_os->has_error()) {
+    return false;
+  }
+  m_index.push_back(IndexEntry{m_os->tell(), header.time});
+  char buf[RecordingFrameHeader::kSize];
+  EncodeFrameHeader(header, buf);
+  m_os->write(buf, sizeof(buf));
+  m_os->write(data, header.size);
+  return !m_os->has_error();
+}
+
+bool RecordingWriter::Close() {
+  if (!m_os) {
+    return true;
+  }
+  uint64_t indexOffset = m_os->tell();
+  for (auto&& entry : m_index) {
+    char buf[kIndexEntrySize];
+    endian::write64le(buf, entry.offset);
+    endian::write64le(buf + 8, entry.time);
+    m_os->write(buf, sizeof(buf));
+  }
+  char trailer[kTrailerSize] = {};
+  endian::write64le(trailer, indexOffset);
+  endian::write64le(trailer + 8, m_index.size());
+  std::memcpy(trailer + 16, kIndexMagic, sizeof(kIndexMagic));
+  m_os->write(trailer, sizeof(trailer));
+  m_os->close();
+
+  bool ok = !m_os->has_error();
+  m_os->clear_error();
+  m_os.reset();
+  return ok;
+}
+
+bool RecordingReader::Open(const wpi::Twine& path, std::string* error) {
+  wpi::SmallString<128> pathBuf;
+  m_is.open(path.toNullTerminatedStringRef(pathBuf).data(),
+            std::ios::in | std::ios::binary);
+  if (!m_is) {
+    *error = "could not open file";
+    return false;
+  }
+
+  char header[kFileHeaderSize];
+  if (!m_is.read(header, sizeof(header)) ||
+      std::memcmp(header, kFileMagic, sizeof(kFileMagic)) != 0) {
+    *error = "not a recording file";
+    return false;
+  }
+
+  m_is.seekg(0, std::ios::end);
+  m_fileSize = static_cast<uint64_t>(m_is.tellg());
+  if (!ReadIndex(m_fileSize)) {
+    RebuildIndex(m_fileSize);
+  }
+  if (m_index.empty()) {
+    *error = "recording contains no frames";
+    return false;
+  }
+  return true;
+}
+
+bool RecordingReader::ReadIndex(uint64_t fileSize) {
+  if (fileSize < kFileHeaderSize + kTrailerSize) {
+    return false;
+  }
+  char trailer[kTrailerSize];
+  m_is.clear();
+  m_is.seekg(fileSize - kTrailerSize);
+  if (!m_is.read(trailer, sizeof(trailer)) ||
+      std::memcmp(trailer + 16, kIndexMagic, sizeof(kIndexMagic)) != 0) {
+    return false;
+  }
+  uint64_t indexOffset = endian::read64le(trailer);
+  uint64_t count = endian::read64le(trailer + 8);
+  // checked in this order so neither the subtraction nor count *
+  // kIndexEntrySize below can overflow
+  if (indexOffset < kFileHeaderSize || indexOffset > fileSize - kTrailerSize ||
+      (fileSize - kTrailerSize - indexOffset) / kIndexEntrySize != count) {
+    return false;
+  }
+
+  std::vector<char> buf(count * kIndexEntrySize);
+  m_is.seekg(indexOffset);
+  if (!m_is.read(buf.data(), buf.size())) {
+    return false;
+  }
+  m_index.resize(count);
+  for (uint64_t i = 0; i < count; ++i) {
+    m_index[i].offset = endian::read64le(&buf[i * kIndexEntrySize]);
+    m_index[i].time = endian::read64le(&buf[i * kIndexEntrySize + 8]);
+  }
+  return true;
+}
+
+void RecordingReader::RebuildIndex(uint64_t fileSize) {
+  m_index.clear();
+  m_is.clear();
+  uint64_t offset = kFileHeaderSize;
+  while (offset + RecordingFrameHeader::kSize <= fileSize) {
+    char buf[RecordingFrameHeader::kSize];
+    RecordingFrameHeader header;
+    m_is.seekg(offset);
+    // a truncated frame fails to decode
+    if (!m_is.read(buf, sizeof(buf)) ||
+        !DecodeFrameHeader(
+            buf, fileSize - offset - RecordingFrameHeader::kSize, &header)) {
+      break;
+    }
+    m_index.push_back(IndexEntry{offset, header.time});
+    offset += RecordingFrameHeader::kSize + header.size;
+  }
+  m_is.clear();
+}
+
+size_t RecordingReader::FindFrame(uint64_t time) const {
+  return std::lower_bound(m_index.begin(), m_index.end(), time,
+                          [](const IndexEntry& entry, uint64_t time) {
+                            return entry.time < time;
+                          }) -
+         m_index.begin();
+}
+
+bool RecordingReader::ReadFrameHeader(size_t frame,
+                                      RecordingFrameHeader* header) {
+  if (frame >= m_index.size()) {
+    return false;
+  }
+  // the offsets come from the file's index, so may be out of range
+  uint64_t offset = m_index[frame].offset;
+  if (offset > m_fileSize ||
+      m_fileSize - offset < RecordingFrameHeader::kSize) {
+    return false;
+  }
+  char buf[RecordingFrameHeader::kSize];
+  m_is.clear();
+  m_is.seekg(offset);
+  return m_is.read(buf, sizeof(buf)) &&
+         DecodeFrameHeader(
+             buf, m_fileSize - offset - RecordingFrameHeader::kSize, header);
+}
+
+bool RecordingReader::ReadFrameData(char* data, size_t size) {
+  return static_cast<bool>(m_is.read(data, size));
+}
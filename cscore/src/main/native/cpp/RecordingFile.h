@@ -0,0 +1,111 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_RECORDINGFILE_H_
+#define CSCORE_RECORDINGFILE_H_
+
+#include <stdint.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wpi/Twine.h>
+
+#include "cscore_cpp.h"
+
+namespace wpi {
+class raw_fd_ostream;
+}  // namespace wpi
+
+namespace cs {
+
+// Recording file format (all values little endian):
+//
+//   header   "CSREC" magic, version byte, 2 reserved bytes (8 bytes)
+//   records  for each frame, a 24-byte record header followed by the image
+//            data exactly as it was received from the source (e.g. JPEG)
+//   index    for each frame, the uint64 record offset and uint64 time
+//   trailer  uint64 index offset, uint64 frame count, "CSRIDX" magic and 2
+//            reserved bytes (24 bytes)
+//
+// The index and trailer are written when the recording is closed.  If they
+// are missing (e.g. the program was killed while recording), the reader
+// rebuilds the index by scanning the records.
+
+struct RecordingFrameHeader {
+  static constexpr size_t kSize = 24;
+
+  uint32_t size = 0;
+  VideoMode::PixelFormat pixelFormat = VideoMode::kUnknown;
+  int width = 0;
+  int height = 0;
+  uint64_t time = 0;  // capture time (wpi::Now() timebase)
+};
+
+class RecordingWriter {
+ public:
+  RecordingWriter();
+  ~RecordingWriter();
+  RecordingWriter(const RecordingWriter&) = delete;
+  RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+  // Creates (or truncates) the file and writes the file header.
+  bool Open(const wpi::Twine& path, std::string* error);
+  bool IsOpen() const { return m_os != nullptr; }
+
+  // Appends a frame; header.size bytes are written from data.
+  bool WriteFrame(const RecordingFrameHeader& header, const char* data);
+
+  // Writes the index and trailer and closes the file.
+  bool Close();
+
+  size_t GetNumFrames() const { return m_index.size(); }
+
+ private:
+  struct IndexEntry {
+    uint64_t offset;
+    uint64_t time;
+  };
+
+  std::unique_ptr<wpi::raw_fd_ostream> m_os;
+  std::vector<IndexEntry> m_index;
+};
+
+class RecordingReader {
+ public:
+  // Opens the file and reads (or rebuilds) the index.
+  bool Open(const wpi::Twine& path, std::string* error);
+
+  size_t GetNumFrames() const { return m_index.size(); }
+  uint64_t GetFrameTime(size_t frame) const { return m_index[frame].time; }
+
+  // Finds the first frame at or after time; returns GetNumFrames() if there
+  // are none.
+  size_t FindFrame(uint64_t time) const;
+
+  // Reads a frame header.  The frame data must then be read with
+  // ReadFrameData() before reading another frame.  Fails if the header is
+  // invalid or its data doesn't fit in the file.
+  bool ReadFrameHeader(size_t frame, RecordingFrameHeader* header);
+  bool ReadFrameData(char* data, size_t size);
+
+ private:
+  struct IndexEntry {
+    uint64_t offset;
+    uint64_t time;
+  };
+
+  bool ReadIndex(uint64_t fileSize);
+  void RebuildIndex(uint64_t fileSize);
+
+  std::ifstream m_is;
+  uint64_t m_fileSize = 0;
+  std::vector<IndexEntry> m_index;
+};
+
+}  // namespace cs
+
+#endif  // CSCORE_RECORDINGFILE_H_
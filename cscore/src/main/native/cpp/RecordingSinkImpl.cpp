@@ -0,0 +1,179 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "RecordingSinkImpl.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Instance.h"
+#include "Log.h"
+#include "c_util.h"
+#include "cscore_cpp.h"
+
+using namespace cs;
+
+// Number of frames that can be waiting to be written
+static constexpr size_t kNumBuffers = 8;
+
+// Initial size of each buffer; buffers grow (once) to fit larger frames
+static constexpr size_t kInitialBufferSize = 256 * 1024;
+
+RecordingSinkImpl::RecordingSinkImpl(const wpi::Twine& name,
+                                     wpi::Logger& logger, Notifier& notifier,
+                                     Telemetry& telemetry,
+                                     const wpi::Twine& path)
+    : SinkImpl{name, logger, notifier, telemetry} {
+  std::string error;
+  if (!m_writer.Open(path, &error)) {
+    SERROR("could not create '" << path << "': " << error);
+    return;
+  }
+
+  m_freeBuffers.reserve(kNumBuffers);
+  for (size_t i = 0; i < kNumBuffers; ++i) {
+    auto buffer = std::make_unique<Buffer>();
+    buffer->data.reserve(kInitialBufferSize);
+    m_freeBuffers.emplace_back(std::move(buffer));
+  }
+
+  m_active = true;
+  m_grabThread = std::thread(&RecordingSinkImpl::GrabThreadMain, this);
+  m_writeThread = std::thread(&RecordingSinkImpl::WriteThreadMain, this);
+}
+
+RecordingSinkImpl::~RecordingSinkImpl() {
+  Stop();
+}
+
+void RecordingSinkImpl::Stop() {
+  {
+    // set under the lock so the write thread can't miss the notification
+    // below between checking its wait condition and blocking
+    std::scoped_lock lock(m_bufferMutex);
+    m_active = false;
+  }
+
+  // wake up any waiters by forcing an empty frame to be sent
+  if (auto source = GetSource()) {
+    source->Wakeup();
+  }
+
+  // join threads; the write thread finishes writing queued frames first
+  if (m_grabThread.joinable()) {
+    m_grabThread.join();
+  }
+  m_bufferCv.notify_all();
+  if (m_writeThread.joinable()) {
+    m_writeThread.join();
+  }
+
+  size_t numFrames = m_writer.GetNumFrames();
+  if (!m_writer.Close()) {
+    SERROR("error writing recording");
+  } else if (numFrames > 0) {
+    SINFO("recorded " << numFrames << " frames");
+  }
+}
+
+void RecordingSinkImpl::GrabThreadMain() {
+  Enable();
+  while (m_active) {
+    auto source = GetSource();
+    if (!source) {
+      // Source disconnected; sleep for one second
+      std::this_thread::sleep_for(std::chrono::seconds(1));
+      continue;
+    }
+    SDEBUG4("waiting for frame");
+    Frame frame = source->GetNextFrame();  // blocks
+    if (!m_active) {
+      break;
+    }
+    if (!frame) {
+      // Bad frame; sleep for 10 ms so we don't consume all processor time.
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+
+    // Record the image as it was received from the source (no conversion)
+    Image* image = frame.GetExistingImage();
+    if (!image) {
+      continue;
+    }
+
+    std::unique_ptr<Buffer> buffer;
+    {
+      std::scoped_lock lock(m_bufferMutex);
+      if (m_freeBuffers.empty()) {
+        SDEBUG("writer falling behind; dropping frame");
+        continue;
+      }
+      buffer = std::move(m_freeBuffers.back());
+      m_freeBuffers.pop_back();
+    }
+
+    buffer->header.size = image->size();
+    buffer->header.pixelFormat = image->pixelFormat;
+    buffer->header.width = image->width;
+    buffer->header.height = image->height;
+    buffer->header.time = frame.GetTime();
+    buffer->data.assign(image->data(), image->data() + image->size());
+    RecordFrameTelemetry(*source, frame);
+
+    {
+      std::scoped_lock lock(m_bufferMutex);
+      m_writeQueue.emplace_back(std::move(buffer));
+    }
+    m_bufferCv.notify_one();
+  }
+  Disable();
+}
+
+void RecordingSinkImpl::WriteThreadMain() {
+  bool error = false;
+  std::unique_lock lock(m_bufferMutex);
+  for (;;) {
+    m_bufferCv.wait(lock, [&] { return !m_active || !m_writeQueue.empty(); });
+    if (m_writeQueue.empty()) {
+      break;  // only get here when stopping
+    }
+    auto buffer = std::move(m_writeQueue.front());
+    m_writeQueue.pop_front();
+    lock.unlock();
+
+    if (!error && !m_writer.WriteFrame(buffer->header, buffer->data.data())) {
+      SERROR("error writing recording; recording stopped");
+      error = true;
+    }
+
+    lock.lock();
+    m_freeBuffers.emplace_back(std::move(buffer));
+  }
+}
+
+namespace cs {
+
+CS_Sink CreateRecordingSink(const wpi::Twine& name, const wpi::Twine& path,
+                            CS_Status* status) {
+  auto& inst = Instance::GetInstance();
+  auto sink = std::make_shared<RecordingSinkImpl>(
+      name, inst.logger, inst.notifier, inst.telemetry, path);
+  if (!sink->IsOpen()) {
+    *status = CS_WRITE_FAILED;
+    return 0;
+  }
+  return inst.CreateSink(CS_SINK_RECORDING, sink);
+}
+
+}  // namespace cs
+
+extern "C" {
+
+CS_Sink CS_CreateRecordingSink(const char* name, const char* path,
+                               CS_Status* status) {
+  return cs::CreateRecordingSink(name, path, status);
+}
+
+}  // extern "C"
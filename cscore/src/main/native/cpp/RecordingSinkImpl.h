@@ -0,0 +1,62 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_RECORDINGSINKIMPL_H_
+#define CSCORE_RECORDINGSINKIMPL_H_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <wpi/Twine.h>
+#include <wpi/condition_variable.h>
+#include <wpi/mutex.h>
+
+#include "RecordingFile.h"
+#include "SinkImpl.h"
+
+namespace cs {
+
+class RecordingSinkImpl : public SinkImpl {
+ public:
+  RecordingSinkImpl(const wpi::Twine& name, wpi::Logger& logger,
+                    Notifier& notifier, Telemetry& telemetry,
+                    const wpi::Twine& path);
+  ~RecordingSinkImpl() override;
+
+  bool IsOpen() const { return m_writer.IsOpen(); }
+
+  void Stop();
+
+ private:
+  // A copy of a frame waiting to be written
+  struct Buffer {
+    RecordingFrameHeader header;
+    std::vector<char> data;
+  };
+
+  // Copies each new frame from the source into a free buffer
+  void GrabThreadMain();
+  // Writes buffered frames to the file
+  void WriteThreadMain();
+
+  RecordingWriter m_writer;
+
+  // Buffers are allocated up front and recycled between the two threads;
+  // if the writer falls behind, frames are dropped rather than queued.
+  wpi::mutex m_bufferMutex;
+  wpi::condition_variable m_bufferCv;
+  std::vector<std::unique_ptr<Buffer>> m_freeBuffers;
+  std::deque<std::unique_ptr<Buffer>> m_writeQueue;
+
+  std::atomic_bool m_active{false};  // set to false to terminate threads
+  std::thread m_grabThread;
+  std::thread m_writeThread;
+};
+
+}  // namespace cs
+
+#endif  // CSCORE_RECORDINGSINKIMPL_H_
@@ -4,11 +4,14 @@
 
 #include "SinkImpl.h"
 
+#include <algorithm>
+
 #include <wpi/json.h>
 
 #include "Instance.h"
 #include "Notifier.h"
 #include "SourceImpl.h"
+#include "Telemetry.h"
 
 using namespace cs;
 
@@ -17,6 +20,7 @@ SinkImpl::SinkImpl(const wpi::Twine& name, wpi::Logger& logger,
     : m_logger(logger),
       m_notifier(notifier),
       m_telemetry(telemetry),
+      m_telemetryCounters{std::make_shared<TelemetryCounters>()},
       m_name{name.str()} {}
 
 SinkImpl::~SinkImpl() {
@@ -121,6 +125,19 @@ wpi::StringRef SinkImpl::GetError(wpi::SmallVectorImpl<char>& buf) const {
   return wpi::StringRef{buf.data(), buf.size()};
 }
 
+void SinkImpl::SetROI(int x, int y, int width, int height) {
+  std::scoped_lock lock(m_mutex);
+  m_region.x = (std::max)(x, 0);
+  m_region.y = (std::max)(y, 0);
+  m_region.width = (std::max)(width, 0);
+  m_region.height = (std::max)(height, 0);
+}
+
+void SinkImpl::SetDecimation(int decimation) {
+  std::scoped_lock lock(m_mutex);
+  m_region.decimation = (std::max)(decimation, 1);
+}
+
 bool SinkImpl::SetConfigJson(wpi::StringRef config, CS_Status* status) {
   wpi::json j;
   try {
@@ -194,4 +211,26 @@ void SinkImpl::UpdatePropertyValue(int property, bool setString, int value,
   }
 }
 
+void SinkImpl::RecordFrameTelemetry(const SourceImpl& source,
+                                    const Frame& frame) {
+  source.GetTelemetryCounters()->RecordLatency(CS_SOURCE_CAPTURE_LATENCY,
+                                               frame.GetTime());
+  // sequence numbers are per source
+  if (&source != m_lastFrameSource) {
+    m_lastFrameSource = &source;
+    m_lastFrameSequence = 0;
+  }
+  m_telemetryCounters->RecordDropped(frame.GetSequence(),
+                                     &m_lastFrameSequence);
+}
+
+Image* SinkImpl::GetGrabImage(Frame& frame, int width, int height,
+                              VideoMode::PixelFormat pixelFormat) {
+  Frame::Region region = GetRegion();
+  if (region.decimation <= 1 && (region.width == 0 || region.height == 0)) {
+    return frame.GetImage(width, height, pixelFormat);
+  }
+  return frame.GetRegionImage(region, pixelFormat);
+}
+
 void SinkImpl::SetSourceImpl(std::shared_ptr<SourceImpl> source) {}
@@ -24,6 +24,7 @@ namespace cs {
 class Frame;
 class Notifier;
 class Telemetry;
+class TelemetryCounters;
 
 class SinkImpl : public PropertyContainer {
  public:
@@ -52,11 +53,24 @@ class SinkImpl : public PropertyContainer {
   std::string GetError() const;
   wpi::StringRef GetError(wpi::SmallVectorImpl<char>& buf) const;
 
+  // Region of interest and decimation applied to grabbed images (only used
+  // by image sinks).  A zero width or height means the whole image.
+  void SetROI(int x, int y, int width, int height);
+  void SetDecimation(int decimation);
+  Frame::Region GetRegion() const {
+    std::scoped_lock lock(m_mutex);
+    return m_region;
+  }
+
   bool SetConfigJson(wpi::StringRef config, CS_Status* status);
   virtual bool SetConfigJson(const wpi::json& config, CS_Status* status);
   std::string GetConfigJson(CS_Status* status);
   virtual wpi::json GetConfigJsonObject(CS_Status* status);
 
+  const std::shared_ptr<TelemetryCounters>& GetTelemetryCounters() const {
+    return m_telemetryCounters;
+  }
+
  protected:
   // PropertyContainer implementation
   void NotifyPropertyCreated(int propIndex, PropertyImpl& prop) override;
@@ -65,16 +79,30 @@ class SinkImpl : public PropertyContainer {
 
   virtual void SetSourceImpl(std::shared_ptr<SourceImpl> source);
 
+  // Records latency and dropped frame telemetry for a frame delivered by
+  // this sink.  Not thread-safe; call from a single grabbing thread.
+  void RecordFrameTelemetry(const SourceImpl& source, const Frame& frame);
+
+  // Gets the image to hand out for a frame: the region of interest (in
+  // pixelFormat) if one has been set, otherwise the whole frame at the given
+  // size.
+  Image* GetGrabImage(Frame& frame, int width, int height,
+                      VideoMode::PixelFormat pixelFormat);
+
  protected:
   wpi::Logger& m_logger;
   Notifier& m_notifier;
   Telemetry& m_telemetry;
+  std::shared_ptr<TelemetryCounters> m_telemetryCounters;
 
  private:
+  const SourceImpl* m_lastFrameSource{nullptr};
+  uint64_t m_lastFrameSequence{0};
   std::string m_name;
   std::string m_description;
   std::shared_ptr<SourceImpl> m_source;
   int m_enabledCount{0};
+  Frame::Region m_region;
 };
 
 }  // namespace cs
@@ -4,13 +4,21 @@
 
 #include "SourceImpl.h"
 
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
+#include <climits>
 #include <cstring>
 #include <memory>
 
 #include <wpi/json.h>
 #include <wpi/timestamp.h>
 
+#include "Instance.h"
 #include "Log.h"
 #include "Notifier.h"
 #include "Telemetry.h"
@@ -24,14 +32,20 @@ SourceImpl::SourceImpl(const wpi::Twine& name, wpi::Logger& logger,
     : m_logger(logger),
       m_notifier(notifier),
       m_telemetry(telemetry),
+      m_telemetryCounters{std::make_shared<TelemetryCounters>()},
       m_name{name.str()} {
-  m_frame = Frame{*this, wpi::StringRef{}, 0};
+  PublishFrame(Frame{*this, wpi::StringRef{}, 0});
 }
 
 SourceImpl::~SourceImpl() {
   // Wake up anyone who is waiting.  This also clears the current frame,
   // which is good because its destructor will call back into the class.
   Wakeup();
+  TakeFrame();
+  // Make sure no conversions are still using this source
+  if (m_submittedConversions) {
+    Instance::GetInstance().conversionPool.RemoveSource(*this);
+  }
   // Set a flag so ReleaseFrame() doesn't re-add them to m_framesAvail.
   // Put in a block so we destroy before the destructor ends.
   {
@@ -63,40 +77,173 @@ void SourceImpl::SetConnected(bool connected) {
 }
 
 uint64_t SourceImpl::GetCurFrameTime() {
-  std::unique_lock lock{m_frameMutex};
-  return m_frame.GetTime();
+  return LoadFrame().GetTime();
 }
 
 Frame SourceImpl::GetCurFrame() {
-  std::unique_lock lock{m_frameMutex};
-  return m_frame;
+  return LoadFrame();
 }
 
 Frame SourceImpl::GetNextFrame() {
-  std::unique_lock lock{m_frameMutex};
-  auto oldTime = m_frame.GetTime();
-  m_frameCv.wait(lock, [=] { return m_frame.GetTime() != oldTime; });
-  return m_frame;
+  uint32_t seq = m_frameSlotSeq.load(std::memory_order_acquire);
+  auto oldTime = LoadFrame().GetTime();
+  for (;;) {
+    WaitForFrame(seq, nullptr);
+    seq = m_frameSlotSeq.load(std::memory_order_acquire);
+    Frame frame = LoadFrame();
+    if (frame.GetTime() != oldTime) {
+      return frame;
+    }
+  }
 }
 
 Frame SourceImpl::GetNextFrame(double timeout) {
-  std::unique_lock lock{m_frameMutex};
-  auto oldTime = m_frame.GetTime();
-  if (!m_frameCv.wait_for(
-          lock, std::chrono::milliseconds(static_cast<int>(timeout * 1000)),
-          [=] { return m_frame.GetTime() != oldTime; })) {
-    m_frame = Frame{*this, "timed out getting frame", wpi::Now()};
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(static_cast<int>(timeout * 1000));
+  uint32_t seq = m_frameSlotSeq.load(std::memory_order_acquire);
+  auto oldTime = LoadFrame().GetTime();
+  for (;;) {
+    if (!WaitForFrame(seq, &deadline)) {
+      break;
+    }
+    seq = m_frameSlotSeq.load(std::memory_order_acquire);
+    Frame frame = LoadFrame();
+    if (frame.GetTime() != oldTime) {
+      return frame;
+    }
+  }
+  Frame frame{*this, "timed out getting frame", wpi::Now()};
+  PublishFrame(frame);
+  return frame;
+}
+
+Frame SourceImpl::GetNextFrame(Frame::Time lastFrameTime, double timeout) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(static_cast<int>(timeout * 1000));
+  for (;;) {
+    uint32_t seq = m_frameSlotSeq.load(std::memory_order_acquire);
+    Frame frame = LoadFrame();
+    if (frame.GetTime() != lastFrameTime || !WaitForFrame(seq, &deadline)) {
+      return frame;
+    }
   }
-  return m_frame;
 }
 
 void SourceImpl::Wakeup() {
+  PublishFrame(Frame{*this, wpi::StringRef{}, 0});
+}
+
+Frame SourceImpl::LoadFrame() const {
+  Frame frame;
+  for (;;) {
+    Frame::Impl* impl = m_frameSlot.load(std::memory_order_acquire);
+    if (!impl) {
+      return frame;
+    }
+    // Take a reference, unless the frame has already been released (it may
+    // have been replaced and its last reference dropped since the load).
+    // Frame impls are pooled and only freed when the source is destroyed, so
+    // touching a stale impl's refcount is safe.
+    int count = impl->refcount.load(std::memory_order_relaxed);
+    while (count != 0 && !impl->refcount.compare_exchange_weak(
+                             count, count + 1, std::memory_order_acquire,
+                             std::memory_order_relaxed)) {
+    }
+    if (count != 0) {
+      frame.m_impl = impl;
+      // If the slot still holds the impl we referenced, it's the current
+      // frame; otherwise drop the reference and try again.
+      if (m_frameSlot.load(std::memory_order_acquire) == impl) {
+        return frame;
+      }
+      frame = Frame{};
+    }
+  }
+}
+
+void SourceImpl::PublishFrame(Frame frame) {
+  Frame old;
   {
     std::scoped_lock lock{m_frameMutex};
-    m_frame = Frame{*this, wpi::StringRef{}, 0};
+    if (frame.m_impl && !frame.m_impl->images.empty()) {
+      frame.m_impl->sequence = ++m_frameSequence;
+    }
+    // the slot takes over the frame's reference
+    old.m_impl = m_frameSlot.exchange(frame.m_impl, std::memory_order_acq_rel);
+    frame.m_impl = nullptr;
+    m_frameSlotSeq.fetch_add(1, std::memory_order_seq_cst);
+  }
+  NotifyFrameWaiters();
+  // old frame (if this was its last reference) is released here
+}
+
+Frame SourceImpl::TakeFrame() {
+  Frame frame;
+  frame.m_impl = m_frameSlot.exchange(nullptr, std::memory_order_acq_rel);
+  return frame;
+}
+
+#ifdef __linux__
+bool SourceImpl::WaitForFrame(
+    uint32_t seq, const std::chrono::steady_clock::time_point* deadline) {
+  static_assert(sizeof(m_frameSlotSeq) == sizeof(uint32_t),
+                "futex requires a plain 32-bit word");
+  bool rv = true;
+  m_frameWaiters.fetch_add(1, std::memory_order_seq_cst);
+  while (m_frameSlotSeq.load(std::memory_order_seq_cst) == seq) {
+    struct timespec ts;
+    if (deadline) {
+      auto remaining = *deadline - std::chrono::steady_clock::now();
+      if (remaining <= std::chrono::steady_clock::duration::zero()) {
+        rv = false;
+        break;
+      }
+      auto ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(remaining)
+              .count();
+      ts.tv_sec = ns / 1000000000;
+      ts.tv_nsec = ns % 1000000000;
+    }
+    // returns immediately if the sequence has already changed
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_frameSlotSeq),
+            FUTEX_WAIT_PRIVATE, seq, deadline ? &ts : nullptr, nullptr, 0);
+  }
+  m_frameWaiters.fetch_sub(1, std::memory_order_relaxed);
+  return rv;
+}
+
+void SourceImpl::NotifyFrameWaiters() {
+  if (m_frameWaiters.load(std::memory_order_seq_cst) != 0) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_frameSlotSeq),
+            FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+  }
+}
+#else
+bool SourceImpl::WaitForFrame(
+    uint32_t seq, const std::chrono::steady_clock::time_point* deadline) {
+  std::unique_lock lock{m_frameWaitMutex};
+  m_frameWaiters.fetch_add(1, std::memory_order_seq_cst);
+  auto pred = [&] {
+    return m_frameSlotSeq.load(std::memory_order_seq_cst) != seq;
+  };
+  bool rv = true;
+  if (deadline) {
+    rv = m_frameCv.wait_until(lock, *deadline, pred);
+  } else {
+    m_frameCv.wait(lock, pred);
+  }
+  m_frameWaiters.fetch_sub(1, std::memory_order_relaxed);
+  return rv;
+}
+
+void SourceImpl::NotifyFrameWaiters() {
+  if (m_frameWaiters.load(std::memory_order_seq_cst) != 0) {
+    // synchronize with waiters between their check and wait
+    { std::scoped_lock lock{m_frameWaitMutex}; }
+    m_frameCv.notify_all();
   }
-  m_frameCv.notify_all();
 }
+#endif
 
 void SourceImpl::SetBrightness(int brightness, CS_Status* status) {
   *status = CS_INVALID_HANDLE;
@@ -181,6 +328,39 @@ bool SourceImpl::SetConfigJson(wpi::StringRef config, CS_Status* status) {
   return SetConfigJson(j, status);
 }
 
+static VideoMode::PixelFormat ParsePixelFormat(wpi::StringRef s) {
+  if (s.equals_lower("mjpeg")) {
+    return cs::VideoMode::kMJPEG;
+  } else if (s.equals_lower("yuyv")) {
+    return cs::VideoMode::kYUYV;
+  } else if (s.equals_lower("rgb565")) {
+    return cs::VideoMode::kRGB565;
+  } else if (s.equals_lower("bgr")) {
+    return cs::VideoMode::kBGR;
+  } else if (s.equals_lower("gray")) {
+    return cs::VideoMode::kGray;
+  } else {
+    return cs::VideoMode::kUnknown;
+  }
+}
+
+static wpi::StringRef GetPixelFormatName(int pixelFormat) {
+  switch (pixelFormat) {
+    case VideoMode::kMJPEG:
+      return "mjpeg";
+    case VideoMode::kYUYV:
+      return "yuyv";
+    case VideoMode::kRGB565:
+      return "rgb565";
+    case VideoMode::kBGR:
+      return "bgr";
+    case VideoMode::kGray:
+      return "gray";
+    default:
+      return {};
+  }
+}
+
 bool SourceImpl::SetConfigJson(const wpi::json& config, CS_Status* status) {
   VideoMode mode;
 
@@ -188,18 +368,8 @@ bool SourceImpl::SetConfigJson(const wpi::json& config, CS_Status* status) {
   if (config.count("pixel format") != 0) {
     try {
       auto str = config.at("pixel format").get<std::string>();
-      wpi::StringRef s(str);
-      if (s.equals_lower("mjpeg")) {
-        mode.pixelFormat = cs::VideoMode::kMJPEG;
-      } else if (s.equals_lower("yuyv")) {
-        mode.pixelFormat = cs::VideoMode::kYUYV;
-      } else if (s.equals_lower("rgb565")) {
-        mode.pixelFormat = cs::VideoMode::kRGB565;
-      } else if (s.equals_lower("bgr")) {
-        mode.pixelFormat = cs::VideoMode::kBGR;
-      } else if (s.equals_lower("gray")) {
-        mode.pixelFormat = cs::VideoMode::kGray;
-      } else {
+      mode.pixelFormat = ParsePixelFormat(str);
+      if (mode.pixelFormat == VideoMode::kUnknown) {
         SWARNING("SetConfigJson: could not understand pixel format value '"
                  << str << '\'');
       }
@@ -235,6 +405,18 @@ bool SourceImpl::SetConfigJson(const wpi::json& config, CS_Status* status) {
     }
   }
 
+  // image preallocation (applied when the video mode is set)
+  if (config.count("image preallocation") != 0) {
+    try {
+      int val = config.at("image preallocation").get<int>();
+      SINFO("SetConfigJson: setting image preallocation to " << val);
+      SetImagePreallocation(val);
+    } catch (const wpi::json::exception& e) {
+      SWARNING("SetConfigJson: could not read image preallocation: "
+               << e.what());
+    }
+  }
+
   // if all of video mode is set, use SetVideoMode, otherwise piecemeal it
   if (mode.pixelFormat != VideoMode::kUnknown && mode.width != 0 &&
       mode.height != 0 && mode.fps != 0) {
@@ -259,6 +441,38 @@ bool SourceImpl::SetConfigJson(const wpi::json& config, CS_Status* status) {
     }
   }
 
+  // precomputed images (replaces any existing)
+  if (config.count("precompute") != 0) {
+    try {
+      ClearPrecomputedImages();
+      for (auto&& t : config.at("precompute")) {
+        ConversionPool::Target target;
+        if (t.count("pixel format") != 0) {
+          target.pixelFormat =
+              ParsePixelFormat(t.at("pixel format").get<std::string>());
+        }
+        if (t.count("width") != 0 && t.count("height") != 0) {
+          target.width = t.at("width").get<int>();
+          target.height = t.at("height").get<int>();
+        }
+        if (t.count("quality") != 0) {
+          target.jpegQuality = t.at("quality").get<int>();
+        }
+        if (target.pixelFormat == VideoMode::kUnknown) {
+          SWARNING("SetConfigJson: could not understand precompute pixel "
+                   "format");
+          continue;
+        }
+        SINFO("SetConfigJson: precomputing " << target.width << "x"
+                                              << target.height << " type "
+                                              << target.pixelFormat);
+        AddPrecomputedImage(target);
+      }
+    } catch (const wpi::json::exception& e) {
+      SWARNING("SetConfigJson: could not read precompute: " << e.what());
+    }
+  }
+
   // brightness
   if (config.count("brightness") != 0) {
     try {
@@ -344,26 +558,7 @@ wpi::json SourceImpl::GetConfigJsonObject(CS_Status* status) {
   wpi::json j;
 
   // pixel format
-  wpi::StringRef pixelFormat;
-  switch (m_mode.pixelFormat) {
-    case VideoMode::kMJPEG:
-      pixelFormat = "mjpeg";
-      break;
-    case VideoMode::kYUYV:
-      pixelFormat = "yuyv";
-      break;
-    case VideoMode::kRGB565:
-      pixelFormat = "rgb565";
-      break;
-    case VideoMode::kBGR:
-      pixelFormat = "bgr";
-      break;
-    case VideoMode::kGray:
-      pixelFormat = "gray";
-      break;
-    default:
-      break;
-  }
+  wpi::StringRef pixelFormat = GetPixelFormatName(m_mode.pixelFormat);
   if (!pixelFormat.empty()) {
     j.emplace("pixel format", pixelFormat);
   }
@@ -383,6 +578,30 @@ wpi::json SourceImpl::GetConfigJsonObject(CS_Status* status) {
     j.emplace("fps", m_mode.fps);
   }
 
+  // image preallocation
+  if (int prealloc = m_imagePrealloc) {
+    j.emplace("image preallocation", prealloc);
+  }
+
+  // precomputed images
+  auto precompute = GetPrecomputedImages();
+  if (!precompute.empty()) {
+    wpi::json targets = wpi::json::array();
+    for (auto&& target : precompute) {
+      wpi::json t;
+      t.emplace("pixel format", GetPixelFormatName(target.pixelFormat));
+      if (target.width != 0 && target.height != 0) {
+        t.emplace("width", target.width);
+        t.emplace("height", target.height);
+      }
+      if (target.jpegQuality != -1) {
+        t.emplace("quality", target.jpegQuality);
+      }
+      targets.emplace_back(std::move(t));
+    }
+    j.emplace("precompute", std::move(targets));
+  }
+
   // TODO: output brightness, white balance, and exposure?
 
   // properties
@@ -403,31 +622,57 @@ std::vector<VideoMode> SourceImpl::EnumerateVideoModes(
   return m_videoModes;
 }
 
+// Size class key for the image pool.  Uncompressed images are keyed by
+// pixel format and resolution.  Compressed image size depends on content
+// rather than resolution, so all MJPEG images share a single class (which
+// also lets sources allocate them before the resolution is known).
+static uint64_t GetImageClass(VideoMode::PixelFormat pixelFormat, int width,
+                              int height) {
+  if (pixelFormat == VideoMode::kMJPEG) {
+    width = 0;
+    height = 0;
+  }
+  return (static_cast<uint64_t>(pixelFormat & 0xff) << 48) |
+         (static_cast<uint64_t>(width & 0xffffff) << 24) |
+         static_cast<uint64_t>(height & 0xffffff);
+}
+
+// Returns the size of an uncompressed image, or 0 if not known in advance.
+static size_t GetImageSize(const VideoMode& mode) {
+  size_t pixels = static_cast<size_t>(mode.width) * mode.height;
+  switch (mode.pixelFormat) {
+    case VideoMode::kYUYV:
+    case VideoMode::kRGB565:
+      return pixels * 2;
+    case VideoMode::kBGR:
+      return pixels * 3;
+    case VideoMode::kGray:
+      return pixels;
+    default:
+      return 0;
+  }
+}
+
 std::unique_ptr<Image> SourceImpl::AllocImage(
     VideoMode::PixelFormat pixelFormat, int width, int height, size_t size) {
   std::unique_ptr<Image> image;
   {
     std::scoped_lock lock{m_poolMutex};
-    // find the smallest existing frame that is at least big enough.
-    int found = -1;
-    for (size_t i = 0; i < m_imagesAvail.size(); ++i) {
-      // is it big enough?
-      if (m_imagesAvail[i] && m_imagesAvail[i]->capacity() >= size) {
-        // is it smaller than the last found?
-        if (found < 0 ||
-            m_imagesAvail[i]->capacity() < m_imagesAvail[found]->capacity()) {
-          // yes, update
-          found = i;
-        }
-      }
+    auto& cls = m_imagesAvail[GetImageClass(pixelFormat, width, height)];
+    cls.lastUse = ++m_imagePoolUse;
+    if (!cls.images.empty()) {
+      image = std::move(cls.images.back());
+      cls.images.pop_back();
+      --m_numImagesAvail;
     }
+  }
 
-    // if nothing found, allocate a new buffer
-    if (found < 0) {
-      image = std::make_unique<Image>(size);
-    } else {
-      image = std::move(m_imagesAvail[found]);
-    }
+  // if nothing found, allocate a new buffer
+  if (image) {
+    m_telemetryCounters->Add(CS_SOURCE_IMAGE_POOL_HITS, 1);
+  } else {
+    m_telemetryCounters->Add(CS_SOURCE_IMAGE_POOL_MISSES, 1);
+    image = std::make_unique<Image>(size);
   }
 
   // Initialize image
@@ -439,6 +684,38 @@ std::unique_ptr<Image> SourceImpl::AllocImage(
   return image;
 }
 
+void SourceImpl::SetImagePreallocation(int count) {
+  m_imagePrealloc = count;
+  VideoMode mode;
+  {
+    std::scoped_lock lock(m_mutex);
+    mode = m_mode;
+  }
+  PreallocateImages(mode);
+}
+
+void SourceImpl::PreallocateImages(const VideoMode& mode) {
+  size_t count = (std::min)(static_cast<size_t>(m_imagePrealloc.load()),
+                            kMaxImagesAvail);
+  size_t size = GetImageSize(mode);
+  if (count == 0 || size == 0) {
+    return;
+  }
+  auto pixelFormat = static_cast<VideoMode::PixelFormat>(mode.pixelFormat);
+  std::scoped_lock lock{m_poolMutex};
+  auto& cls = m_imagesAvail[GetImageClass(pixelFormat, mode.width,
+                                          mode.height)];
+  cls.lastUse = ++m_imagePoolUse;
+  while (cls.images.size() < count && m_numImagesAvail < kMaxImagesAvail) {
+    auto image = std::make_unique<Image>(size);
+    image->pixelFormat = pixelFormat;
+    image->width = mode.width;
+    image->height = mode.height;
+    cls.images.emplace_back(std::move(image));
+    ++m_numImagesAvail;
+  }
+}
+
 void SourceImpl::PutFrame(VideoMode::PixelFormat pixelFormat, int width,
                           int height, wpi::StringRef data, Frame::Time time) {
   auto image = AllocImage(pixelFormat, width, height, data.size());
@@ -455,28 +732,48 @@ void SourceImpl::PutFrame(VideoMode::PixelFormat pixelFormat, int width,
 
 void SourceImpl::PutFrame(std::unique_ptr<Image> image, Frame::Time time) {
   // Update telemetry
-  m_telemetry.RecordSourceFrames(*this, 1);
-  m_telemetry.RecordSourceBytes(*this, static_cast<int>(image->size()));
+  m_telemetryCounters->Add(CS_SOURCE_FRAMES_RECEIVED, 1);
+  m_telemetryCounters->Add(CS_SOURCE_BYTES_RECEIVED, image->size());
+  m_telemetryCounters->RecordLatency(CS_SOURCE_PUBLISH_LATENCY, time);
+
+  Frame frame{*this, std::move(image), time};
+  if (!m_hasPrecompute) {
+    // Update frame and signal listeners
+    PublishFrame(std::move(frame));
+    return;
+  }
 
-  // Update frame
+  // Update frame and signal listeners, then queue precomputed images
+  PublishFrame(frame);
+  wpi::SmallVector<ConversionPool::Target, 4> targets;
   {
-    std::scoped_lock lock{m_frameMutex};
-    m_frame = Frame{*this, std::move(image), time};
+    std::scoped_lock lock(m_precomputeMutex);
+    targets.append(m_precompute.begin(), m_precompute.end());
   }
+  m_submittedConversions = true;
+  Instance::GetInstance().conversionPool.Submit(*this, frame, targets);
+}
 
-  // Signal listeners
-  m_frameCv.notify_all();
+void SourceImpl::AddPrecomputedImage(const ConversionPool::Target& target) {
+  std::scoped_lock lock(m_precomputeMutex);
+  m_precompute.emplace_back(target);
+  m_hasPrecompute = true;
 }
 
-void SourceImpl::PutError(const wpi::Twine& msg, Frame::Time time) {
-  // Update frame
-  {
-    std::scoped_lock lock{m_frameMutex};
-    m_frame = Frame{*this, msg, time};
-  }
+void SourceImpl::ClearPrecomputedImages() {
+  std::scoped_lock lock(m_precomputeMutex);
+  m_precompute.clear();
+  m_hasPrecompute = false;
+}
 
-  // Signal listeners
-  m_frameCv.notify_all();
+std::vector<ConversionPool::Target> SourceImpl::GetPrecomputedImages() const {
+  std::scoped_lock lock(m_precomputeMutex);
+  return m_precompute;
+}
+
+void SourceImpl::PutError(const wpi::Twine& msg, Frame::Time time) {
+  // Update frame and signal listeners
+  PublishFrame(Frame{*this, msg, time});
 }
 
 void SourceImpl::NotifyPropertyCreated(int propIndex, PropertyImpl& prop) {
@@ -513,29 +810,36 @@ void SourceImpl::UpdatePropertyValue(int property, bool setString, int value,
 }
 
 void SourceImpl::ReleaseImage(std::unique_ptr<Image> image) {
+  // External images are released (not pooled) when destroyed
+  if (image->IsExternal()) {
+    return;
+  }
   std::scoped_lock lock{m_poolMutex};
   if (m_destroyFrames) {
     return;
   }
-  // Return the frame to the pool.  First try to find an empty slot, otherwise
-  // add it to the end.
-  auto it = std::find(m_imagesAvail.begin(), m_imagesAvail.end(), nullptr);
-  if (it != m_imagesAvail.end()) {
-    *it = std::move(image);
-  } else if (m_imagesAvail.size() > kMaxImagesAvail) {
-    // Replace smallest buffer; don't need to check for null because the above
-    // find would have found it.
-    auto it2 = std::min_element(
-        m_imagesAvail.begin(), m_imagesAvail.end(),
-        [](const std::unique_ptr<Image>& a, const std::unique_ptr<Image>& b) {
-          return a->capacity() < b->capacity();
-        });
-    if ((*it2)->capacity() < image->capacity()) {
-      *it2 = std::move(image);
+  // If the pool is full, evict an image from the least recently used class
+  // (dropping classes that have emptied out along the way).
+  if (m_numImagesAvail >= kMaxImagesAvail) {
+    ImageClass* lru = nullptr;
+    for (auto it = m_imagesAvail.begin(), end = m_imagesAvail.end();
+         it != end; ++it) {
+      auto& cls = it->getSecond();
+      if (cls.images.empty()) {
+        m_imagesAvail.erase(it);
+      } else if (!lru || cls.lastUse < lru->lastUse) {
+        lru = &cls;
+      }
+    }
+    if (lru) {
+      lru->images.pop_back();
+      --m_numImagesAvail;
     }
-  } else {
-    m_imagesAvail.emplace_back(std::move(image));
   }
+  // Return the image to the pool
+  m_imagesAvail[GetImageClass(image->pixelFormat, image->width, image->height)]
+      .images.emplace_back(std::move(image));
+  ++m_numImagesAvail;
 }
 
 std::unique_ptr<Frame::Impl> SourceImpl::AllocFrameImpl() {
@@ -6,21 +6,26 @@
 #define CSCORE_SOURCEIMPL_H_
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include <wpi/ArrayRef.h>
+#include <wpi/DenseMap.h>
 #include <wpi/Logger.h>
 #include <wpi/StringRef.h>
 #include <wpi/Twine.h>
 #include <wpi/condition_variable.h>
 #include <wpi/mutex.h>
 
+#include "ConversionPool.h"
 #include "Frame.h"
 #include "Handle.h"
 #include "Image.h"
+#include "JpegDecoder.h"
+#include "JpegEncoder.h"
 #include "PropertyContainer.h"
 #include "cscore_cpp.h"
 
@@ -32,6 +37,7 @@ namespace cs {
 
 class Notifier;
 class Telemetry;
+class TelemetryCounters;
 
 class SourceImpl : public PropertyContainer {
   friend class Frame;
@@ -104,6 +110,12 @@ class SourceImpl : public PropertyContainer {
   // timeout in seconds).  If timeout expires, returns empty frame.
   Frame GetNextFrame(double timeout);
 
+  // Blocking function that waits for a frame with a time different from
+  // lastFrameTime and returns it (with timeout in seconds).  Unlike
+  // GetNextFrame(double), a timeout does not replace the current frame with an
+  // error frame; the current frame is simply returned instead.
+  Frame GetNextFrame(Frame::Time lastFrameTime, double timeout);
+
   // Force a wakeup of all GetNextFrame() callers by sending an empty frame.
   void Wakeup();
 
@@ -138,11 +150,33 @@ class SourceImpl : public PropertyContainer {
   std::unique_ptr<Image> AllocImage(VideoMode::PixelFormat pixelFormat,
                                     int width, int height, size_t size);
 
+  // Sets the number of images to preallocate in the image pool when the
+  // video mode is set (0 to disable).  Only uncompressed formats are
+  // preallocated.
+  void SetImagePreallocation(int count);
+  int GetImagePreallocation() const { return m_imagePrealloc; }
+
+  // Derived images to precompute (on the instance conversion pool) for each
+  // new frame.
+  void AddPrecomputedImage(const ConversionPool::Target& target);
+  void ClearPrecomputedImages();
+  std::vector<ConversionPool::Target> GetPrecomputedImages() const;
+
+  JpegEncoder& GetJpegEncoder() { return m_jpegEncoder; }
+  JpegDecoder& GetJpegDecoder() { return m_jpegDecoder; }
+
+  const std::shared_ptr<TelemetryCounters>& GetTelemetryCounters() const {
+    return m_telemetryCounters;
+  }
+
  protected:
   void NotifyPropertyCreated(int propIndex, PropertyImpl& prop) override;
   void UpdatePropertyValue(int property, bool setString, int value,
                            const wpi::Twine& valueStr) override;
 
+  // Fills the image pool for mode (see SetImagePreallocation()).
+  void PreallocateImages(const VideoMode& mode);
+
   void PutFrame(VideoMode::PixelFormat pixelFormat, int width, int height,
                 wpi::StringRef data, Frame::Time time);
   void PutFrame(std::unique_ptr<Image> image, Frame::Time time);
@@ -163,35 +197,75 @@ class SourceImpl : public PropertyContainer {
   wpi::Logger& m_logger;
   Notifier& m_notifier;
   Telemetry& m_telemetry;
+  std::shared_ptr<TelemetryCounters> m_telemetryCounters;
 
  private:
   void ReleaseImage(std::unique_ptr<Image> image);
   std::unique_ptr<Frame::Impl> AllocFrameImpl();
   void ReleaseFrameImpl(std::unique_ptr<Frame::Impl> data);
 
+  // Latest-frame mailbox.  Readers take a reference to the current frame
+  // without locking; publishers replace it and wake any waiters.
+  Frame LoadFrame() const;
+  void PublishFrame(Frame frame);
+  Frame TakeFrame();
+  // Waits for m_frameSlotSeq to change from seq.  Returns false on timeout.
+  bool WaitForFrame(uint32_t seq,
+                    const std::chrono::steady_clock::time_point* deadline);
+  void NotifyFrameWaiters();
+
   std::string m_name;
   std::string m_description;
 
   std::atomic_int m_strategy{CS_CONNECTION_AUTO_MANAGE};
   std::atomic_int m_numSinksEnabled{0};
 
+  // Serializes frame publishers; readers never take this lock.
   wpi::mutex m_frameMutex;
+  // Sequence number of the last published frame (protected by m_frameMutex)
+  uint64_t m_frameSequence{0};
+
+  // Incremented each time the current frame is replaced.  Waiters block on
+  // this value changing (with a futex on Linux).
+  std::atomic<uint32_t> m_frameSlotSeq{0};
+  std::atomic_int m_frameWaiters{0};
+#ifndef __linux__
+  wpi::mutex m_frameWaitMutex;
   wpi::condition_variable m_frameCv;
+#endif
 
   bool m_destroyFrames{false};
 
   // Pool of frames/images to reduce malloc traffic.
   wpi::mutex m_poolMutex;
   std::vector<std::unique_ptr<Frame::Impl>> m_framesAvail;
-  std::vector<std::unique_ptr<Image>> m_imagesAvail;
+  // Free images by size class (see GetImageClass()).  Images within a class
+  // are interchangeable, so allocation and release are O(1).
+  struct ImageClass {
+    std::vector<std::unique_ptr<Image>> images;
+    uint64_t lastUse = 0;
+  };
+  wpi::DenseMap<uint64_t, ImageClass> m_imagesAvail;
+  size_t m_numImagesAvail = 0;
+  uint64_t m_imagePoolUse = 0;
+  std::atomic_int m_imagePrealloc{0};
+
+  // Precomputed image targets (protected by m_precomputeMutex)
+  mutable wpi::mutex m_precomputeMutex;
+  std::vector<ConversionPool::Target> m_precompute;
+  std::atomic_bool m_hasPrecompute{false};
+  // Set once any conversions have been submitted for this source
+  std::atomic_bool m_submittedConversions{false};
 
   std::atomic_bool m_connected{false};
 
-  // Most recent frame (returned to callers of GetNextFrame)
-  // Access protected by m_frameMutex.
-  // MUST be located below m_poolMutex as the Frame destructor calls back
-  // into SourceImpl::ReleaseImage, which locks m_poolMutex.
-  Frame m_frame;
+  // Reusable JPEG compressors and decompressors for frame conversions
+  JpegEncoder m_jpegEncoder;
+  JpegDecoder m_jpegDecoder;
+
+  // Most recent frame (returned to callers of GetNextFrame).  Holds one
+  // reference to the frame; replaced only by PublishFrame().
+  std::atomic<Frame::Impl*> m_frameSlot{nullptr};
 };
 
 }  // namespace cs
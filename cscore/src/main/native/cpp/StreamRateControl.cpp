@@ -0,0 +1,170 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "StreamRateControl.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <linux/sockios.h>
+#include <sys/ioctl.h>
+#elif defined(__APPLE__)
+#include <sys/socket.h>
+#endif
+
+using namespace cs;
+
+// Largest burst a token bucket allows, in seconds at its rate
+static constexpr double kBurstTime = 0.25;
+
+// Minimum time between quality reductions, in microseconds; this gives the
+// connection time to drain at the new setting
+static constexpr uint64_t kDecreaseInterval = 200000;
+
+// Minimum time between quality increases, in microseconds
+static constexpr uint64_t kIncreaseInterval = 1000000;
+
+// Time the connection must be clear before quality is increased, in
+// microseconds
+static constexpr uint64_t kClearInterval = 2000000;
+
+// Quality change per step
+static constexpr int kQualityStep = 5;
+
+void TokenBucket::SetRate(int64_t rate) {
+  if (rate == m_rate) {
+    return;
+  }
+  m_rate = rate;
+  m_tokens = rate * kBurstTime;
+  m_lastTime = 0;
+}
+
+bool TokenBucket::CanSend(uint64_t now) {
+  if (m_rate == 0) {
+    return true;
+  }
+  if (m_lastTime != 0 && now > m_lastTime) {
+    m_tokens = (std::min)(m_rate * kBurstTime,
+                          m_tokens + m_rate * (now - m_lastTime) / 1.0e6);
+  }
+  m_lastTime = now;
+  return m_tokens >= 0;
+}
+
+void StreamRateControl::Configure(int maxQuality, int64_t rate, bool adaptive,
+                                  std::shared_ptr<BandwidthLimiter> limiter) {
+  m_adaptive = adaptive;
+  m_maxQuality = std::clamp(maxQuality, 1, 100);
+  m_minQuality = (std::min)(kMinQuality, m_maxQuality);
+  m_quality = m_maxQuality;
+  m_scale = 1;
+  m_bucket.SetRate(rate);
+  m_limiter = std::move(limiter);
+}
+
+bool StreamRateControl::StartFrame(uint64_t now, size_t unsent) {
+  bool overBudget = !m_bucket.CanSend(now);
+  if (m_limiter && !m_limiter->CanSend(now)) {
+    overBudget = true;
+  }
+  if (!m_adaptive) {
+    return !overBudget;
+  }
+
+  // The connection isn't keeping up if much of the previous frame is still
+  // waiting when the next one is ready
+  bool congested = m_frameSize != 0 && unsent > m_frameSize / 2;
+  if (congested || overBudget) {
+    m_lastCongestion = now;
+    if (now - m_lastChange >= kDecreaseInterval) {
+      m_lastChange = now;
+      Decrease();
+    }
+  } else if (IsReduced() && now - m_lastCongestion >= kClearInterval &&
+             now - m_lastChange >= kIncreaseInterval) {
+    m_lastChange = now;
+    Increase();
+  }
+
+  // Queueing another frame behind a whole unsent one only adds latency
+  return !overBudget && (m_frameSize == 0 || unsent < m_frameSize);
+}
+
+void StreamRateControl::FrameSent(uint64_t now, size_t size) {
+  if (m_frameSize == 0) {
+    m_frameSize = size;
+  } else {
+    m_frameSize += (size - m_frameSize) / 4;
+  }
+  if (m_lastSendTime != 0 && now > m_lastSendTime) {
+    double interval = now - m_lastSendTime;
+    if (m_frameInterval == 0) {
+      m_frameInterval = interval;
+    } else {
+      m_frameInterval += (interval - m_frameInterval) / 8;
+    }
+  }
+  m_lastSendTime = now;
+
+  m_bucket.Consume(size);
+  if (m_limiter) {
+    m_limiter->Consume(size);
+  }
+}
+
+void StreamRateControl::Decrease() {
+  if (m_quality > m_minQuality) {
+    m_quality =
+        (std::max)(m_minQuality, m_quality - (std::max)(kQualityStep,
+                                                        m_quality / 4));
+  } else if (m_scale < kMaxScale) {
+    // A quarter of the pixels leaves room to raise quality again
+    m_scale *= 2;
+    m_quality = (m_minQuality + m_maxQuality) / 2;
+    m_frameSize /= 2;
+  }
+}
+
+void StreamRateControl::Increase() {
+  if (m_quality < m_maxQuality) {
+    if (HasHeadroom(1.25)) {
+      m_quality = (std::min)(m_maxQuality, m_quality + kQualityStep);
+    }
+  } else if (m_scale > 1 && HasHeadroom(2.0)) {
+    m_scale /= 2;
+    m_quality = (m_minQuality + m_maxQuality) / 2;
+    m_frameSize *= 2;
+  }
+}
+
+// Returns true if the current data rate, multiplied by factor, fits within
+// the bandwidth budgets
+bool StreamRateControl::HasHeadroom(double factor) const {
+  if (m_frameSize == 0 || m_frameInterval == 0) {
+    return true;
+  }
+  double rate = m_frameSize * 1.0e6 / m_frameInterval * factor;
+  if (m_bucket.GetRate() != 0 && rate > m_bucket.GetRate()) {
+    return false;
+  }
+  return !m_limiter || m_limiter->GetRate() == 0 ||
+         rate <= m_limiter->GetRate();
+}
+
+size_t cs::GetUnsentBytes(int sd) {
+#ifdef __linux__
+  int count = 0;
+  if (ioctl(sd, SIOCOUTQ, &count) == 0 && count > 0) {
+    return count;
+  }
+#elif defined(__APPLE__)
+  int count = 0;
+  socklen_t len = sizeof(count);
+  if (getsockopt(sd, SOL_SOCKET, SO_NWRITE, &count, &len) == 0 && count > 0) {
+    return count;
+  }
+#endif
+  return 0;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_STREAMRATECONTROL_H_
+#define CSCORE_STREAMRATECONTROL_H_
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <memory>
+
+#include <wpi/mutex.h>
+
+namespace cs {
+
+// Token bucket limiting a data rate.  Sending is allowed while the bucket is
+// not in debt; the size of each send is then taken out of the bucket, so a
+// large frame may overdraw it and delay the frames that follow instead.
+class TokenBucket {
+ public:
+  // Sets the rate in bytes per second (0 for unlimited)
+  void SetRate(int64_t rate);
+  int64_t GetRate() const { return m_rate; }
+
+  // Returns true if sending is allowed at time now (in the wpi::Now()
+  // timebase)
+  bool CanSend(uint64_t now);
+
+  // Takes size bytes out of the bucket
+  void Consume(size_t size) { m_tokens -= size; }
+
+ private:
+  int64_t m_rate = 0;
+  double m_tokens = 0;
+  uint64_t m_lastTime = 0;
+};
+
+// Bandwidth cap shared by all streams of a server.  Thread safe.
+class BandwidthLimiter {
+ public:
+  void SetRate(int64_t rate) {
+    std::scoped_lock lock(m_mutex);
+    m_bucket.SetRate(rate);
+  }
+
+  int64_t GetRate() const {
+    std::scoped_lock lock(m_mutex);
+    return m_bucket.GetRate();
+  }
+
+  bool CanSend(uint64_t now) {
+    std::scoped_lock lock(m_mutex);
+    return m_bucket.CanSend(now);
+  }
+
+  void Consume(size_t size) {
+    std::scoped_lock lock(m_mutex);
+    m_bucket.Consume(size);
+  }
+
+ private:
+  mutable wpi::mutex m_mutex;
+  TokenBucket m_bucket;
+};
+
+// Congestion-aware rate control for one streaming client.
+//
+// Before each frame is sent, the bytes of previous frames that are still
+// unsent (in our own buffers and in the socket send buffer) are compared to
+// the typical frame size.  If the connection isn't keeping up, or the client
+// or server bandwidth budget is used up, the JPEG quality is stepped down,
+// and once it reaches its minimum the resolution is halved.  Settings are
+// restored one step at a time after the connection has been clear for a
+// while and the budget has room for them.  Frames are skipped while over
+// budget or while a whole frame is still waiting to be sent.
+//
+// Not thread safe; each client is served by one thread.
+class StreamRateControl {
+ public:
+  // Lowest JPEG quality used before reducing resolution
+  static constexpr int kMinQuality = 20;
+  // Largest resolution divisor
+  static constexpr int kMaxScale = 4;
+
+  // Sets the limits for the stream.
+  // @param maxQuality JPEG quality used when the connection is clear
+  // @param rate client bandwidth budget in bytes per second (0 for unlimited)
+  // @param adaptive if false, quality and resolution are never reduced, and
+  //                 frames are only skipped to stay within the budgets
+  // @param limiter server-wide bandwidth cap (may be null)
+  void Configure(int maxQuality, int64_t rate, bool adaptive,
+                 std::shared_ptr<BandwidthLimiter> limiter);
+
+  // Returns false if the stream needs no rate control at all
+  bool IsEnabled() const {
+    return m_adaptive || m_bucket.GetRate() != 0 ||
+           (m_limiter && m_limiter->GetRate() != 0);
+  }
+
+  // Decides whether to send a frame that is ready at time now (in the
+  // wpi::Now() timebase), and adjusts quality and resolution.
+  // @param unsent bytes of previous frames not yet sent
+  // @return false if the frame should be skipped
+  bool StartFrame(uint64_t now, size_t unsent);
+
+  // Called when a frame of size bytes has been handed to the connection
+  void FrameSent(uint64_t now, size_t size);
+
+  // JPEG quality to encode the next frame with
+  int GetQuality() const { return m_quality; }
+
+  // Resolution divisor for the next frame (1, 2, or 4)
+  int GetScale() const { return m_scale; }
+
+  // Returns true if quality or resolution is currently reduced
+  bool IsReduced() const { return m_quality < m_maxQuality || m_scale > 1; }
+
+ private:
+  void Decrease();
+  void Increase();
+  bool HasHeadroom(double factor) const;
+
+  bool m_adaptive = false;
+  int m_maxQuality = 80;
+  int m_minQuality = kMinQuality;
+  int m_quality = 80;
+  int m_scale = 1;
+  TokenBucket m_bucket;
+  std::shared_ptr<BandwidthLimiter> m_limiter;
+
+  // Averages of the size of (and time between) frames sent
+  double m_frameSize = 0;
+  double m_frameInterval = 0;
+  uint64_t m_lastSendTime = 0;
+
+  uint64_t m_lastChange = 0;
+  uint64_t m_lastCongestion = 0;
+};
+
+// Returns the number of bytes in a socket's send buffer that have not yet
+// been sent or acknowledged, or 0 if this isn't available on this platform.
+size_t GetUnsentBytes(int sd);
+
+}  // namespace cs
+
+#endif  // CSCORE_STREAMRATECONTROL_H_
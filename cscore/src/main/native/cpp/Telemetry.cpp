@@ -10,23 +10,105 @@
 #include <wpi/DenseMap.h>
 #include <wpi/timestamp.h>
 
-#include "Handle.h"
-#include "Instance.h"
 #include "Notifier.h"
-#include "SourceImpl.h"
 #include "cscore_cpp.h"
 
 using namespace cs;
 
+// Kinds whose value is an average of samples rather than a total
+static bool IsAverageKind(int kind) {
+  switch (kind) {
+    case CS_SOURCE_BYTES_RECEIVED:
+    case CS_SOURCE_FRAMES_RECEIVED:
+    case CS_SINK_FRAMES_DROPPED:
+    case CS_SOURCE_IMAGE_POOL_HITS:
+    case CS_SOURCE_IMAGE_POOL_MISSES:
+    case CS_SINK_BYTES_SENT:
+      return false;
+    default:
+      return true;
+  }
+}
+
+void TelemetryCounters::Record(CS_TelemetryKind kind, int64_t value) {
+  int bucket = 0;
+  for (uint64_t v = value > 0 ? value : 0; v != 0 && bucket < kNumBuckets - 1;
+       v >>= 1) {
+    ++bucket;
+  }
+  auto& stat = m_stats[kind];
+  stat.count.fetch_add(1, std::memory_order_relaxed);
+  stat.sum.fetch_add(value, std::memory_order_relaxed);
+  stat.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void TelemetryCounters::RecordLatency(CS_TelemetryKind kind, uint64_t time) {
+  uint64_t now = wpi::Now();
+  if (time == 0 || now < time) {
+    return;
+  }
+  Record(kind, now - time);
+}
+
+void TelemetryCounters::RecordDropped(uint64_t sequence,
+                                      uint64_t* lastSequence) {
+  if (sequence == 0) {
+    return;  // error frame
+  }
+  if (*lastSequence != 0 && sequence > *lastSequence + 1) {
+    Record(CS_SINK_FRAMES_DROPPED, sequence - *lastSequence - 1);
+  }
+  *lastSequence = sequence;
+}
+
+TelemetryCounters::Snapshot TelemetryCounters::Collect(CS_TelemetryKind kind) {
+  Snapshot snapshot;
+  auto& stat = m_stats[kind];
+  snapshot.count = stat.count.exchange(0, std::memory_order_relaxed);
+  snapshot.sum = stat.sum.exchange(0, std::memory_order_relaxed);
+  if (IsAverageKind(kind) && snapshot.count == 0 && snapshot.sum != 0) {
+    // Record() ran between the two exchanges; its count is in the next
+    // period, so carry its sum over to go with it (counter kinds only have
+    // a sum, so are not affected)
+    stat.sum.fetch_add(snapshot.sum, std::memory_order_relaxed);
+    snapshot.sum = 0;
+  }
+  for (int i = 0; i < kNumBuckets; ++i) {
+    snapshot.buckets[i] =
+        stat.buckets[i].exchange(0, std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+bool TelemetryCounters::GetPublishedValue(CS_TelemetryKind kind,
+                                          const Snapshot& snapshot,
+                                          int64_t* value) {
+  if (!IsAverageKind(kind)) {
+    if (snapshot.count == 0 && snapshot.sum == 0) {
+      return false;
+    }
+    *value = snapshot.sum;
+  } else {
+    if (snapshot.count == 0) {
+      return false;
+    }
+    *value = snapshot.sum / snapshot.count;
+  }
+  return true;
+}
+
 class Telemetry::Thread : public wpi::SafeThread {
  public:
-  explicit Thread(Notifier& notifier) : m_notifier(notifier) {}
+  explicit Thread(Telemetry& telemetry) : m_telemetry(telemetry) {}
 
   void Main() override;
+  void Collect(bool save);
 
-  Notifier& m_notifier;
+  Telemetry& m_telemetry;
   wpi::DenseMap<std::pair<CS_Handle, int>, int64_t> m_user;
-  wpi::DenseMap<std::pair<CS_Handle, int>, int64_t> m_current;
+  wpi::DenseMap<std::pair<CS_Handle, int>,
+                std::array<int64_t, TelemetryCounters::kNumBuckets>>
+      m_histograms;
   double m_period = 0.0;
   double m_elapsed = 0.0;
   bool m_updated = false;
@@ -43,18 +125,57 @@ int64_t Telemetry::Thread::GetValue(CS_Handle handle, CS_TelemetryKind kind,
   return it->getSecond();
 }
 
+void Telemetry::Thread::Collect(bool save) {
+  // we don't keep around old values
+  m_user.clear();
+  m_histograms.clear();
+
+  std::scoped_lock lock(m_telemetry.m_registryMutex);
+  for (auto it = m_telemetry.m_registry.begin(),
+            end = m_telemetry.m_registry.end();
+       it != end; ++it) {
+    auto counters = it->getSecond().lock();
+    if (!counters) {
+      m_telemetry.m_registry.erase(it);
+      continue;
+    }
+    CS_Handle handle = it->getFirst();
+    for (int kind = 1; kind < TelemetryCounters::kNumKinds; ++kind) {
+      auto snapshot = counters->Collect(static_cast<CS_TelemetryKind>(kind));
+      int64_t value;
+      if (!save || !TelemetryCounters::GetPublishedValue(
+                       static_cast<CS_TelemetryKind>(kind), snapshot, &value)) {
+        continue;
+      }
+      auto key = std::make_pair(handle, kind);
+      m_user[key] = value;
+      if (snapshot.count != 0) {
+        m_histograms[key] = snapshot.buckets;
+      }
+    }
+  }
+}
+
 Telemetry::~Telemetry() = default;
 
 void Telemetry::Start() {
-  m_owner.Start(m_notifier);
+  m_owner.Start(*this);
 }
 
 void Telemetry::Stop() {
   m_owner.Stop();
 }
 
+void Telemetry::Register(CS_Handle handle,
+                         std::shared_ptr<TelemetryCounters> counters) {
+  std::scoped_lock lock(m_registryMutex);
+  m_registry[handle] = counters;
+}
+
 void Telemetry::Thread::Main() {
   std::unique_lock lock(m_mutex);
+  // discard anything recorded before telemetry was enabled
+  Collect(false);
   auto prevTime = std::chrono::steady_clock::now();
   while (m_active) {
     double period = m_period;
@@ -75,15 +196,13 @@ void Telemetry::Thread::Main() {
       continue;
     }
 
-    // move to user and clear current, as we don't keep around old values
-    m_user = std::move(m_current);
-    m_current.clear();
+    Collect(true);
     auto curTime = std::chrono::steady_clock::now();
     m_elapsed = std::chrono::duration<double>(curTime - prevTime).count();
     prevTime = curTime;
 
     // notify
-    m_notifier.NotifyTelemetryUpdated();
+    m_telemetry.m_notifier.NotifyTelemetryUpdated();
   }
 }
 
@@ -125,30 +244,29 @@ double Telemetry::GetAverageValue(CS_Handle handle, CS_TelemetryKind kind,
     *status = CS_TELEMETRY_NOT_ENABLED;
     return 0;
   }
+  if (IsAverageKind(kind)) {
+    // already an average
+    return thr->GetValue(handle, kind, status);
+  }
   if (thr->m_elapsed == 0) {
     return 0.0;
   }
   return thr->GetValue(handle, kind, status) / thr->m_elapsed;
 }
 
-void Telemetry::RecordSourceBytes(const SourceImpl& source, int quantity) {
+std::vector<int64_t> Telemetry::GetHistogram(CS_Handle handle,
+                                             CS_TelemetryKind kind,
+                                             CS_Status* status) {
   auto thr = m_owner.GetThread();
   if (!thr) {
-    return;
+    *status = CS_TELEMETRY_NOT_ENABLED;
+    return {};
   }
-  auto handleData = Instance::GetInstance().FindSource(source);
-  thr->m_current[std::make_pair(Handle{handleData.first, Handle::kSource},
-                                static_cast<int>(CS_SOURCE_BYTES_RECEIVED))] +=
-      quantity;
-}
-
-void Telemetry::RecordSourceFrames(const SourceImpl& source, int quantity) {
-  auto thr = m_owner.GetThread();
-  if (!thr) {
-    return;
+  auto it = thr->m_histograms.find(
+      std::make_pair(handle, static_cast<int>(kind)));
+  if (it == thr->m_histograms.end()) {
+    *status = CS_EMPTY_VALUE;
+    return {};
   }
-  auto handleData = Instance::GetInstance().FindSource(source);
-  thr->m_current[std::make_pair(Handle{handleData.first, Handle::kSource},
-                                static_cast<int>(CS_SOURCE_FRAMES_RECEIVED))] +=
-      quantity;
+  return {it->getSecond().begin(), it->getSecond().end()};
 }
@@ -5,14 +5,68 @@
 #ifndef CSCORE_TELEMETRY_H_
 #define CSCORE_TELEMETRY_H_
 
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <wpi/DenseMap.h>
 #include <wpi/SafeThread.h>
+#include <wpi/mutex.h>
 
 #include "cscore_cpp.h"
 
 namespace cs {
 
 class Notifier;
-class SourceImpl;
+
+// Statistics for a single source or sink.  The owner records into this
+// directly using relaxed atomics (no locks and no handle lookup); the
+// telemetry thread collects and resets the values at the end of each period.
+class TelemetryCounters {
+ public:
+  // Histogram buckets: bucket 0 counts values <= 0, bucket i counts values
+  // in [2^(i-1), 2^i), and the last bucket also counts anything larger.
+  static constexpr int kNumBuckets = 32;
+  static constexpr int kNumKinds = CS_SINK_BYTES_SENT + 1;
+
+  struct Snapshot {
+    int64_t count = 0;
+    int64_t sum = 0;
+    std::array<int64_t, kNumBuckets> buckets{};
+  };
+
+  // Adds to a counter (e.g. bytes received)
+  void Add(CS_TelemetryKind kind, int64_t quantity) {
+    m_stats[kind].sum.fetch_add(quantity, std::memory_order_relaxed);
+  }
+
+  // Records a histogram sample (e.g. a time in microseconds)
+  void Record(CS_TelemetryKind kind, int64_t value);
+
+  // Records the latency from time (in the wpi::Now() timebase) to now
+  void RecordLatency(CS_TelemetryKind kind, uint64_t time);
+
+  // Records frames skipped between the last frame sequence number seen by
+  // a sink and the current one, and updates lastSequence
+  void RecordDropped(uint64_t sequence, uint64_t* lastSequence);
+
+  // Returns and resets the accumulated values for a kind
+  Snapshot Collect(CS_TelemetryKind kind);
+
+  // Gets the value to publish for a snapshot: the total for counter kinds,
+  // or the average for sampled kinds.  Returns false if there is none.
+  static bool GetPublishedValue(CS_TelemetryKind kind,
+                                const Snapshot& snapshot, int64_t* value);
+
+ private:
+  struct Stat {
+    std::atomic<int64_t> count{0};
+    std::atomic<int64_t> sum{0};
+    std::array<std::atomic<int64_t>, kNumBuckets> buckets{};
+  };
+  std::array<Stat, kNumKinds> m_stats;
+};
 
 class Telemetry {
   friend class TelemetryTest;
@@ -24,20 +78,24 @@ class Telemetry {
   void Start();
   void Stop();
 
+  // Registers the counters for a source or sink handle
+  void Register(CS_Handle handle, std::shared_ptr<TelemetryCounters> counters);
+
   // User interface
   void SetPeriod(double seconds);
   double GetElapsedTime();
   int64_t GetValue(CS_Handle handle, CS_TelemetryKind kind, CS_Status* status);
   double GetAverageValue(CS_Handle handle, CS_TelemetryKind kind,
                          CS_Status* status);
-
-  // Telemetry events
-  void RecordSourceBytes(const SourceImpl& source, int quantity);
-  void RecordSourceFrames(const SourceImpl& source, int quantity);
+  std::vector<int64_t> GetHistogram(CS_Handle handle, CS_TelemetryKind kind,
+                                    CS_Status* status);
 
  private:
   Notifier& m_notifier;
 
+  wpi::mutex m_registryMutex;
+  wpi::DenseMap<CS_Handle, std::weak_ptr<TelemetryCounters>> m_registry;
+
   class Thread;
   wpi::SafeThreadOwner<Thread> m_owner;
 };
@@ -52,6 +52,15 @@ char* CS_GetUsbCameraPath(CS_Source source, CS_Status* status) {
   return ConvertToC(cs::GetUsbCameraPath(source, status));
 }
 
+void CS_SetUsbCameraSharedCapture(CS_Bool enabled, CS_Status* status) {
+  cs::SetUsbCameraSharedCapture(enabled, status);
+}
+
+void CS_SetUsbCameraCaptureAffinity(const int* cpus, int count,
+                                    CS_Status* status) {
+  cs::SetUsbCameraCaptureAffinity(wpi::makeArrayRef(cpus, count), status);
+}
+
 CS_UsbCameraInfo* CS_GetUsbCameraInfo(CS_Source source, CS_Status* status) {
   auto info = cs::GetUsbCameraInfo(source, status);
   if (*status != CS_OK) {
@@ -219,6 +219,20 @@ char* CS_GetSourceConfigJson(CS_Source source, CS_Status* status) {
   return cs::ConvertToC(cs::GetSourceConfigJson(source, status));
 }
 
+void CS_AddSourcePrecomputedImage(CS_Source source,
+                                  enum CS_PixelFormat pixelFormat, int width,
+                                  int height, int jpegQuality,
+                                  CS_Status* status) {
+  cs::AddSourcePrecomputedImage(
+      source,
+      static_cast<cs::VideoMode::PixelFormat>(static_cast<int>(pixelFormat)),
+      width, height, jpegQuality, status);
+}
+
+void CS_ClearSourcePrecomputedImages(CS_Source source, CS_Status* status) {
+  cs::ClearSourcePrecomputedImages(source, status);
+}
+
 CS_VideoMode* CS_EnumerateSourceVideoModes(CS_Source source, int* count,
                                            CS_Status* status) {
   auto vec = cs::EnumerateSourceVideoModes(source, status);
@@ -436,6 +450,20 @@ double CS_GetTelemetryAverageValue(CS_Handle handle, CS_TelemetryKind kind,
   return cs::GetTelemetryAverageValue(handle, kind, status);
 }
 
+int64_t* CS_GetTelemetryHistogram(CS_Handle handle, CS_TelemetryKind kind,
+                                  int* count, CS_Status* status) {
+  auto vec = cs::GetTelemetryHistogram(handle, kind, status);
+  int64_t* out =
+      static_cast<int64_t*>(wpi::safe_malloc(vec.size() * sizeof(int64_t)));
+  *count = vec.size();
+  std::copy(vec.begin(), vec.end(), out);
+  return out;
+}
+
+void CS_FreeTelemetryHistogram(int64_t* histogram, int count) {
+  std::free(histogram);
+}
+
 void CS_SetLogger(CS_LogFunc func, unsigned int min_level) {
   cs::SetLogger(func, min_level);
 }
@@ -545,7 +573,8 @@ void CS_AllocateRawFrameData(CS_RawFrame* frame, int requestedSize) {
   if (frame->dataLength >= requestedSize) {
     return;
   }
-  if (frame->data) {
+  // data with a zero dataLength is not owned by the frame
+  if (frame->data && frame->dataLength != 0) {
     frame->data =
         static_cast<char*>(wpi::safe_realloc(frame->data, requestedSize));
   } else {
@@ -556,7 +585,10 @@ void CS_AllocateRawFrameData(CS_RawFrame* frame, int requestedSize) {
 
 void CS_FreeRawFrameData(CS_RawFrame* frame) {
   if (frame->data) {
-    std::free(frame->data);
+    // data with a zero dataLength is not owned by the frame
+    if (frame->dataLength != 0) {
+      std::free(frame->data);
+    }
     frame->data = nullptr;
     frame->dataLength = 0;
   }
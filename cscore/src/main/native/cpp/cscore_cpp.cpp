@@ -387,6 +387,32 @@ wpi::json GetSourceConfigJsonObject(CS_Source source, CS_Status* status) {
   return data->source->GetConfigJsonObject(status);
 }
 
+void AddSourcePrecomputedImage(CS_Source source,
+                               VideoMode::PixelFormat pixelFormat, int width,
+                               int height, int jpegQuality,
+                               CS_Status* status) {
+  auto data = Instance::GetInstance().GetSource(source);
+  if (!data) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  ConversionPool::Target target;
+  target.pixelFormat = pixelFormat;
+  target.width = width;
+  target.height = height;
+  target.jpegQuality = jpegQuality;
+  data->source->AddPrecomputedImage(target);
+}
+
+void ClearSourcePrecomputedImages(CS_Source source, CS_Status* status) {
+  auto data = Instance::GetInstance().GetSource(source);
+  if (!data) {
+    *status = CS_INVALID_HANDLE;
+    return;
+  }
+  data->source->ClearPrecomputedImages();
+}
+
 std::vector<VideoMode> EnumerateSourceVideoModes(CS_Source source,
                                                  CS_Status* status) {
   auto data = Instance::GetInstance().GetSource(source);
@@ -832,6 +858,12 @@ double GetTelemetryAverageValue(CS_Handle handle, CS_TelemetryKind kind,
                                                            status);
 }
 
+std::vector<int64_t> GetTelemetryHistogram(CS_Handle handle,
+                                           CS_TelemetryKind kind,
+                                           CS_Status* status) {
+  return Instance::GetInstance().telemetry.GetHistogram(handle, kind, status);
+}
+
 //
 // Logging Functions
 //
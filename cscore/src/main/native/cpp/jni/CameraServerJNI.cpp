@@ -229,6 +229,9 @@ static void ReportError(JNIEnv* env, CS_Status status) {
     case CS_TELEMETRY_NOT_ENABLED:
       msg = "telemetry not enabled";
       break;
+    case CS_WRITE_FAILED:
+      msg = "write failed";
+      break;
     default: {
       wpi::raw_svector_ostream oss{msg};
       oss << "unknown error code=" << status;
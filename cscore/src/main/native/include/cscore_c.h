@@ -66,7 +66,8 @@ enum CS_StatusValue {
   CS_EMPTY_VALUE = -2006,
   CS_BAD_URL = -2007,
   CS_TELEMETRY_NOT_ENABLED = -2008,
-  CS_UNSUPPORTED_MODE = -2009
+  CS_UNSUPPORTED_MODE = -2009,
+  CS_WRITE_FAILED = -2010
 };
 
 /**
@@ -126,6 +127,7 @@ enum CS_SourceKind {
   CS_SOURCE_HTTP = 2,
   CS_SOURCE_CV = 4,
   CS_SOURCE_RAW = 8,
+  CS_SOURCE_FILE = 16,
 };
 
 /**
@@ -145,7 +147,17 @@ enum CS_SinkKind {
   CS_SINK_UNKNOWN = 0,
   CS_SINK_MJPEG = 2,
   CS_SINK_CV = 4,
-  CS_SINK_RAW = 8
+  CS_SINK_RAW = 8,
+  CS_SINK_RECORDING = 16
+};
+
+/**
+ * File source playback modes
+ */
+enum CS_PlaybackMode {
+  CS_PLAYBACK_ORIGINAL_RATE = 0,  // frames are played at the recorded rate
+  CS_PLAYBACK_MAX_RATE = 1,       // frames are played as fast as possible
+  CS_PLAYBACK_STEPPED = 2         // one frame is played per step call
 };
 
 /**
@@ -175,11 +187,35 @@ enum CS_EventKind {
 };
 
 /**
- * Telemetry kinds
+ * Telemetry kinds.  Latency, time, and backlog kinds are averaged over the
+ * samples in the telemetry period and also have a histogram; the other kinds
+ * are totals (frames dropped also has a histogram).
  */
 enum CS_TelemetryKind {
   CS_SOURCE_BYTES_RECEIVED = 1,
-  CS_SOURCE_FRAMES_RECEIVED = 2
+  CS_SOURCE_FRAMES_RECEIVED = 2,
+  /** Capture-to-sink latency, in microseconds */
+  CS_SOURCE_CAPTURE_LATENCY = 3,
+  /** Capture-to-publish latency, in microseconds */
+  CS_SOURCE_PUBLISH_LATENCY = 4,
+  /** Time to convert or encode to MJPEG, in microseconds */
+  CS_SOURCE_CONVERT_TIME_MJPEG = 5,
+  /** Time to convert to RGB565, in microseconds */
+  CS_SOURCE_CONVERT_TIME_RGB565 = 6,
+  /** Time to convert to BGR, in microseconds */
+  CS_SOURCE_CONVERT_TIME_BGR = 7,
+  /** Time to convert to grayscale, in microseconds */
+  CS_SOURCE_CONVERT_TIME_GRAY = 8,
+  /** Frames not delivered by a sink; histogram of consecutive drops */
+  CS_SINK_FRAMES_DROPPED = 9,
+  /** MJPEG client bytes left unsent when a new frame is ready */
+  CS_SINK_SEND_BACKLOG = 10,
+  /** Image allocations satisfied from the source's image pool */
+  CS_SOURCE_IMAGE_POOL_HITS = 11,
+  /** Image allocations that required a new buffer */
+  CS_SOURCE_IMAGE_POOL_MISSES = 12,
+  /** Bytes sent to MJPEG clients */
+  CS_SINK_BYTES_SENT = 13
 };
 
 /** Connection strategy */
@@ -276,6 +312,8 @@ CS_Source CS_CreateHttpCameraMulti(const char* name, const char** urls,
                                    CS_Status* status);
 CS_Source CS_CreateCvSource(const char* name, const CS_VideoMode* mode,
                             CS_Status* status);
+CS_Source CS_CreateFileSource(const char* name, const char* path,
+                              enum CS_PlaybackMode mode, CS_Status* status);
 /** @} */
 
 /**
@@ -312,6 +350,11 @@ CS_Bool CS_SetSourceFPS(CS_Source source, int fps, CS_Status* status);
 CS_Bool CS_SetSourceConfigJson(CS_Source source, const char* config,
                                CS_Status* status);
 char* CS_GetSourceConfigJson(CS_Source source, CS_Status* status);
+void CS_AddSourcePrecomputedImage(CS_Source source,
+                                  enum CS_PixelFormat pixelFormat, int width,
+                                  int height, int jpegQuality,
+                                  CS_Status* status);
+void CS_ClearSourcePrecomputedImages(CS_Source source, CS_Status* status);
 CS_VideoMode* CS_EnumerateSourceVideoModes(CS_Source source, int* count,
                                            CS_Status* status);
 CS_Sink* CS_EnumerateSourceSinks(CS_Source source, int* count,
@@ -343,6 +386,9 @@ void CS_SetCameraExposureManual(CS_Source source, int value, CS_Status* status);
 void CS_SetUsbCameraPath(CS_Source source, const char* path, CS_Status* status);
 char* CS_GetUsbCameraPath(CS_Source source, CS_Status* status);
 CS_UsbCameraInfo* CS_GetUsbCameraInfo(CS_Source source, CS_Status* status);
+void CS_SetUsbCameraSharedCapture(CS_Bool enabled, CS_Status* status);
+void CS_SetUsbCameraCaptureAffinity(const int* cpus, int count,
+                                    CS_Status* status);
 /** @} */
 
 /**
@@ -354,6 +400,8 @@ enum CS_HttpCameraKind CS_GetHttpCameraKind(CS_Source source,
 void CS_SetHttpCameraUrls(CS_Source source, const char** urls, int count,
                           CS_Status* status);
 char** CS_GetHttpCameraUrls(CS_Source source, int* count, CS_Status* status);
+void CS_SetHttpCameraSharedStreaming(CS_Source source, CS_Bool enabled,
+                                     CS_Status* status);
 /** @} */
 
 /**
@@ -374,6 +422,19 @@ void CS_SetSourceEnumPropertyChoices(CS_Source source, CS_Property property,
                                      CS_Status* status);
 /** @} */
 
+/**
+ * @defgroup cscore_filesource_cfunc File Source Functions
+ * @{
+ */
+void CS_SetFileSourcePlaybackMode(CS_Source source, enum CS_PlaybackMode mode,
+                                  CS_Status* status);
+enum CS_PlaybackMode CS_GetFileSourcePlaybackMode(CS_Source source,
+                                                  CS_Status* status);
+void CS_SetFileSourceLoop(CS_Source source, CS_Bool loop, CS_Status* status);
+void CS_StepFileSource(CS_Source source, CS_Status* status);
+void CS_SeekFileSource(CS_Source source, double time, CS_Status* status);
+/** @} */
+
 /**
  * @defgroup cscore_sink_create_cfunc Sink Creation Functions
  * @{
@@ -384,6 +445,8 @@ CS_Sink CS_CreateCvSink(const char* name, CS_Status* status);
 CS_Sink CS_CreateCvSinkCallback(const char* name, void* data,
                                 void (*processFrame)(void* data, uint64_t time),
                                 CS_Status* status);
+CS_Sink CS_CreateRecordingSink(const char* name, const char* path,
+                               CS_Status* status);
 /** @} */
 
 /**
@@ -424,6 +487,12 @@ void CS_SetSinkDescription(CS_Sink sink, const char* description,
                            CS_Status* status);
 char* CS_GetSinkError(CS_Sink sink, CS_Status* status);
 void CS_SetSinkEnabled(CS_Sink sink, CS_Bool enabled, CS_Status* status);
+void CS_SetSinkROI(CS_Sink sink, int x, int y, int width, int height,
+                   CS_Status* status);
+void CS_GetSinkROI(CS_Sink sink, int* x, int* y, int* width, int* height,
+                   CS_Status* status);
+void CS_SetSinkDecimation(CS_Sink sink, int decimation, CS_Status* status);
+int CS_GetSinkDecimation(CS_Sink sink, CS_Status* status);
 /** @} */
 
 /**
@@ -461,6 +530,10 @@ int64_t CS_GetTelemetryValue(CS_Handle handle, enum CS_TelemetryKind kind,
                              CS_Status* status);
 double CS_GetTelemetryAverageValue(CS_Handle handle, enum CS_TelemetryKind kind,
                                    CS_Status* status);
+int64_t* CS_GetTelemetryHistogram(CS_Handle handle,
+                                  enum CS_TelemetryKind kind, int* count,
+                                  CS_Status* status);
+void CS_FreeTelemetryHistogram(int64_t* histogram, int count);
 /** @} */
 
 /**
@@ -209,6 +209,8 @@ CS_Source CreateHttpCamera(const wpi::Twine& name,
                            CS_HttpCameraKind kind, CS_Status* status);
 CS_Source CreateCvSource(const wpi::Twine& name, const VideoMode& mode,
                          CS_Status* status);
+CS_Source CreateFileSource(const wpi::Twine& name, const wpi::Twine& path,
+                           CS_PlaybackMode mode, CS_Status* status);
 /** @} */
 
 /**
@@ -248,6 +250,11 @@ bool SetSourceConfigJson(CS_Source source, const wpi::json& config,
                          CS_Status* status);
 std::string GetSourceConfigJson(CS_Source source, CS_Status* status);
 wpi::json GetSourceConfigJsonObject(CS_Source source, CS_Status* status);
+void AddSourcePrecomputedImage(CS_Source source,
+                               VideoMode::PixelFormat pixelFormat, int width,
+                               int height, int jpegQuality,
+                               CS_Status* status);
+void ClearSourcePrecomputedImages(CS_Source source, CS_Status* status);
 std::vector<VideoMode> EnumerateSourceVideoModes(CS_Source source,
                                                  CS_Status* status);
 wpi::ArrayRef<CS_Sink> EnumerateSourceSinks(CS_Source source,
@@ -279,6 +286,8 @@ void SetCameraExposureManual(CS_Source source, int value, CS_Status* status);
 void SetUsbCameraPath(CS_Source, const wpi::Twine& path, CS_Status* status);
 std::string GetUsbCameraPath(CS_Source source, CS_Status* status);
 UsbCameraInfo GetUsbCameraInfo(CS_Source source, CS_Status* status);
+void SetUsbCameraSharedCapture(bool enabled, CS_Status* status);
+void SetUsbCameraCaptureAffinity(wpi::ArrayRef<int> cpus, CS_Status* status);
 /** @} */
 
 /**
@@ -289,6 +298,8 @@ CS_HttpCameraKind GetHttpCameraKind(CS_Source source, CS_Status* status);
 void SetHttpCameraUrls(CS_Source source, wpi::ArrayRef<std::string> urls,
                        CS_Status* status);
 std::vector<std::string> GetHttpCameraUrls(CS_Source source, CS_Status* status);
+void SetHttpCameraSharedStreaming(CS_Source source, bool enabled,
+                                  CS_Status* status);
 /** @} */
 
 /**
@@ -309,6 +320,18 @@ void SetSourceEnumPropertyChoices(CS_Source source, CS_Property property,
                                   CS_Status* status);
 /** @} */
 
+/**
+ * @defgroup cscore_filesource_func File Source Functions
+ * @{
+ */
+void SetFileSourcePlaybackMode(CS_Source source, CS_PlaybackMode mode,
+                               CS_Status* status);
+CS_PlaybackMode GetFileSourcePlaybackMode(CS_Source source, CS_Status* status);
+void SetFileSourceLoop(CS_Source source, bool loop, CS_Status* status);
+void StepFileSource(CS_Source source, CS_Status* status);
+void SeekFileSource(CS_Source source, double time, CS_Status* status);
+/** @} */
+
 /**
  * @defgroup cscore_sink_create_func Sink Creation Functions
  * @{
@@ -320,6 +343,8 @@ CS_Sink CreateCvSink(const wpi::Twine& name, CS_Status* status);
 CS_Sink CreateCvSinkCallback(const wpi::Twine& name,
                              std::function<void(uint64_t time)> processFrame,
                              CS_Status* status);
+CS_Sink CreateRecordingSink(const wpi::Twine& name, const wpi::Twine& path,
+                            CS_Status* status);
 
 /** @} */
 
@@ -369,6 +394,12 @@ std::string GetSinkError(CS_Sink sink, CS_Status* status);
 wpi::StringRef GetSinkError(CS_Sink sink, wpi::SmallVectorImpl<char>& buf,
                             CS_Status* status);
 void SetSinkEnabled(CS_Sink sink, bool enabled, CS_Status* status);
+void SetSinkROI(CS_Sink sink, int x, int y, int width, int height,
+                CS_Status* status);
+void GetSinkROI(CS_Sink sink, int* x, int* y, int* width, int* height,
+                CS_Status* status);
+void SetSinkDecimation(CS_Sink sink, int decimation, CS_Status* status);
+int GetSinkDecimation(CS_Sink sink, CS_Status* status);
 /** @} */
 
 /**
@@ -405,6 +436,15 @@ int64_t GetTelemetryValue(CS_Handle handle, CS_TelemetryKind kind,
                           CS_Status* status);
 double GetTelemetryAverageValue(CS_Handle handle, CS_TelemetryKind kind,
                                 CS_Status* status);
+
+/**
+ * Gets the histogram for a telemetry kind over the last telemetry period.
+ * Bucket 0 counts values <= 0, bucket i counts values in [2^(i-1), 2^i), and
+ * the last bucket also counts all larger values.
+ */
+std::vector<int64_t> GetTelemetryHistogram(CS_Handle handle,
+                                           CS_TelemetryKind kind,
+                                           CS_Status* status);
 /** @} */
 
 /**
@@ -65,6 +65,9 @@ void PutSourceFrame(CS_Source source, cv::Mat& image, CS_Status* status);
 uint64_t GrabSinkFrame(CS_Sink sink, cv::Mat& image, CS_Status* status);
 uint64_t GrabSinkFrameTimeout(CS_Sink sink, cv::Mat& image, double timeout,
                               CS_Status* status);
+uint64_t GrabSinkFrameDirect(CS_Sink sink, cv::Mat& image, CS_Status* status);
+uint64_t GrabSinkFrameTimeoutDirect(CS_Sink sink, cv::Mat& image,
+                                    double timeout, CS_Status* status);
 
 /**
  * A source for user code to provide OpenCV images as video frames.
@@ -150,7 +153,9 @@ class CvSink : public ImageSink {
    *
    * @return Frame time, or 0 on error (call GetError() to obtain the error
    *         message); the frame time is in the same time base as wpi::Now(),
-   *         and is in 1 us increments.
+   *         and is in 1 us increments.  If the camera driver provides
+   *         capture timestamps (e.g. V4L2), this is the time the frame was
+   *         captured rather than the time it was received.
    */
   uint64_t GrabFrame(cv::Mat& image, double timeout = 0.225) const;
 
@@ -160,9 +165,37 @@ class CvSink : public ImageSink {
    *
    * @return Frame time, or 0 on error (call GetError() to obtain the error
    *         message); the frame time is in the same time base as wpi::Now(),
-   *         and is in 1 us increments.
+   *         and is in 1 us increments.  If the camera driver provides
+   *         capture timestamps (e.g. V4L2), this is the time the frame was
+   *         captured rather than the time it was received.
    */
   uint64_t GrabFrameNoTimeout(cv::Mat& image) const;
+
+  /**
+   * Wait for the next frame and get the image without copying it.
+   * Times out (returning 0) after timeout seconds.
+   * The provided image will have three 8-bit channels stored in BGR order.
+   * It references the frame data directly, must be treated as read-only, and
+   * is only valid until the next call to grab a frame from this sink.
+   *
+   * @return Frame time, or 0 on error (call GetError() to obtain the error
+   *         message); the frame time is in the same time base as wpi::Now(),
+   *         and is in 1 us increments.
+   */
+  uint64_t GrabFrameDirect(cv::Mat& image, double timeout = 0.225) const;
+
+  /**
+   * Wait for the next frame and get the image without copying it.  May block
+   * forever.
+   * The provided image will have three 8-bit channels stored in BGR order.
+   * It references the frame data directly, must be treated as read-only, and
+   * is only valid until the next call to grab a frame from this sink.
+   *
+   * @return Frame time, or 0 on error (call GetError() to obtain the error
+   *         message); the frame time is in the same time base as wpi::Now(),
+   *         and is in 1 us increments.
+   */
+  uint64_t GrabFrameNoTimeoutDirect(cv::Mat& image) const;
 };
 
 inline CvSource::CvSource(const wpi::Twine& name, const VideoMode& mode) {
@@ -199,6 +232,16 @@ inline uint64_t CvSink::GrabFrameNoTimeout(cv::Mat& image) const {
   return GrabSinkFrame(m_handle, image, &m_status);
 }
 
+inline uint64_t CvSink::GrabFrameDirect(cv::Mat& image, double timeout) const {
+  m_status = 0;
+  return GrabSinkFrameTimeoutDirect(m_handle, image, timeout, &m_status);
+}
+
+inline uint64_t CvSink::GrabFrameNoTimeoutDirect(cv::Mat& image) const {
+  m_status = 0;
+  return GrabSinkFrameDirect(m_handle, image, &m_status);
+}
+
 }  // namespace cs
 
 #endif
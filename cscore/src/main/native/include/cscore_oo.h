@@ -100,7 +100,8 @@ class VideoSource {
     kUnknown = CS_SOURCE_UNKNOWN,
     kUsb = CS_SOURCE_USB,
     kHttp = CS_SOURCE_HTTP,
-    kCv = CS_SOURCE_CV
+    kCv = CS_SOURCE_CV,
+    kFile = CS_SOURCE_FILE
   };
 
   /** Connection strategy.  Used for SetConnectionStrategy(). */
@@ -264,6 +265,15 @@ class VideoSource {
    *     "brightness": percentage brightness
    *     "white balance": "auto", "hold", or value
    *     "exposure": "auto", "hold", or value
+   *     "image preallocation": number of images to preallocate
+   *     "precompute": [
+   *         {
+   *             "pixel format": "MJPEG", "BGR", etc
+   *             "width": image width (optional)
+   *             "height": image height (optional)
+   *             "quality": JPEG quality (optional)
+   *         }
+   *     ]
    *     "properties": [
    *         {
    *             "name": property name
@@ -300,6 +310,25 @@ class VideoSource {
    */
   wpi::json GetConfigJsonObject() const;
 
+  /**
+   * Precompute a derived image for every new frame.  Images are converted on
+   * a shared pool of worker threads as soon as the frame arrives, so sinks
+   * requesting the same image (e.g. a low resolution MJPEG stream for a
+   * dashboard) don't need to wait for the conversion.
+   *
+   * @param pixelFormat pixel format
+   * @param width image width (0 for the frame width)
+   * @param height image height (0 for the frame height)
+   * @param jpegQuality JPEG quality (MJPEG only; -1 for default)
+   */
+  void AddPrecomputedImage(VideoMode::PixelFormat pixelFormat, int width = 0,
+                           int height = 0, int jpegQuality = -1);
+
+  /**
+   * Stop precomputing derived images.
+   */
+  void ClearPrecomputedImages();
+
   /**
    * Get the actual FPS.
    *
@@ -318,6 +347,16 @@ class VideoSource {
    */
   double GetActualDataRate() const;
 
+  /**
+   * Get the average latency from frame capture to delivery to a sink (in
+   * microseconds).
+   *
+   * <p>SetTelemetryPeriod() must be called for this to be valid.
+   *
+   * @return Latency averaged over the telemetry period.
+   */
+  double GetCaptureLatency() const;
+
   /**
    * Enumerate all known video modes for this source.
    */
@@ -441,6 +480,27 @@ class UsbCamera : public VideoCamera {
    */
   static std::vector<UsbCameraInfo> EnumerateUsbCameras();
 
+  /**
+   * Set whether USB cameras share a single capture thread.
+   *
+   * <p>By default each USB camera captures frames on its own thread. When
+   * shared capture is enabled, cameras started afterwards are all serviced
+   * by one thread that waits on every camera at once. This is only supported
+   * on Linux.
+   *
+   * @param enabled True to capture on a shared thread
+   */
+  static void SetSharedCapture(bool enabled);
+
+  /**
+   * Set the CPUs USB camera capture threads are allowed to run on. This
+   * applies to capture threads (shared or per camera) started afterwards.
+   * This is only supported on Linux.
+   *
+   * @param cpus CPU numbers; empty to allow any CPU
+   */
+  static void SetCaptureAffinity(wpi::ArrayRef<int> cpus);
+
   /**
    * Change the path to the device.
    */
@@ -462,6 +522,15 @@ class UsbCamera : public VideoCamera {
    * @param level 0=don't display Connecting message, 1=do display message
    */
   void SetConnectVerbose(int level);
+
+  /**
+   * Set whether frames should reference the camera driver buffers directly
+   * rather than being copied.  Only supported on Linux; the number of driver
+   * buffers requested changes on the next (re)connect.
+   *
+   * @param enabled true to enable zero-copy capture
+   */
+  void SetZeroCopy(bool enabled);
 };
 
 /**
@@ -550,6 +619,19 @@ class HttpCamera : public VideoCamera {
    * Get the URLs used to connect to the camera.
    */
   std::vector<std::string> GetUrls() const;
+
+  /**
+   * Set whether the camera stream is received on a thread shared with other
+   * HTTP cameras.
+   *
+   * <p>By default each HTTP camera receives its stream on its own thread.
+   * When shared streaming is enabled, the stream is instead received on a
+   * single event loop thread that serves all such cameras, and frames are
+   * read from the network directly into the images that are published.
+   *
+   * @param enabled True to enable shared streaming
+   */
+  void SetSharedStreaming(bool enabled);
 };
 
 /**
@@ -618,6 +700,64 @@ class AxisCamera : public HttpCamera {
   AxisCamera(const wpi::Twine& name, std::initializer_list<T> hosts);
 };
 
+/**
+ * A source that plays back a file written by a RecordingSink.
+ */
+class FileSource : public VideoSource {
+ public:
+  enum PlaybackMode {
+    /** Frames are played at the rate they were recorded. */
+    kOriginalRate = CS_PLAYBACK_ORIGINAL_RATE,
+    /** Frames are played as fast as possible. */
+    kMaxRate = CS_PLAYBACK_MAX_RATE,
+    /** One frame is played for each call to Step(). */
+    kStepped = CS_PLAYBACK_STEPPED
+  };
+
+  FileSource() = default;
+
+  /**
+   * Create a source that plays back a recording.
+   *
+   * <p>Frames are only played while a sink is listening (as with cameras);
+   * the frame timestamps are the time each frame is played.
+   *
+   * @param name Source name (arbitrary unique identifier)
+   * @param path Recording file path
+   * @param mode Playback mode
+   */
+  FileSource(const wpi::Twine& name, const wpi::Twine& path,
+             PlaybackMode mode = kOriginalRate);
+
+  /**
+   * Set the playback mode.
+   */
+  void SetPlaybackMode(PlaybackMode mode);
+
+  /**
+   * Get the playback mode.
+   */
+  PlaybackMode GetPlaybackMode() const;
+
+  /**
+   * Set whether playback restarts from the beginning at the end of the
+   * recording.  By default, playback stops at the end.
+   */
+  void SetLoop(bool loop);
+
+  /**
+   * Play the next frame.  Only applies to the kStepped playback mode.
+   */
+  void Step();
+
+  /**
+   * Continue playback from the first frame at or after the given time.
+   *
+   * @param time time in seconds from the start of the recording
+   */
+  void Seek(double time);
+};
+
 /**
  * A base class for single image providing sources.
  */
@@ -730,7 +870,8 @@ class VideoSink {
   enum Kind {
     kUnknown = CS_SINK_UNKNOWN,
     kMjpeg = CS_SINK_MJPEG,
-    kCv = CS_SINK_CV
+    kCv = CS_SINK_CV,
+    kRecording = CS_SINK_RECORDING
   };
 
   VideoSink() noexcept = default;
@@ -948,6 +1089,73 @@ class MjpegServer : public VideoSink {
    * @param quality JPEG compression quality (0-100)
    */
   void SetDefaultCompression(int quality);
+
+  /**
+   * Set whether streaming clients are served by a single shared thread.
+   *
+   * <p>By default each streaming client is served by its own thread.  When
+   * shared streaming is enabled, clients that connect afterwards are instead
+   * handed off to one thread that waits for each frame once and writes it to
+   * all clients using non-blocking sends.  Clients that are unable to keep up
+   * have frames dropped rather than stalling the stream.
+   *
+   * @param enabled True to enable shared streaming
+   */
+  void SetSharedStreaming(bool enabled);
+
+  /**
+   * Set whether streams adapt to the available bandwidth.
+   *
+   * <p>When enabled, the server watches how quickly each client takes data
+   * and, if the connection can't keep up or a bandwidth limit is reached,
+   * lowers the JPEG quality, then the resolution, and skips frames as needed.
+   * Quality is restored once the connection has room again.  Like
+   * compression, reducing quality recompresses MJPEG source images.
+   *
+   * @param enabled True to enable adaptive streaming
+   */
+  void SetAdaptiveStreaming(bool enabled);
+
+  /**
+   * Set the bandwidth budget for each client that doesn't specify it.
+   * Frames are skipped (and, with adaptive streaming, quality is reduced) to
+   * stay within it.
+   *
+   * @param kbps bandwidth in kilobits per second, 0 for unlimited
+   */
+  void SetStreamBandwidth(int kbps);
+
+  /**
+   * Set the total bandwidth for all clients of this server.  Frames are
+   * skipped (and, with adaptive streaming, quality is reduced) to stay
+   * within it.
+   *
+   * @param kbps bandwidth in kilobits per second, 0 for unlimited
+   */
+  void SetMaxBandwidth(int kbps);
+};
+
+/**
+ * A sink that records the frames from its source to a file, for later
+ * playback with FileSource.
+ *
+ * <p>Frames are recorded exactly as the source provides them (e.g. camera
+ * MJPEG images are not recompressed), with their capture timestamps.  The file
+ * is written by a background thread; if it falls behind (e.g. due to slow
+ * storage), frames are dropped instead of delaying the source.  The recording
+ * is completed when the sink is destroyed.
+ */
+class RecordingSink : public VideoSink {
+ public:
+  RecordingSink() = default;
+
+  /**
+   * Create a recording sink.
+   *
+   * @param name Sink name (arbitrary unique identifier)
+   * @param path Recording file path; an existing file is overwritten
+   */
+  RecordingSink(const wpi::Twine& name, const wpi::Twine& path);
 };
 
 /**
@@ -979,6 +1187,49 @@ class ImageSink : public VideoSink {
    * processor resources when frames are not needed.
    */
   void SetEnabled(bool enabled);
+
+  /**
+   * Set the region of interest.  Grabbed images will contain only this
+   * rectangle of the source image (in source image pixels).  For MJPEG
+   * sources only the needed part of the image is decoded when possible.
+   * A zero width or height selects the whole image.  Regions can't be grabbed
+   * in YUYV format; such grabs fail.
+   *
+   * @param x left edge
+   * @param y top edge
+   * @param width width
+   * @param height height
+   */
+  void SetROI(int x, int y, int width, int height);
+
+  /**
+   * Clear the region of interest (grab the whole image).
+   */
+  void ClearROI() { SetROI(0, 0, 0, 0); }
+
+  /**
+   * Get the region of interest.
+   *
+   * @param x left edge (output)
+   * @param y top edge (output)
+   * @param width width (output); 0 if no region of interest is set
+   * @param height height (output); 0 if no region of interest is set
+   */
+  void GetROI(int* x, int* y, int* width, int* height) const;
+
+  /**
+   * Set the decimation factor.  Grabbed images (or the region of interest)
+   * are reduced in size by this integer factor in each dimension by
+   * subsampling.
+   *
+   * @param decimation decimation factor (1 for no decimation)
+   */
+  void SetDecimation(int decimation);
+
+  /**
+   * Get the decimation factor.
+   */
+  int GetDecimation() const;
 };
 
 /**
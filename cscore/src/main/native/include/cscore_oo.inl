@@ -191,6 +191,19 @@ inline std::string VideoSource::GetConfigJson() const {
   return GetSourceConfigJson(m_handle, &m_status);
 }
 
+inline void VideoSource::AddPrecomputedImage(
+    VideoMode::PixelFormat pixelFormat, int width, int height,
+    int jpegQuality) {
+  m_status = 0;
+  AddSourcePrecomputedImage(m_handle, pixelFormat, width, height, jpegQuality,
+                            &m_status);
+}
+
+inline void VideoSource::ClearPrecomputedImages() {
+  m_status = 0;
+  ClearSourcePrecomputedImages(m_handle, &m_status);
+}
+
 inline double VideoSource::GetActualFPS() const {
   m_status = 0;
   return cs::GetTelemetryAverageValue(m_handle, CS_SOURCE_FRAMES_RECEIVED,
@@ -203,6 +216,12 @@ inline double VideoSource::GetActualDataRate() const {
                                       &m_status);
 }
 
+inline double VideoSource::GetCaptureLatency() const {
+  m_status = 0;
+  return cs::GetTelemetryAverageValue(m_handle, CS_SOURCE_CAPTURE_LATENCY,
+                                      &m_status);
+}
+
 inline std::vector<VideoMode> VideoSource::EnumerateVideoModes() const {
   CS_Status status = 0;
   return EnumerateSourceVideoModes(m_handle, &status);
@@ -261,6 +280,16 @@ inline std::vector<UsbCameraInfo> UsbCamera::EnumerateUsbCameras() {
   return ::cs::EnumerateUsbCameras(&status);
 }
 
+inline void UsbCamera::SetSharedCapture(bool enabled) {
+  CS_Status status = 0;
+  ::cs::SetUsbCameraSharedCapture(enabled, &status);
+}
+
+inline void UsbCamera::SetCaptureAffinity(wpi::ArrayRef<int> cpus) {
+  CS_Status status = 0;
+  ::cs::SetUsbCameraCaptureAffinity(cpus, &status);
+}
+
 inline void UsbCamera::SetPath(const wpi::Twine& path) {
   m_status = 0;
   return ::cs::SetUsbCameraPath(m_handle, path, &m_status);
@@ -282,6 +311,12 @@ inline void UsbCamera::SetConnectVerbose(int level) {
               &m_status);
 }
 
+inline void UsbCamera::SetZeroCopy(bool enabled) {
+  m_status = 0;
+  SetProperty(GetSourceProperty(m_handle, "zero_copy", &m_status),
+              enabled ? 1 : 0, &m_status);
+}
+
 inline HttpCamera::HttpCamera(const wpi::Twine& name, const wpi::Twine& url,
                               HttpCameraKind kind) {
   m_handle = CreateHttpCamera(
@@ -349,6 +384,11 @@ inline std::vector<std::string> HttpCamera::GetUrls() const {
   return ::cs::GetHttpCameraUrls(m_handle, &m_status);
 }
 
+inline void HttpCamera::SetSharedStreaming(bool enabled) {
+  m_status = 0;
+  ::cs::SetHttpCameraSharedStreaming(m_handle, enabled, &m_status);
+}
+
 inline std::string AxisCamera::HostToUrl(const wpi::Twine& host) {
   return ("http://" + host + "/mjpg/video.mjpg").str();
 }
@@ -395,6 +435,41 @@ inline AxisCamera::AxisCamera(const wpi::Twine& name,
                               std::initializer_list<T> hosts)
     : HttpCamera(name, HostToUrl(hosts), kAxis) {}
 
+inline FileSource::FileSource(const wpi::Twine& name, const wpi::Twine& path,
+                              PlaybackMode mode) {
+  m_handle = CreateFileSource(
+      name, path, static_cast<CS_PlaybackMode>(static_cast<int>(mode)),
+      &m_status);
+}
+
+inline void FileSource::SetPlaybackMode(PlaybackMode mode) {
+  m_status = 0;
+  SetFileSourcePlaybackMode(
+      m_handle, static_cast<CS_PlaybackMode>(static_cast<int>(mode)),
+      &m_status);
+}
+
+inline FileSource::PlaybackMode FileSource::GetPlaybackMode() const {
+  m_status = 0;
+  return static_cast<PlaybackMode>(
+      static_cast<int>(GetFileSourcePlaybackMode(m_handle, &m_status)));
+}
+
+inline void FileSource::SetLoop(bool loop) {
+  m_status = 0;
+  SetFileSourceLoop(m_handle, loop, &m_status);
+}
+
+inline void FileSource::Step() {
+  m_status = 0;
+  StepFileSource(m_handle, &m_status);
+}
+
+inline void FileSource::Seek(double time) {
+  m_status = 0;
+  SeekFileSource(m_handle, time, &m_status);
+}
+
 inline void ImageSource::NotifyError(const wpi::Twine& msg) {
   m_status = 0;
   NotifySourceError(m_handle, msg, &m_status);
@@ -588,6 +663,35 @@ inline void MjpegServer::SetDefaultCompression(int quality) {
               quality, &m_status);
 }
 
+inline void MjpegServer::SetSharedStreaming(bool enabled) {
+  m_status = 0;
+  SetProperty(GetSinkProperty(m_handle, "shared_streaming", &m_status),
+              enabled ? 1 : 0, &m_status);
+}
+
+inline void MjpegServer::SetAdaptiveStreaming(bool enabled) {
+  m_status = 0;
+  SetProperty(GetSinkProperty(m_handle, "adaptive_streaming", &m_status),
+              enabled ? 1 : 0, &m_status);
+}
+
+inline void MjpegServer::SetStreamBandwidth(int kbps) {
+  m_status = 0;
+  SetProperty(GetSinkProperty(m_handle, "stream_bandwidth", &m_status), kbps,
+              &m_status);
+}
+
+inline void MjpegServer::SetMaxBandwidth(int kbps) {
+  m_status = 0;
+  SetProperty(GetSinkProperty(m_handle, "max_bandwidth", &m_status), kbps,
+              &m_status);
+}
+
+inline RecordingSink::RecordingSink(const wpi::Twine& name,
+                                    const wpi::Twine& path) {
+  m_handle = CreateRecordingSink(name, path, &m_status);
+}
+
 inline void ImageSink::SetDescription(const wpi::Twine& description) {
   m_status = 0;
   SetSinkDescription(m_handle, description, &m_status);
@@ -603,6 +707,26 @@ inline void ImageSink::SetEnabled(bool enabled) {
   SetSinkEnabled(m_handle, enabled, &m_status);
 }
 
+inline void ImageSink::SetROI(int x, int y, int width, int height) {
+  m_status = 0;
+  SetSinkROI(m_handle, x, y, width, height, &m_status);
+}
+
+inline void ImageSink::GetROI(int* x, int* y, int* width, int* height) const {
+  m_status = 0;
+  GetSinkROI(m_handle, x, y, width, height, &m_status);
+}
+
+inline void ImageSink::SetDecimation(int decimation) {
+  m_status = 0;
+  SetSinkDecimation(m_handle, decimation, &m_status);
+}
+
+inline int ImageSink::GetDecimation() const {
+  m_status = 0;
+  return GetSinkDecimation(m_handle, &m_status);
+}
+
 inline VideoSource VideoEvent::GetSource() const {
   CS_Status status = 0;
   return VideoSource{sourceHandle == 0 ? 0 : CopySource(sourceHandle, &status)};
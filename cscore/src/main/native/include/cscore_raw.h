@@ -16,6 +16,7 @@
  */
 typedef struct CS_RawFrame {
   char* data;
+  /** Size of the data allocation; 0 if data is not owned by the frame */
   int dataLength;
   int pixelFormat;
   int width;
@@ -38,6 +39,11 @@ uint64_t CS_GrabRawSinkFrame(CS_Sink sink, struct CS_RawFrame* rawImage,
                              CS_Status* status);
 uint64_t CS_GrabRawSinkFrameTimeout(CS_Sink sink, struct CS_RawFrame* rawImage,
                                     double timeout, CS_Status* status);
+uint64_t CS_GrabRawSinkFrameDirect(CS_Sink sink, struct CS_RawFrame* rawImage,
+                                   CS_Status* status);
+uint64_t CS_GrabRawSinkFrameTimeoutDirect(CS_Sink sink,
+                                          struct CS_RawFrame* rawImage,
+                                          double timeout, CS_Status* status);
 
 CS_Sink CS_CreateRawSink(const char* name, CS_Status* status);
 
@@ -91,6 +97,10 @@ void PutSourceFrame(CS_Source source, const CS_RawFrame& image,
 uint64_t GrabSinkFrame(CS_Sink sink, CS_RawFrame& image, CS_Status* status);
 uint64_t GrabSinkFrameTimeout(CS_Sink sink, CS_RawFrame& image, double timeout,
                               CS_Status* status);
+uint64_t GrabSinkFrameDirect(CS_Sink sink, CS_RawFrame& image,
+                             CS_Status* status);
+uint64_t GrabSinkFrameTimeoutDirect(CS_Sink sink, CS_RawFrame& image,
+                                    double timeout, CS_Status* status);
 
 /**
  * A source for user code to provide video frames as raw bytes.
@@ -172,7 +182,9 @@ class RawSink : public ImageSink {
    *
    * @return Frame time, or 0 on error (call GetError() to obtain the error
    *         message); the frame time is in the same time base as wpi::Now(),
-   *         and is in 1 us increments.
+   *         and is in 1 us increments.  If the camera driver provides
+   *         capture timestamps (e.g. V4L2), this is the time the frame was
+   *         captured rather than the time it was received.
    */
   uint64_t GrabFrame(RawFrame& image, double timeout = 0.225) const;
 
@@ -182,9 +194,37 @@ class RawSink : public ImageSink {
    *
    * @return Frame time, or 0 on error (call GetError() to obtain the error
    *         message); the frame time is in the same time base as wpi::Now(),
-   *         and is in 1 us increments.
+   *         and is in 1 us increments.  If the camera driver provides
+   *         capture timestamps (e.g. V4L2), this is the time the frame was
+   *         captured rather than the time it was received.
    */
   uint64_t GrabFrameNoTimeout(RawFrame& image) const;
+
+  /**
+   * Wait for the next frame and get the image without copying it.
+   * Times out (returning 0) after timeout seconds.
+   * The image data references the frame directly (dataLength is set to 0),
+   * must be treated as read-only, and is only valid until the next call to
+   * grab a frame from this sink.
+   *
+   * @return Frame time, or 0 on error (call GetError() to obtain the error
+   *         message); the frame time is in the same time base as wpi::Now(),
+   *         and is in 1 us increments.
+   */
+  uint64_t GrabFrameDirect(RawFrame& image, double timeout = 0.225) const;
+
+  /**
+   * Wait for the next frame and get the image without copying it.  May block
+   * forever.
+   * The image data references the frame directly (dataLength is set to 0),
+   * must be treated as read-only, and is only valid until the next call to
+   * grab a frame from this sink.
+   *
+   * @return Frame time, or 0 on error (call GetError() to obtain the error
+   *         message); the frame time is in the same time base as wpi::Now(),
+   *         and is in 1 us increments.
+   */
+  uint64_t GrabFrameNoTimeoutDirect(RawFrame& image) const;
 };
 
 inline RawSource::RawSource(const wpi::Twine& name, const VideoMode& mode) {
@@ -222,6 +262,17 @@ inline uint64_t RawSink::GrabFrameNoTimeout(RawFrame& image) const {
   return GrabSinkFrame(m_handle, image, &m_status);
 }
 
+inline uint64_t RawSink::GrabFrameDirect(RawFrame& image,
+                                         double timeout) const {
+  m_status = 0;
+  return GrabSinkFrameTimeoutDirect(m_handle, image, timeout, &m_status);
+}
+
+inline uint64_t RawSink::GrabFrameNoTimeoutDirect(RawFrame& image) const {
+  m_status = 0;
+  return GrabSinkFrameDirect(m_handle, image, &m_status);
+}
+
 }  // namespace cs
 
 /** @} */
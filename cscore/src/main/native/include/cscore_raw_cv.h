@@ -107,7 +107,9 @@ class RawCvSink : public RawSink {
    *
    * @return Frame time, or 0 on error (call GetError() to obtain the error
    *         message); the frame time is in the same time base as wpi::Now(),
-   *         and is in 1 us increments.
+   *         and is in 1 us increments.  If the camera driver provides
+   *         capture timestamps (e.g. V4L2), this is the time the frame was
+   *         captured rather than the time it was received.
    */
   uint64_t GrabFrame(cv::Mat& image, double timeout = 0.225);
 
@@ -117,28 +119,39 @@ class RawCvSink : public RawSink {
    *
    * @return Frame time, or 0 on error (call GetError() to obtain the error
    *         message); the frame time is in the same time base as wpi::Now(),
-   *         and is in 1 us increments.
+   *         and is in 1 us increments.  If the camera driver provides
+   *         capture timestamps (e.g. V4L2), this is the time the frame was
+   *         captured rather than the time it was received.
    */
   uint64_t GrabFrameNoTimeout(cv::Mat& image);
 
   /**
-   * Wait for the next frame and get the image.
+   * Wait for the next frame and get the image without copying it.
    * Times out (returning 0) after timeout seconds.
    * The provided image will have three 8-bit channels stored in BGR order.
+   * It references the frame data directly, must be treated as read-only, and
+   * is only valid until the next call to grab a frame from this sink.
    *
    * @return Frame time, or 0 on error (call GetError() to obtain the error
    *         message); the frame time is in the same time base as wpi::Now(),
-   *         and is in 1 us increments.
+   *         and is in 1 us increments.  If the camera driver provides
+   *         capture timestamps (e.g. V4L2), this is the time the frame was
+   *         captured rather than the time it was received.
    */
   uint64_t GrabFrameDirect(cv::Mat& image, double timeout = 0.225);
 
   /**
-   * Wait for the next frame and get the image.  May block forever.
+   * Wait for the next frame and get the image without copying it.  May block
+   * forever.
    * The provided image will have three 8-bit channels stored in BGR order.
+   * It references the frame data directly, must be treated as read-only, and
+   * is only valid until the next call to grab a frame from this sink.
    *
    * @return Frame time, or 0 on error (call GetError() to obtain the error
    *         message); the frame time is in the same time base as wpi::Now(),
-   *         and is in 1 us increments.
+   *         and is in 1 us increments.  If the camera driver provides
+   *         capture timestamps (e.g. V4L2), this is the time the frame was
+   *         captured rather than the time it was received.
    */
   uint64_t GrabFrameNoTimeoutDirect(cv::Mat& image);
 
@@ -172,7 +185,7 @@ inline RawCvSink::RawCvSink(const wpi::Twine& name,
 
 inline uint64_t RawCvSink::GrabFrame(cv::Mat& image, double timeout) {
   cv::Mat tmpnam;
-  auto retVal = GrabFrameDirect(tmpnam);
+  auto retVal = GrabFrameDirect(tmpnam, timeout);
   if (retVal <= 0) {
     return retVal;
   }
@@ -194,7 +207,7 @@ inline uint64_t RawCvSink::GrabFrameDirect(cv::Mat& image, double timeout) {
   rawFrame.height = 0;
   rawFrame.width = 0;
   rawFrame.pixelFormat = CS_PixelFormat::CS_PIXFMT_BGR;
-  m_status = RawSink::GrabFrame(rawFrame, timeout);
+  m_status = RawSink::GrabFrameDirect(rawFrame, timeout);
   if (m_status <= 0) {
     return m_status;
   }
@@ -206,7 +219,7 @@ inline uint64_t RawCvSink::GrabFrameNoTimeoutDirect(cv::Mat& image) {
   rawFrame.height = 0;
   rawFrame.width = 0;
   rawFrame.pixelFormat = CS_PixelFormat::CS_PIXFMT_BGR;
-  m_status = RawSink::GrabFrameNoTimeout(rawFrame);
+  m_status = RawSink::GrabFrameNoTimeoutDirect(rawFrame);
   if (m_status <= 0) {
     return m_status;
   }
@@ -17,6 +17,7 @@
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -35,6 +36,7 @@
 #include "Log.h"
 #include "Notifier.h"
 #include "Telemetry.h"
+#include "UsbCaptureLoop.h"
 #include "UsbUtil.h"
 #include "cscore_cpp.h"
 
@@ -47,6 +49,8 @@ static constexpr char const* kPropExValue = "exposure_absolute";
 static constexpr char const* kPropBrValue = "brightness";
 static constexpr char const* kPropConnectVerbose = "connect_verbose";
 static constexpr unsigned kPropConnectVerboseId = 0;
+static constexpr char const* kPropZeroCopy = "zero_copy";
+static constexpr unsigned kPropZeroCopyId = 1;
 
 // Conversions v4l2_fract time per frame from/to frames per second (fps)
 static inline int FractToFPS(const struct v4l2_fract& timeperframe) {
@@ -60,6 +64,30 @@ static inline struct v4l2_fract FPSToFract(int fps) {
   return timeperframe;
 }
 
+// Conversion from v4l2_buffer capture timestamp to wpi::Now() timebase
+static Frame::Time GetFrameTime(const struct v4l2_buffer& buf) {
+  // fall back to the current time if the driver doesn't provide a monotonic
+  // timestamp or the timestamp is implausible
+  Frame::Time now = wpi::Now();
+  if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) !=
+      V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+    return now;
+  }
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+    return now;
+  }
+  int64_t monoNow = static_cast<int64_t>(ts.tv_sec) * 1000000 +
+                    ts.tv_nsec / 1000;
+  int64_t captured = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000 +
+                     buf.timestamp.tv_usec;
+  int64_t age = monoNow - captured;
+  if (age < 0 || age > 1000000 || static_cast<uint64_t>(age) > now) {
+    return now;
+  }
+  return now - age;
+}
+
 // Conversion from v4l2_format pixelformat to VideoMode::PixelFormat
 static VideoMode::PixelFormat ToPixelFormat(__u32 pixelFormat) {
   switch (pixelFormat) {
@@ -327,6 +355,10 @@ UsbCameraImpl::UsbCameraImpl(const wpi::Twine& name, wpi::Logger& logger,
                                                kPropConnectVerboseId,
                                                CS_PROP_INTEGER, 0, 1, 1, 1, 1);
   });
+  CreateProperty(kPropZeroCopy, [] {
+    return std::make_unique<UsbCameraProperty>(
+        kPropZeroCopy, kPropZeroCopyId, CS_PROP_BOOLEAN, 0, 1, 1, 0, 0);
+  });
 }
 
 UsbCameraImpl::~UsbCameraImpl() {
@@ -339,11 +371,16 @@ UsbCameraImpl::~UsbCameraImpl() {
   // but this speeds shutdown.
   Send(Message{Message::kNone});
 
-  // join camera thread
-  if (m_cameraThread.joinable()) {
+  // join camera thread (or wait for the shared thread to release us)
+  if (m_sharedCapture) {
+    UsbCaptureLoop::GetInstance().Remove(this);
+  } else if (m_cameraThread.joinable()) {
     m_cameraThread.join();
   }
 
+  // Clear the current frame now, as it may reference one of our buffers
+  Wakeup();
+
   // close command fd
   int fd = m_command_fd.exchange(-1);
   if (fd >= 0) {
@@ -361,14 +398,55 @@ static inline void DoFdSet(int fd, fd_set* set, int* nfds) {
 }
 
 void UsbCameraImpl::Start() {
+  if (UsbCaptureLoop::IsSharedEnabled()) {
+    // Hand the camera to the shared capture thread
+    m_sharedCapture = true;
+    UsbCaptureLoop::GetInstance().Add(this);
+    return;
+  }
+
   // Kick off the camera thread
   m_cameraThread = std::thread(&UsbCameraImpl::CameraThreadMain, this);
 }
 
 void UsbCameraImpl::CameraThreadMain() {
+  UsbCaptureLoop::ApplyAffinity(m_logger);
+  DeviceThreadStart();
+
+  while (m_active) {
+    int timeout;
+    WaitFds fds = DeviceThreadPrepare(&timeout);
+    if (!m_active) {
+      break;
+    }
+
+    // select on applicable read descriptors
+    struct timeval tv;
+    tv.tv_sec = timeout / 1000;
+    tv.tv_usec = (timeout % 1000) * 1000;
+    int nfds = 0;
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    DoFdSet(fds.command, &readfds, &nfds);
+    DoFdSet(fds.device, &readfds, &nfds);
+    DoFdSet(fds.notify, &readfds, &nfds);
+
+    if (select(nfds, &readfds, nullptr, nullptr, &tv) < 0) {
+      SERROR("select(): " << std::strerror(errno));
+      break;  // XXX: is this the right thing to do here?
+    }
+
+    DeviceThreadHandle(fds, fds.notify >= 0 && FD_ISSET(fds.notify, &readfds),
+                       fds.command >= 0 && FD_ISSET(fds.command, &readfds),
+                       fds.device >= 0 && FD_ISSET(fds.device, &readfds));
+  }
+
+  DeviceThreadStop();
+}
+
+void UsbCameraImpl::DeviceThreadStart() {
   // We want to be notified on file creation and deletion events in the device
   // path.  This is used to detect disconnects and reconnects.
-  std::unique_ptr<wpi::raw_fd_istream> notify_is;
   int notify_fd = inotify_init();
   if (notify_fd >= 0) {
     // need to make a copy as dirname can modify it
@@ -379,180 +457,196 @@ void UsbCameraImpl::CameraThreadMain() {
       close(notify_fd);
       notify_fd = -1;
     } else {
-      notify_is = std::make_unique<wpi::raw_fd_istream>(
+      m_notifyIs = std::make_unique<wpi::raw_fd_istream>(
           notify_fd, true, sizeof(struct inotify_event) + NAME_MAX + 1);
     }
   }
-  bool notified = (notify_fd < 0);  // treat as always notified if cannot notify
+  m_notifyFd = notify_fd;
+  // treat as always notified if cannot notify
+  m_notified = (notify_fd < 0);
 
   // Get the basename for later notify use
   wpi::SmallString<64> pathCopy{m_path};
   pathCopy.push_back('\0');
-  wpi::SmallString<64> base{basename(pathCopy.data())};
+  m_notifyBase = basename(pathCopy.data());
 
   // Used to restart streaming on reconnect
-  bool wasStreaming = false;
+  m_wasStreaming = false;
 
   // Default to not streaming
   m_streaming = false;
+}
 
-  while (m_active) {
-    // If not connected, try to reconnect
-    if (m_fd < 0) {
-      DeviceConnect();
-    }
-
-    // Make copies of fd's in case they go away
-    int command_fd = m_command_fd.load();
-    int fd = m_fd.load();
-    if (!m_active) {
-      break;
-    }
+UsbCameraImpl::WaitFds UsbCameraImpl::DeviceThreadPrepare(int* timeout) {
+  // If not connected, try to reconnect
+  if (m_fd < 0 && m_active) {
+    DeviceConnect();
+  }
 
-    // Reset notified flag and restart streaming if necessary
-    if (fd >= 0) {
-      notified = (notify_fd < 0);
-      if (wasStreaming && !m_streaming) {
-        DeviceStreamOn();
-        wasStreaming = false;
-      }
-    }
+  // Make copies of fd's in case they go away
+  WaitFds fds;
+  fds.command = m_command_fd.load();
+  fds.device = m_fd.load();
+  fds.notify = m_notifyFd;
 
-    // Turn off streaming if not enabled, and turn it on if enabled
-    if (m_streaming && !IsEnabled()) {
-      DeviceStreamOff();
-    } else if (!m_streaming && IsEnabled()) {
+  // Reset notified flag and restart streaming if necessary
+  if (fds.device >= 0) {
+    m_notified = (m_notifyFd < 0);
+    if (m_wasStreaming && !m_streaming) {
       DeviceStreamOn();
+      m_wasStreaming = false;
     }
+  }
 
-    // The select timeout can be long unless we're trying to reconnect
-    struct timeval tv;
-    if (fd < 0 && notified) {
-      tv.tv_sec = 0;
-      tv.tv_usec = 300000;
-    } else {
-      tv.tv_sec = 2;
-      tv.tv_usec = 0;
-    }
+  // Turn off streaming if not enabled, and turn it on if enabled
+  if (m_streaming && !IsEnabled()) {
+    DeviceStreamOff();
+  } else if (!m_streaming && IsEnabled()) {
+    DeviceStreamOn();
+  }
 
-    // select on applicable read descriptors
-    int nfds = 0;
-    fd_set readfds;
-    FD_ZERO(&readfds);
-    DoFdSet(command_fd, &readfds, &nfds);
-    if (m_streaming) {
-      DoFdSet(fd, &readfds, &nfds);
-    }
-    DoFdSet(notify_fd, &readfds, &nfds);
+  // The wait timeout can be long unless we're trying to reconnect
+  *timeout = (fds.device < 0 && m_notified) ? 300 : 2000;
 
-    if (select(nfds, &readfds, nullptr, nullptr, &tv) < 0) {
-      SERROR("select(): " << std::strerror(errno));
-      break;  // XXX: is this the right thing to do here?
-    }
+  // Only wait for frames while streaming
+  if (!m_streaming) {
+    fds.device = -1;
+  }
+  return fds;
+}
 
-    // Double-check to see if we're shutting down
-    if (!m_active) {
-      break;
-    }
+void UsbCameraImpl::DeviceThreadHandle(const WaitFds& fds, bool notifyReady,
+                                       bool commandReady, bool deviceReady) {
+  // Double-check to see if we're shutting down
+  if (!m_active) {
+    return;
+  }
 
-    // Handle notify events
-    if (notify_fd >= 0 && FD_ISSET(notify_fd, &readfds)) {
-      SDEBUG4("notify event");
-      struct inotify_event event;
-      do {
-        // Read the event structure
-        notify_is->read(&event, sizeof(event));
-        // Read the event name
-        wpi::SmallString<64> raw_name;
-        raw_name.resize(event.len);
-        notify_is->read(raw_name.data(), event.len);
-        // If the name is what we expect...
-        wpi::StringRef name{raw_name.c_str()};
-        SDEBUG4("got event on '" << name << "' (" << name.size()
-                                 << ") compare to '" << base << "' ("
-                                 << base.size() << ") mask " << event.mask);
-        if (name == base) {
-          if ((event.mask & IN_DELETE) != 0) {
-            wasStreaming = m_streaming;
-            DeviceStreamOff();
-            DeviceDisconnect();
-          } else if ((event.mask & IN_CREATE) != 0) {
-            notified = true;
-          }
+  // Handle notify events
+  if (notifyReady) {
+    SDEBUG4("notify event");
+    struct inotify_event event;
+    do {
+      // Read the event structure
+      m_notifyIs->read(&event, sizeof(event));
+      // Read the event name
+      wpi::SmallString<64> raw_name;
+      raw_name.resize(event.len);
+      m_notifyIs->read(raw_name.data(), event.len);
+      // If the name is what we expect...
+      wpi::StringRef name{raw_name.c_str()};
+      SDEBUG4("got event on '" << name << "' (" << name.size()
+                               << ") compare to '" << m_notifyBase << "' ("
+                               << m_notifyBase.size() << ") mask "
+                               << event.mask);
+      if (name == m_notifyBase) {
+        if ((event.mask & IN_DELETE) != 0) {
+          m_wasStreaming = m_streaming;
+          DeviceStreamOff();
+          DeviceDisconnect();
+        } else if ((event.mask & IN_CREATE) != 0) {
+          m_notified = true;
         }
-      } while (!notify_is->has_error() &&
-               notify_is->in_avail() >= sizeof(event));
-      continue;
-    }
+      }
+    } while (!m_notifyIs->has_error() &&
+             m_notifyIs->in_avail() >= sizeof(event));
+    return;
+  }
 
-    // Handle commands
-    if (command_fd >= 0 && FD_ISSET(command_fd, &readfds)) {
-      SDEBUG4("got command");
-      // Read it to clear
-      eventfd_t val;
-      eventfd_read(command_fd, &val);
-      DeviceProcessCommands();
-      continue;
-    }
+  // Handle commands
+  if (commandReady) {
+    SDEBUG4("got command");
+    // Read it to clear
+    eventfd_t val;
+    eventfd_read(fds.command, &val);
+    DeviceRequeueBuffers();
+    DeviceProcessCommands();
+    return;
+  }
 
-    // Handle frames
-    if (m_streaming && fd >= 0 && FD_ISSET(fd, &readfds)) {
-      SDEBUG4("grabbing image");
-
-      // Dequeue buffer
-      struct v4l2_buffer buf;
-      std::memset(&buf, 0, sizeof(buf));
-      buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-      buf.memory = V4L2_MEMORY_MMAP;
-      if (DoIoctl(fd, VIDIOC_DQBUF, &buf) != 0) {
-        SWARNING("could not dequeue buffer");
-        wasStreaming = m_streaming;
-        DeviceStreamOff();
-        DeviceDisconnect();
-        notified = true;  // device wasn't deleted, just error'ed
-        continue;         // will reconnect
-      }
+  // Handle frames
+  int fd = fds.device;
+  if (m_streaming && fd >= 0 && deviceReady) {
+    SDEBUG4("grabbing image");
 
-      if ((buf.flags & V4L2_BUF_FLAG_ERROR) == 0) {
-        SDEBUG4("got image size=" << buf.bytesused << " index=" << buf.index);
+    // Dequeue buffer
+    struct v4l2_buffer buf;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (DoIoctl(fd, VIDIOC_DQBUF, &buf) != 0) {
+      SWARNING("could not dequeue buffer");
+      m_wasStreaming = m_streaming;
+      DeviceStreamOff();
+      DeviceDisconnect();
+      m_notified = true;  // device wasn't deleted, just error'ed
+      return;             // will reconnect
+    }
 
-        if (buf.index >= kNumBuffers || !m_buffers[buf.index].m_data) {
-          SWARNING("invalid buffer" << buf.index);
-          continue;
-        }
+    SDEBUG4("got image size=" << buf.bytesused << " index=" << buf.index);
 
-        wpi::StringRef image{
-            static_cast<const char*>(m_buffers[buf.index].m_data),
-            static_cast<size_t>(buf.bytesused)};
-        int width = m_mode.width;
-        int height = m_mode.height;
-        bool good = true;
-        if (m_mode.pixelFormat == VideoMode::kMJPEG &&
-            !GetJpegSize(image, &width, &height)) {
-          SWARNING("invalid JPEG image received from camera");
-          good = false;
-        }
-        if (good) {
-          PutFrame(static_cast<VideoMode::PixelFormat>(m_mode.pixelFormat),
-                   width, height, image, wpi::Now());  // TODO: time
-        }
+    if (buf.index >= static_cast<unsigned>(m_numBuffers) ||
+        !m_buffers[buf.index]) {
+      SWARNING("invalid buffer" << buf.index);
+      return;
+    }
+    --m_numQueued;
+
+    if ((buf.flags & V4L2_BUF_FLAG_ERROR) == 0) {
+      wpi::StringRef image{
+          static_cast<const char*>(m_buffers[buf.index]->m_data),
+          static_cast<size_t>(buf.bytesused)};
+      auto pixelFormat =
+          static_cast<VideoMode::PixelFormat>(m_mode.pixelFormat);
+      int width = m_mode.width;
+      int height = m_mode.height;
+      bool good = true;
+      if (pixelFormat == VideoMode::kMJPEG &&
+          !GetJpegSize(image, &width, &height)) {
+        SWARNING("invalid JPEG image received from camera");
+        good = false;
       }
-
-      // Requeue buffer
-      if (DoIoctl(fd, VIDIOC_QBUF, &buf) != 0) {
-        SWARNING("could not requeue buffer");
-        wasStreaming = m_streaming;
-        DeviceStreamOff();
-        DeviceDisconnect();
-        notified = true;  // device wasn't deleted, just error'ed
-        continue;         // will reconnect
+      if (good && m_zeroCopy && m_numQueued >= kMinQueuedBuffers) {
+        // Hand the driver buffer to the frame; it is requeued when the
+        // last reference to the frame goes away.
+        auto newImage = std::make_unique<Image>(
+            image.data(), image.size(),
+            [this, buffer = m_buffers[buf.index],
+             generation = m_bufferGeneration,
+             index = buf.index] { ReleaseBuffer(generation, index); });
+        newImage->pixelFormat = pixelFormat;
+        newImage->width = width;
+        newImage->height = height;
+        m_bufferHeld[buf.index] = true;
+        PutFrame(std::move(newImage), GetFrameTime(buf));
+        return;
+      }
+      if (good) {
+        PutFrame(pixelFormat, width, height, image, GetFrameTime(buf));
       }
     }
+
+    // Requeue buffer
+    if (DoIoctl(fd, VIDIOC_QBUF, &buf) != 0) {
+      SWARNING("could not requeue buffer");
+      m_wasStreaming = m_streaming;
+      DeviceStreamOff();
+      DeviceDisconnect();
+      m_notified = true;  // device wasn't deleted, just error'ed
+      return;             // will reconnect
+    }
+    ++m_numQueued;
   }
+}
 
+void UsbCameraImpl::DeviceThreadStop() {
   // close camera connection
   DeviceStreamOff();
   DeviceDisconnect();
+
+  // close notify fd
+  m_notifyIs.reset();
+  m_notifyFd = -1;
 }
 
 void UsbCameraImpl::DeviceDisconnect() {
@@ -561,11 +655,28 @@ void UsbCameraImpl::DeviceDisconnect() {
     return;  // already disconnected
   }
 
-  // Unmap buffers
-  for (int i = 0; i < kNumBuffers; ++i) {
-    m_buffers[i] = UsbCameraBuffer{};
+  // The shared capture thread must stop waiting on the descriptor before it
+  // is closed, as the number may be reused by another camera
+  if (m_sharedCapture) {
+    UsbCaptureLoop::GetInstance().DeviceClosing(this, fd);
   }
 
+  // Drop the current frame if it references a buffer; the driver will refuse
+  // to reallocate buffers on reconnect while any are still mapped.
+  if (std::any_of(m_bufferHeld.begin(), m_bufferHeld.end(),
+                  [](bool held) { return held; })) {
+    Wakeup();
+  }
+
+  // Unmap buffers (buffers held by frames are unmapped when released)
+  for (auto&& buffer : m_buffers) {
+    buffer.reset();
+  }
+  m_bufferHeld.fill(false);
+  m_numBuffers = 0;
+  m_numQueued = 0;
+  ++m_bufferGeneration;
+
   // Close device
   close(fd);
 
@@ -632,19 +743,22 @@ void UsbCameraImpl::DeviceConnect() {
   SDEBUG3("allocating buffers");
   struct v4l2_requestbuffers rb;
   std::memset(&rb, 0, sizeof(rb));
-  rb.count = kNumBuffers;
+  rb.count = m_zeroCopy ? kNumZeroCopyBuffers : kNumBuffers;
   rb.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
   rb.memory = V4L2_MEMORY_MMAP;
-  if (DoIoctl(fd, VIDIOC_REQBUFS, &rb) != 0) {
+  if (DoIoctl(fd, VIDIOC_REQBUFS, &rb) != 0 || rb.count == 0) {
     SWARNING("could not allocate buffers");
     close(fd);
     m_fd = -1;
     return;
   }
+  // the driver may have given us a different number of buffers
+  m_numBuffers = std::min(static_cast<int>(rb.count), kNumZeroCopyBuffers);
+  SDEBUG4("allocated " << m_numBuffers << " buffers");
 
   // Map buffers
   SDEBUG3("mapping buffers");
-  for (int i = 0; i < kNumBuffers; ++i) {
+  for (int i = 0; i < m_numBuffers; ++i) {
     struct v4l2_buffer buf;
     std::memset(&buf, 0, sizeof(buf));
     buf.index = i;
@@ -659,19 +773,21 @@ void UsbCameraImpl::DeviceConnect() {
     SDEBUG4("buf " << i << " length=" << buf.length
                    << " offset=" << buf.m.offset);
 
-    m_buffers[i] = UsbCameraBuffer(fd, buf.length, buf.m.offset);
-    if (!m_buffers[i].m_data) {
+    m_buffers[i] =
+        std::make_shared<UsbCameraBuffer>(fd, buf.length, buf.m.offset);
+    if (!m_buffers[i]->m_data) {
       SWARNING("could not map buffer " << i);
       // release other buffers
-      for (int j = 0; j < i; ++j) {
-        m_buffers[j] = UsbCameraBuffer{};
+      for (int j = 0; j <= i; ++j) {
+        m_buffers[j].reset();
       }
+      m_numBuffers = 0;
       close(fd);
       m_fd = -1;
       return;
     }
 
-    SDEBUG4("buf " << i << " address=" << m_buffers[i].m_data);
+    SDEBUG4("buf " << i << " address=" << m_buffers[i]->m_data);
   }
 
   // Update description (as it may have changed)
@@ -680,6 +796,17 @@ void UsbCameraImpl::DeviceConnect() {
   // Update quirks settings
   SetQuirks();
 
+  // Fill the image pool for the new mode (frames are copied into it unless
+  // zero copy is enabled)
+  if (!m_zeroCopy) {
+    VideoMode mode;
+    {
+      std::scoped_lock lock(m_mutex);
+      mode = m_mode;
+    }
+    PreallocateImages(mode);
+  }
+
   // Notify
   SetConnected(true);
 }
@@ -693,9 +820,13 @@ bool UsbCameraImpl::DeviceStreamOn() {
     return false;
   }
 
-  // Queue buffers
+  // Queue buffers (except those still held by zero-copy frames)
   SDEBUG3("queuing buffers");
-  for (int i = 0; i < kNumBuffers; ++i) {
+  m_numQueued = 0;
+  for (int i = 0; i < m_numBuffers; ++i) {
+    if (m_bufferHeld[i]) {
+      continue;
+    }
     struct v4l2_buffer buf;
     std::memset(&buf, 0, sizeof(buf));
     buf.index = i;
@@ -705,6 +836,7 @@ bool UsbCameraImpl::DeviceStreamOn() {
       SWARNING("could not queue buffer " << i);
       return false;
     }
+    ++m_numQueued;
   }
 
   // Turn stream on
@@ -741,9 +873,58 @@ bool UsbCameraImpl::DeviceStreamOff() {
   }
   SDEBUG4("disabled streaming");
   m_streaming = false;
+  m_numQueued = 0;  // STREAMOFF dequeues all buffers
   return true;
 }
 
+void UsbCameraImpl::DeviceRequeueBuffers() {
+  std::vector<std::pair<int, unsigned>> released;
+  {
+    std::scoped_lock lock(m_releasedMutex);
+    if (m_releasedBuffers.empty()) {
+      return;
+    }
+    released.swap(m_releasedBuffers);
+  }
+
+  int fd = m_fd.load();
+  for (auto&& [generation, index] : released) {
+    // ignore buffers from a previous connection
+    if (generation != m_bufferGeneration || !m_bufferHeld[index]) {
+      continue;
+    }
+    m_bufferHeld[index] = false;
+
+    // if not streaming, DeviceStreamOn() will queue it
+    if (!m_streaming || fd < 0) {
+      continue;
+    }
+    struct v4l2_buffer buf;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.index = index;
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (DoIoctl(fd, VIDIOC_QBUF, &buf) != 0) {
+      SWARNING("could not requeue buffer " << index);
+      continue;
+    }
+    ++m_numQueued;
+  }
+}
+
+void UsbCameraImpl::ReleaseBuffer(int generation, unsigned index) {
+  int fd = m_command_fd.load();
+  if (fd < 0) {
+    return;
+  }
+  {
+    std::scoped_lock lock(m_releasedMutex);
+    m_releasedBuffers.emplace_back(generation, index);
+  }
+  // wake up the camera thread to requeue it
+  eventfd_write(fd, 1);
+}
+
 CS_StatusValue UsbCameraImpl::DeviceCmdSetMode(
     std::unique_lock<wpi::mutex>& lock, const Message& msg) {
   VideoMode newMode;
@@ -854,6 +1035,8 @@ CS_StatusValue UsbCameraImpl::DeviceCmdSetProperty(
   if (!prop->device) {
     if (prop->id == kPropConnectVerboseId) {
       m_connectVerbose = value;
+    } else if (prop->id == kPropZeroCopyId) {
+      m_zeroCopy = value;
     }
   } else {
     if (!prop->DeviceSet(lock, m_fd, value, valueStr)) {
@@ -1579,6 +1762,14 @@ std::string GetUsbCameraPath(CS_Source source, CS_Status* status) {
   return static_cast<UsbCameraImpl&>(*data->source).GetPath();
 }
 
+void SetUsbCameraSharedCapture(bool enabled, CS_Status* status) {
+  UsbCaptureLoop::SetSharedEnabled(enabled);
+}
+
+void SetUsbCameraCaptureAffinity(wpi::ArrayRef<int> cpus, CS_Status* status) {
+  UsbCaptureLoop::SetAffinity(cpus);
+}
+
 static const char* symlinkDirs[] = {"/dev/v4l/by-id", "/dev/v4l/by-path"};
 
 UsbCameraInfo GetUsbCameraInfo(CS_Source source, CS_Status* status) {
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include <wpi/STLExtras.h>
+#include <wpi/SmallString.h>
 #include <wpi/SmallVector.h>
 #include <wpi/Twine.h>
 #include <wpi/condition_variable.h>
@@ -32,6 +33,8 @@ class Notifier;
 class Telemetry;
 
 class UsbCameraImpl : public SourceImpl {
+  friend class UsbCaptureLoop;
+
  public:
   UsbCameraImpl(const wpi::Twine& name, wpi::Logger& logger, Notifier& notifier,
                 Telemetry& telemetry, const wpi::Twine& path);
@@ -111,11 +114,29 @@ class UsbCameraImpl : public SourceImpl {
   // The camera processing thread
   void CameraThreadMain();
 
+  // Descriptors the camera thread waits on for reading (-1 if none)
+  struct WaitFds {
+    int command = -1;
+    int device = -1;
+    int notify = -1;
+  };
+
+  // One iteration of the camera thread is DeviceThreadPrepare(), a wait for
+  // the returned descriptors (with the returned timeout in milliseconds), and
+  // DeviceThreadHandle() with the descriptors that are ready.  These are also
+  // run by the shared capture thread (UsbCaptureLoop).
+  void DeviceThreadStart();
+  WaitFds DeviceThreadPrepare(int* timeout);
+  void DeviceThreadHandle(const WaitFds& fds, bool notifyReady,
+                          bool commandReady, bool deviceReady);
+  void DeviceThreadStop();
+
   // Functions used by CameraThreadMain()
   void DeviceDisconnect();
   void DeviceConnect();
   bool DeviceStreamOn();
   bool DeviceStreamOff();
+  void DeviceRequeueBuffers();
   void DeviceProcessCommands();
   void DeviceSetMode();
   void DeviceSetFPS();
@@ -140,6 +161,9 @@ class UsbCameraImpl : public SourceImpl {
 
   void SetQuirks();
 
+  // Called from any thread when a zero-copy frame releases a device buffer
+  void ReleaseBuffer(int generation, unsigned index);
+
   //
   // Variables only used within camera thread
   //
@@ -148,16 +172,38 @@ class UsbCameraImpl : public SourceImpl {
   bool m_modeSetResolution{false};
   bool m_modeSetFPS{false};
   int m_connectVerbose{1};
+  bool m_zeroCopy{false};
   unsigned m_capabilities = 0;
   // Number of buffers to ask OS for
   static constexpr int kNumBuffers = 4;
-  std::array<UsbCameraBuffer, kNumBuffers> m_buffers;
+  // Number of buffers to ask OS for in zero-copy mode
+  static constexpr int kNumZeroCopyBuffers = 8;
+  // Minimum number of buffers that must stay queued to the driver; if handing
+  // out a buffer would drop below this, the frame is copied instead.
+  static constexpr int kMinQueuedBuffers = 2;
+  // Buffers are shared with zero-copy frames so the mapping outlives a
+  // disconnect if a frame is still using it.
+  std::array<std::shared_ptr<UsbCameraBuffer>, kNumZeroCopyBuffers> m_buffers;
+  std::array<bool, kNumZeroCopyBuffers> m_bufferHeld{};
+  int m_numBuffers{0};
+  int m_numQueued{0};
+  int m_bufferGeneration{0};  // incremented when buffers are reallocated
 
   std::atomic_int m_fd;
   std::atomic_int m_command_fd;  // for command eventfd
 
   std::atomic_bool m_active;  // set to false to terminate thread
   std::thread m_cameraThread;
+  // If true, run by the shared capture thread instead of m_cameraThread
+  bool m_sharedCapture{false};
+
+  // Device path notifications
+  int m_notifyFd{-1};
+  std::unique_ptr<wpi::raw_fd_istream> m_notifyIs;
+  wpi::SmallString<64> m_notifyBase;
+  bool m_notified{false};
+  // Used to restart streaming on reconnect
+  bool m_wasStreaming{false};
 
   // Quirks
   bool m_lifecam_exposure{false};    // Microsoft LifeCam exposure
@@ -175,6 +221,11 @@ class UsbCameraImpl : public SourceImpl {
 
   // Path
   std::string m_path;
+
+  // Zero-copy buffers released by frames, waiting to be requeued
+  // (generation, index); protected by m_releasedMutex
+  wpi::mutex m_releasedMutex;
+  std::vector<std::pair<int, unsigned>> m_releasedBuffers;
 };
 
 }  // namespace cs
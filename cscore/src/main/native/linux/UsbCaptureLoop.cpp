@@ -0,0 +1,262 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "UsbCaptureLoop.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <wpi/Logger.h>
+#include <wpi/timestamp.h>
+
+#include "Instance.h"
+#include "Log.h"
+
+using namespace cs;
+
+// Maximum number of events handled per wait
+static constexpr int kMaxEvents = 32;
+
+namespace {
+struct CaptureSettings {
+  wpi::mutex mutex;
+  bool shared = false;
+  std::vector<int> cpus;
+};
+}  // namespace
+
+static CaptureSettings& GetSettings() {
+  static CaptureSettings settings;
+  return settings;
+}
+
+UsbCaptureLoop& UsbCaptureLoop::GetInstance() {
+  // Never destroyed, as cameras may still be removed during shutdown
+  static UsbCaptureLoop* loop = new UsbCaptureLoop;
+  return *loop;
+}
+
+void UsbCaptureLoop::SetSharedEnabled(bool enabled) {
+  auto& settings = GetSettings();
+  std::scoped_lock lock(settings.mutex);
+  settings.shared = enabled;
+}
+
+bool UsbCaptureLoop::IsSharedEnabled() {
+  auto& settings = GetSettings();
+  std::scoped_lock lock(settings.mutex);
+  return settings.shared;
+}
+
+void UsbCaptureLoop::SetAffinity(wpi::ArrayRef<int> cpus) {
+  auto& settings = GetSettings();
+  std::scoped_lock lock(settings.mutex);
+  settings.cpus.assign(cpus.begin(), cpus.end());
+}
+
+void UsbCaptureLoop::ApplyAffinity(wpi::Logger& logger) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  {
+    auto& settings = GetSettings();
+    std::scoped_lock lock(settings.mutex);
+    if (settings.cpus.empty()) {
+      return;
+    }
+    for (int cpu : settings.cpus) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        CPU_SET(cpu, &set);
+      }
+    }
+  }
+  int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (err != 0) {
+    WPI_WARNING(logger, "could not set capture thread CPU affinity: "
+                            << std::strerror(err));
+  }
+}
+
+UsbCaptureLoop::UsbCaptureLoop() {
+  m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+  m_wakeFd = eventfd(0, EFD_CLOEXEC);
+  if (m_epollFd >= 0 && m_wakeFd >= 0) {
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+  }
+}
+
+void UsbCaptureLoop::Add(UsbCameraImpl* camera) {
+  std::scoped_lock lock(m_mutex);
+  m_adding.push_back(camera);
+  if (m_running) {
+    eventfd_write(m_wakeFd, 1);
+    return;
+  }
+
+  // (Re)start the thread; a previous one has exited or is about to
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+  m_running = true;
+  m_thread = std::thread(&UsbCaptureLoop::ThreadMain, this);
+}
+
+void UsbCaptureLoop::Remove(UsbCameraImpl* camera) {
+  std::unique_lock lock(m_mutex);
+
+  // If it hasn't been picked up yet, it has never been run
+  auto it = std::find(m_adding.begin(), m_adding.end(), camera);
+  if (it != m_adding.end()) {
+    m_adding.erase(it);
+    return;
+  }
+
+  m_removing.push_back(camera);
+  eventfd_write(m_wakeFd, 1);
+  m_removedCv.wait(lock, [&] {
+    return std::find(m_removing.begin(), m_removing.end(), camera) ==
+           m_removing.end();
+  });
+}
+
+void UsbCaptureLoop::DeviceClosing(UsbCameraImpl* camera, int fd) {
+  for (auto&& entry : m_entries) {
+    if (entry->camera == camera && entry->fds[kDevice] == fd) {
+      Register(*entry, kDevice, -1);
+      return;
+    }
+  }
+}
+
+void UsbCaptureLoop::Register(Entry& entry, FdKind kind, int fd) {
+  entry.ready[kind] = false;
+  if (entry.fds[kind] == fd) {
+    return;
+  }
+  if (entry.fds[kind] >= 0) {
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, entry.fds[kind], nullptr);
+    entry.fds[kind] = -1;
+  }
+  if (fd >= 0) {
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = &entry.tags[kind];
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      WPI_WARNING(entry.camera->m_logger,
+                  entry.camera->GetName() << ": could not wait on descriptor: "
+                                          << std::strerror(errno));
+      return;
+    }
+    entry.fds[kind] = fd;
+  }
+}
+
+void UsbCaptureLoop::ThreadMain() {
+  auto& logger = Instance::GetInstance().logger;
+  ApplyAffinity(logger);
+
+  struct epoll_event events[kMaxEvents];
+  for (;;) {
+    // Pick up cameras that have been added or removed
+    {
+      std::scoped_lock lock(m_mutex);
+      for (auto camera : m_adding) {
+        m_entries.emplace_back(std::make_unique<Entry>(camera));
+      }
+      m_adding.clear();
+
+      if (!m_removing.empty()) {
+        for (auto camera : m_removing) {
+          auto it = std::find_if(
+              m_entries.begin(), m_entries.end(),
+              [&](const auto& entry) { return entry->camera == camera; });
+          if (it == m_entries.end()) {
+            continue;
+          }
+          for (int i = 0; i < kNumFdKinds; ++i) {
+            Register(**it, static_cast<FdKind>(i), -1);
+          }
+          if ((*it)->started) {
+            camera->DeviceThreadStop();
+          }
+          m_entries.erase(it);
+        }
+        m_removing.clear();
+        m_removedCv.notify_all();
+      }
+
+      if (m_entries.empty()) {
+        m_running = false;
+        return;
+      }
+    }
+
+    // Run the thread iteration of each camera that has a descriptor ready or
+    // has timed out
+    uint64_t now = wpi::Now();
+    uint64_t nextDeadline = UINT64_MAX;
+    for (auto&& entry : m_entries) {
+      bool anyReady = entry->ready[kCommand] || entry->ready[kDevice] ||
+                      entry->ready[kNotify];
+      if (entry->started && !anyReady && now < entry->deadline) {
+        nextDeadline = (std::min)(nextDeadline, entry->deadline);
+        continue;
+      }
+
+      UsbCameraImpl& camera = *entry->camera;
+      if (!entry->started) {
+        camera.DeviceThreadStart();
+        entry->started = true;
+      } else {
+        UsbCameraImpl::WaitFds fds;
+        fds.command = entry->fds[kCommand];
+        fds.device = entry->fds[kDevice];
+        fds.notify = entry->fds[kNotify];
+        camera.DeviceThreadHandle(fds, entry->ready[kNotify],
+                                  entry->ready[kCommand],
+                                  entry->ready[kDevice]);
+      }
+
+      int timeout;
+      auto fds = camera.DeviceThreadPrepare(&timeout);
+      Register(*entry, kCommand, fds.command);
+      Register(*entry, kDevice, fds.device);
+      Register(*entry, kNotify, fds.notify);
+      entry->deadline = wpi::Now() + timeout * 1000;
+      nextDeadline = (std::min)(nextDeadline, entry->deadline);
+    }
+
+    // Wait for the next event or timeout
+    now = wpi::Now();
+    int timeout =
+        nextDeadline <= now ? 0 : (nextDeadline - now + 999) / 1000;
+    int count = epoll_wait(m_epollFd, events, kMaxEvents, timeout);
+    if (count < 0) {
+      if (errno != EINTR) {
+        WPI_ERROR(logger, "epoll_wait(): " << std::strerror(errno));
+      }
+      continue;
+    }
+    for (int i = 0; i < count; ++i) {
+      auto tag = static_cast<Tag*>(events[i].data.ptr);
+      if (!tag) {
+        // Read it to clear
+        eventfd_t val;
+        eventfd_read(m_wakeFd, &val);
+        continue;
+      }
+      tag->entry->ready[tag->kind] = true;
+    }
+  }
+}
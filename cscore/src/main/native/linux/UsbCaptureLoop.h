@@ -0,0 +1,113 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef CSCORE_USBCAPTURELOOP_H_
+#define CSCORE_USBCAPTURELOOP_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <wpi/ArrayRef.h>
+#include <wpi/condition_variable.h>
+#include <wpi/mutex.h>
+
+#include "UsbCameraImpl.h"
+
+namespace wpi {
+class Logger;
+}  // namespace wpi
+
+namespace cs {
+
+// Capture thread shared by all USB cameras started while shared capture is
+// enabled.  Instead of each camera waiting on its own descriptors in its own
+// thread, this waits on the descriptors of every camera with a single epoll
+// set, and runs the thread iteration of each camera whose descriptors are
+// ready or whose timeout has expired.  Frames are dequeued and published to
+// each source (and on to its sinks) from this thread.
+//
+// The thread is started when the first camera is added, and exits when the
+// last one is removed.
+class UsbCaptureLoop {
+ public:
+  static UsbCaptureLoop& GetInstance();
+
+  // Sets whether cameras started from now on use the shared thread
+  static void SetSharedEnabled(bool enabled);
+  static bool IsSharedEnabled();
+
+  // Sets the CPUs capture threads (shared or per camera) started from now on
+  // are allowed to run on; empty to not restrict them
+  static void SetAffinity(wpi::ArrayRef<int> cpus);
+
+  // Applies the configured affinity to the calling thread
+  static void ApplyAffinity(wpi::Logger& logger);
+
+  UsbCaptureLoop();
+  UsbCaptureLoop(const UsbCaptureLoop&) = delete;
+  UsbCaptureLoop& operator=(const UsbCaptureLoop&) = delete;
+
+  // Starts running the camera's thread iterations
+  void Add(UsbCameraImpl* camera);
+
+  // Stops running the camera's thread iterations, and waits until the camera
+  // is no longer referenced by the thread
+  void Remove(UsbCameraImpl* camera);
+
+  // Called on the thread when a camera is about to close its device
+  void DeviceClosing(UsbCameraImpl* camera, int fd);
+
+ private:
+  enum FdKind { kCommand = 0, kDevice, kNotify, kNumFdKinds };
+
+  struct Entry;
+
+  // Identifies the descriptor an epoll event is for
+  struct Tag {
+    Entry* entry;
+    FdKind kind;
+  };
+
+  struct Entry {
+    explicit Entry(UsbCameraImpl* camera_) : camera{camera_} {
+      for (int i = 0; i < kNumFdKinds; ++i) {
+        tags[i] = Tag{this, static_cast<FdKind>(i)};
+      }
+    }
+
+    UsbCameraImpl* camera;
+    int fds[kNumFdKinds] = {-1, -1, -1};  // descriptors registered
+    bool ready[kNumFdKinds] = {false, false, false};
+    Tag tags[kNumFdKinds];
+    uint64_t deadline = 0;  // wpi::Now() time of the camera's wait timeout
+    bool started = false;
+  };
+
+  void ThreadMain();
+  void Register(Entry& entry, FdKind kind, int fd);
+
+  int m_epollFd = -1;
+  int m_wakeFd = -1;  // eventfd to wake the thread
+
+  // Only used within the thread
+  std::vector<std::unique_ptr<Entry>> m_entries;
+
+  wpi::mutex m_mutex;
+  wpi::condition_variable m_removedCv;
+  std::thread m_thread;
+
+  //
+  // Variables protected by m_mutex
+  //
+  bool m_running = false;
+  std::vector<UsbCameraImpl*> m_adding;
+  std::vector<UsbCameraImpl*> m_removing;
+};
+
+}  // namespace cs
+
+#endif  // CSCORE_USBCAPTURELOOP_H_
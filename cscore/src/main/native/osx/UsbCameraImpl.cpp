@@ -33,6 +33,14 @@ UsbCameraInfo GetUsbCameraInfo(CS_Source source, CS_Status* status) {
   return UsbCameraInfo{};
 }
 
+void SetUsbCameraSharedCapture(bool enabled, CS_Status* status) {
+  // not supported; each camera has its own thread
+}
+
+void SetUsbCameraCaptureAffinity(wpi::ArrayRef<int> cpus, CS_Status* status) {
+  // not supported
+}
+
 std::vector<UsbCameraInfo> EnumerateUsbCameras(CS_Status* status) {
   *status = CS_INVALID_HANDLE;
   return std::vector<UsbCameraInfo>{};
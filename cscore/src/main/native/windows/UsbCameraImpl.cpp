@@ -1029,6 +1029,14 @@ static void ParseVidAndPid(wpi::StringRef path, int* pid, int* vid) {
   }
 }
 
+void SetUsbCameraSharedCapture(bool enabled, CS_Status* status) {
+  // not supported; cameras are serviced by the message pump thread
+}
+
+void SetUsbCameraCaptureAffinity(wpi::ArrayRef<int> cpus, CS_Status* status) {
+  // not supported
+}
+
 std::vector<UsbCameraInfo> EnumerateUsbCameras(CS_Status* status) {
   std::vector<UsbCameraInfo> retval;
 
@@ -0,0 +1,122 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "ColorConvert.h"  // NOLINT(build/include_order)
+
+#include <stdint.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace cs {
+
+namespace {
+
+using ConvertFunc = void (*)(const uint8_t* src, uint8_t* dst, size_t pixels);
+
+// Image sizes; odd dimensions (and odd pixel counts) leave tails for the
+// vector loops to hand to the scalar code
+struct Size {
+  int width;
+  int height;
+};
+constexpr Size kSizes[] = {{1, 1},  {2, 1},   {3, 3},   {5, 7},   {15, 1},
+                           {17, 3}, {31, 5},  {33, 9},  {63, 3},  {65, 7},
+                           {97, 1}, {160, 7}, {161, 9}, {641, 3}};
+
+// Vector implementations; those not available are skipped
+constexpr const char* kImpls[] = {"avx2", "sse2", "neon"};
+
+// Bytes past the end of the output that must not be written
+constexpr size_t kGuardSize = 64;
+constexpr uint8_t kGuard = 0xa5;
+
+class ColorConvertTest : public ::testing::Test {
+ protected:
+  ColorConvertTest() : m_default{GetColorConvertImpl()} {}
+  ~ColorConvertTest() override { SetColorConvertImpl(m_default.c_str()); }
+
+  // Checks each vector implementation of func against the scalar one.  For
+  // YUYV input the width is rounded up to even.
+  void Check(ConvertFunc func, size_t srcBpp, size_t dstBpp, bool yuyv) {
+    std::mt19937 gen{12345};
+    std::uniform_int_distribution<int> dist{0, 255};
+    for (auto size : kSizes) {
+      int width = yuyv ? (size.width + 1) & ~1 : size.width;
+      size_t pixels = static_cast<size_t>(width) * size.height;
+      std::vector<uint8_t> src(pixels * srcBpp);
+      for (auto&& byte : src) {
+        byte = dist(gen);
+      }
+
+      ASSERT_TRUE(SetColorConvertImpl("scalar"));
+      auto expected = Convert(func, src, pixels, dstBpp);
+
+      for (auto impl : kImpls) {
+        if (!SetColorConvertImpl(impl)) {
+          continue;
+        }
+        SCOPED_TRACE(std::string{impl} + " " + std::to_string(width) + "x" +
+                     std::to_string(size.height));
+        auto actual = Convert(func, src, pixels, dstBpp);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < pixels * dstBpp; ++i) {
+          ASSERT_EQ(actual[i], expected[i]) << "at byte " << i;
+        }
+        for (size_t i = pixels * dstBpp; i < actual.size(); ++i) {
+          ASSERT_EQ(actual[i], kGuard) << "wrote past end at byte " << i;
+        }
+      }
+    }
+  }
+
+ private:
+  static std::vector<uint8_t> Convert(ConvertFunc func,
+                                      const std::vector<uint8_t>& src,
+                                      size_t pixels, size_t dstBpp) {
+    std::vector<uint8_t> dst(pixels * dstBpp + kGuardSize, kGuard);
+    func(src.data(), dst.data(), pixels);
+    return dst;
+  }
+
+  std::string m_default;
+};
+
+}  // namespace
+
+TEST_F(ColorConvertTest, YUYVToBGR) {
+  Check(YUYVToBGR, 2, 3, true);
+}
+
+TEST_F(ColorConvertTest, YUYVToGray) {
+  Check(YUYVToGray, 2, 1, true);
+}
+
+TEST_F(ColorConvertTest, BGRToRGB565) {
+  Check(BGRToRGB565, 3, 2, false);
+}
+
+TEST_F(ColorConvertTest, RGB565ToBGR) {
+  Check(RGB565ToBGR, 2, 3, false);
+}
+
+TEST_F(ColorConvertTest, BGRToGray) {
+  Check(BGRToGray, 3, 1, false);
+}
+
+TEST_F(ColorConvertTest, GrayToBGR) {
+  Check(GrayToBGR, 1, 3, false);
+}
+
+TEST_F(ColorConvertTest, SetImpl) {
+  EXPECT_TRUE(SetColorConvertImpl("scalar"));
+  EXPECT_STREQ(GetColorConvertImpl(), "scalar");
+  EXPECT_FALSE(SetColorConvertImpl("unknown"));
+  EXPECT_STREQ(GetColorConvertImpl(), "scalar");
+}
+
+}  // namespace cs
@@ -0,0 +1,58 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "Telemetry.h"  // NOLINT(build/include_order)
+
+#include "gtest/gtest.h"
+
+namespace cs {
+
+TEST(TelemetryCountersTest, Counter) {
+  TelemetryCounters counters;
+  counters.Add(CS_SOURCE_BYTES_RECEIVED, 100);
+  counters.Add(CS_SOURCE_BYTES_RECEIVED, 50);
+
+  auto snapshot = counters.Collect(CS_SOURCE_BYTES_RECEIVED);
+  int64_t value = 0;
+  ASSERT_TRUE(TelemetryCounters::GetPublishedValue(CS_SOURCE_BYTES_RECEIVED,
+                                                   snapshot, &value));
+  EXPECT_EQ(value, 150);
+
+  // collecting resets the total
+  snapshot = counters.Collect(CS_SOURCE_BYTES_RECEIVED);
+  EXPECT_FALSE(TelemetryCounters::GetPublishedValue(CS_SOURCE_BYTES_RECEIVED,
+                                                    snapshot, &value));
+}
+
+TEST(TelemetryCountersTest, Average) {
+  TelemetryCounters counters;
+  counters.Record(CS_SOURCE_CAPTURE_LATENCY, 10);
+  counters.Record(CS_SOURCE_CAPTURE_LATENCY, 30);
+
+  auto snapshot = counters.Collect(CS_SOURCE_CAPTURE_LATENCY);
+  EXPECT_EQ(snapshot.count, 2);
+  int64_t value = 0;
+  ASSERT_TRUE(TelemetryCounters::GetPublishedValue(CS_SOURCE_CAPTURE_LATENCY,
+                                                   snapshot, &value));
+  EXPECT_EQ(value, 20);
+  EXPECT_EQ(snapshot.buckets[4], 1);  // [8, 16)
+  EXPECT_EQ(snapshot.buckets[5], 1);  // [16, 32)
+
+  // a period with no samples has no average
+  snapshot = counters.Collect(CS_SOURCE_CAPTURE_LATENCY);
+  EXPECT_FALSE(TelemetryCounters::GetPublishedValue(CS_SOURCE_CAPTURE_LATENCY,
+                                                    snapshot, &value));
+}
+
+TEST(TelemetryCountersTest, AverageWithoutCount) {
+  // a sum without a count (from a sample recorded while collecting) is not
+  // divided by zero
+  TelemetryCounters::Snapshot snapshot;
+  snapshot.sum = 100;
+  int64_t value = 0;
+  EXPECT_FALSE(TelemetryCounters::GetPublishedValue(CS_SOURCE_CAPTURE_LATENCY,
+                                                    snapshot, &value));
+}
+
+}  // namespace cs
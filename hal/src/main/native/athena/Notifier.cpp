@@ -9,6 +9,7 @@
 #include <memory>
 #include <thread>
 
+#include <wpi/Trace.h>
 #include <wpi/condition_variable.h>
 #include <wpi/mutex.h>
 
@@ -257,6 +258,7 @@ uint64_t HAL_WaitForNotifierAlarm(HAL_NotifierHandle notifierHandle,
   auto notifier = notifierHandles->Get(notifierHandle);
   if (!notifier)
     return 0;
+  WPI_TRACE_SPAN("HAL_WaitForNotifierAlarm");
   std::unique_lock lock(notifier->mutex);
   notifier->cond.wait(lock, [&] {
     return !notifier->active || notifier->triggeredTime != UINT64_MAX;
@@ -11,6 +11,7 @@
 #include <string>
 
 #include <wpi/SmallVector.h>
+#include <wpi/Trace.h>
 #include <wpi/condition_variable.h>
 #include <wpi/mutex.h>
 
@@ -255,6 +256,7 @@ uint64_t HAL_WaitForNotifierAlarm(HAL_NotifierHandle notifierHandle,
     return 0;
   }
 
+  WPI_TRACE_SPAN("HAL_WaitForNotifierAlarm");
   std::unique_lock ulock(notifiersWaiterMutex);
   std::unique_lock lock(notifier->mutex);
   notifier->waitingForAlarm = true;
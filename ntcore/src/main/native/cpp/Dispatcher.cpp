@@ -9,6 +9,7 @@
 
 #include <wpi/TCPAcceptor.h>
 #include <wpi/TCPConnector.h>
+#include <wpi/Trace.h>
 #include <wpi/timestamp.h>
 
 #include "IConnectionNotifier.h"
@@ -334,6 +335,7 @@ void DispatcherBase::ClearConnectorOverride() {
 }
 
 void DispatcherBase::DispatchThreadMain() {
+  wpi::trace::SetThreadName("NT Dispatch");
   auto timeout_time = std::chrono::steady_clock::now();
 
   static const auto save_delta_time = std::chrono::seconds(1);
@@ -358,6 +360,7 @@ void DispatcherBase::DispatchThreadMain() {
     if (!m_active) {
       break;  // in case we were woken up to terminate
     }
+    WPI_TRACE_SPAN("NT dispatch");
 
     // perform periodic persistent save
     if ((m_networkMode & NT_NET_MODE_SERVER) != 0 &&
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include <wpi/NetworkStream.h>
+#include <wpi/Trace.h>
 #include <wpi/raw_socket_istream.h>
 #include <wpi/timestamp.h>
 
@@ -148,6 +149,7 @@ void NetworkConnection::set_remote_id(StringRef remote_id) {
 }
 
 void NetworkConnection::ReadThreadMain() {
+  wpi::trace::SetThreadName("NT Read");
   wpi::raw_socket_istream is(*m_stream);
   WireDecoder decoder(is, m_proto_rev, m_logger);
 
@@ -192,6 +194,7 @@ void NetworkConnection::ReadThreadMain() {
                             << " id=" << msg->id()
                             << " seq_num=" << msg->seq_num_uid());
     m_last_update = Now();
+    WPI_TRACE_SPAN("NT process incoming");
     m_process_incoming(std::move(msg), this);
   }
   DEBUG2("read thread died (" << this << ")");
@@ -209,6 +212,7 @@ done:
 }
 
 void NetworkConnection::WriteThreadMain() {
+  wpi::trace::SetThreadName("NT Write");
   WireEncoder encoder(m_proto_rev);
 
   while (m_active) {
@@ -217,6 +221,7 @@ void NetworkConnection::WriteThreadMain() {
     if (msgs.empty()) {
       continue;
     }
+    WPI_TRACE_SPAN("NT write");
     encoder.set_proto_rev(m_proto_rev);
     encoder.Reset();
     DEBUG3("sending " << msgs.size() << " messages");
@@ -16,6 +16,7 @@
 #include <networktables/NetworkTableEntry.h>
 #include <wpi/DenseMap.h>
 #include <wpi/SmallVector.h>
+#include <wpi/Trace.h>
 #include <wpi/raw_ostream.h>
 
 #include "frc2/command/CommandGroupBase.h"
@@ -191,6 +192,7 @@ void CommandScheduler::Run() {
     return;
   }
 
+  WPI_TRACE_SPAN("CommandScheduler::Run");
   m_watchdog.Reset();
 
   // Run the periodic method of all registered subsystems.
@@ -11,6 +11,7 @@
 #include <hal/DriverStation.h>
 #include <hal/FRCUsageReporting.h>
 #include <hal/Notifier.h>
+#include <wpi/Trace.h>
 
 #include "frc/Timer.h"
 #include "frc/Utility.h"
@@ -46,7 +47,10 @@ void TimedRobot::StartCompetition() {
       break;
     }
 
-    callback.func();
+    {
+      WPI_TRACE_SPAN("TimedRobot callback");
+      callback.func();
+    }
 
     callback.expirationTime += callback.period;
     m_callbacks.push(std::move(callback));
@@ -56,7 +60,10 @@ void TimedRobot::StartCompetition() {
            curTime) {
       callback = m_callbacks.pop();
 
-      callback.func();
+      {
+        WPI_TRACE_SPAN("TimedRobot callback");
+        callback.func();
+      }
 
       callback.expirationTime += callback.period;
       m_callbacks.push(std::move(callback));
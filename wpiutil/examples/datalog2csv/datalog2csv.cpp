@@ -0,0 +1,185 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "wpi/DataLogReader.h"
+#include "wpi/DenseMap.h"
+#include "wpi/Format.h"
+#include "wpi/StringRef.h"
+#include "wpi/raw_ostream.h"
+
+// Converts a data log to CSV, with a column for each selected entry and a row
+// for each distinct timestamp (in seconds).  Cells of entries without a value
+// at a timestamp are left empty.
+//
+// usage: datalog2csv [-b begin] [-e end] file.wpilog [entry...]
+//
+// If no entries are given, all entries are included.  begin and end limit
+// the rows to a time range, in seconds.
+
+static void Usage() {
+  wpi::errs() << "usage: datalog2csv [-b begin] [-e end] file.wpilog "
+                 "[entry...]\n";
+  std::exit(1);
+}
+
+static void WriteQuoted(wpi::raw_ostream& os, wpi::StringRef str) {
+  os << '"';
+  for (char ch : str) {
+    if (ch == '"') {
+      os << '"';
+    }
+    os << ch;
+  }
+  os << '"';
+}
+
+static void WriteValue(wpi::raw_ostream& os, wpi::StringRef type,
+                       const wpi::log::DataLogRecord& record) {
+  if (type == "double") {
+    double value;
+    if (record.GetDouble(&value)) {
+      os << wpi::format("%.17g", value);
+    }
+  } else if (type == "float") {
+    float value;
+    if (record.GetFloat(&value)) {
+      os << wpi::format("%.9g", value);
+    }
+  } else if (type == "int64") {
+    int64_t value;
+    if (record.GetInteger(&value)) {
+      os << value;
+    }
+  } else if (type == "boolean") {
+    bool value;
+    if (record.GetBoolean(&value)) {
+      os << (value ? "true" : "false");
+    }
+  } else if (type == "string" || type == "json") {
+    wpi::StringRef value;
+    record.GetString(&value);
+    WriteQuoted(os, value);
+  } else if (type == "double[]") {
+    std::vector<double> arr;
+    if (record.GetDoubleArray(&arr)) {
+      os << '"';
+      bool first = true;
+      for (double value : arr) {
+        if (!first) {
+          os << ';';
+        }
+        first = false;
+        os << wpi::format("%.17g", value);
+      }
+      os << '"';
+    }
+  } else {
+    // unknown types are written as the size of the data
+    os << "<" << record.GetSize() << " bytes>";
+  }
+}
+
+int main(int argc, char** argv) {
+  int64_t begin = std::numeric_limits<int64_t>::min();
+  int64_t end = std::numeric_limits<int64_t>::max();
+  int arg = 1;
+  for (; arg < argc && argv[arg][0] == '-'; ++arg) {
+    wpi::StringRef opt{argv[arg]};
+    if ((opt != "-b" && opt != "-e") || arg + 1 >= argc) {
+      Usage();
+    }
+    char* endp;
+    double seconds = std::strtod(argv[++arg], &endp);
+    if (*endp != '\0') {
+      Usage();
+    }
+    (opt == "-b" ? begin : end) = static_cast<int64_t>(seconds * 1.0e6);
+  }
+  if (arg >= argc) {
+    Usage();
+  }
+
+  std::error_code ec;
+  wpi::log::DataLogReader reader{argv[arg], ec};
+  if (ec) {
+    wpi::errs() << "could not open '" << argv[arg] << "': " << ec.message()
+                << '\n';
+    return 1;
+  }
+  if (!reader) {
+    wpi::errs() << "'" << argv[arg] << "' is not a data log\n";
+    return 1;
+  }
+  ++arg;
+
+  // columns, by name; entries that were restarted share their column
+  std::vector<wpi::StringRef> columns;
+  for (; arg < argc; ++arg) {
+    columns.emplace_back(argv[arg]);
+  }
+  bool all = columns.empty();
+
+  struct Column {
+    size_t index;
+    wpi::StringRef type;
+  };
+  wpi::DenseMap<int, Column> entries;
+  for (auto&& entry : reader.GetEntries()) {
+    auto it = std::find(columns.begin(), columns.end(), entry.start.name);
+    if (it == columns.end()) {
+      if (!all) {
+        continue;
+      }
+      it = columns.insert(columns.end(), entry.start.name);
+    }
+    entries[entry.start.entry] = {static_cast<size_t>(it - columns.begin()),
+                                  entry.start.type};
+  }
+
+  auto& os = wpi::outs();
+  os << "Timestamp";
+  for (auto&& column : columns) {
+    os << ',';
+    WriteQuoted(os, column);
+  }
+  os << '\n';
+
+  // the records are in timestamp order; gather the cells of each row
+  std::vector<std::string> cells(columns.size());
+  int64_t rowTimestamp = 0;
+  bool haveRow = false;
+  auto writeRow = [&] {
+    os << wpi::format("%.6f", rowTimestamp / 1.0e6);
+    for (auto&& cell : cells) {
+      os << ',' << cell;
+      cell.clear();
+    }
+    os << '\n';
+  };
+  for (auto&& record : reader.GetRecords(begin, end)) {
+    auto it = entries.find(record.GetEntry());
+    if (it == entries.end()) {
+      continue;
+    }
+    if (haveRow && record.GetTimestamp() != rowTimestamp) {
+      writeRow();
+    }
+    rowTimestamp = record.GetTimestamp();
+    haveRow = true;
+    auto& cell = cells[it->second.index];
+    cell.clear();
+    wpi::raw_string_ostream cellOs{cell};
+    WriteValue(cellOs, it->second.type, record);
+  }
+  if (haveRow) {
+    writeRow();
+  }
+  os.flush();
+}
@@ -0,0 +1,78 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/AsyncLogger.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "wpi/raw_ostream.h"
+
+using namespace wpi;
+
+AsyncLogger::AsyncLogger(Logger::LogFunc func, size_t capacity)
+    : m_func{std::move(func)}, m_queue{capacity} {
+  m_thread = std::thread([this] { ThreadMain(); });
+}
+
+AsyncLogger::~AsyncLogger() {
+  // control records wait for room rather than being dropped
+  m_queue.emplace(kStop, 0, nullptr, 0, "");
+  m_thread.join();
+}
+
+void AsyncLogger::Log(unsigned int level, const char* file, unsigned int line,
+                      const char* msg) {
+  if (!m_queue.try_emplace(kMessage, level, file, line, msg)) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void AsyncLogger::Flush() {
+  std::unique_lock lock(m_flushMutex);
+  uint64_t id = ++m_nextFlushId;
+  lock.unlock();
+  // concurrent flushes may be queued in any order, so each waits for its own
+  // record
+  m_queue.emplace(kFlush, 0, nullptr, 0, "", id);
+  lock.lock();
+  auto done = m_flushesDone.end();
+  m_flushCond.wait(lock, [&] {
+    done = std::find(m_flushesDone.begin(), m_flushesDone.end(), id);
+    return done != m_flushesDone.end();
+  });
+  m_flushesDone.erase(done);
+}
+
+void AsyncLogger::ThreadMain() {
+  uint64_t reported = 0;
+  Record record;
+  for (;;) {
+    m_queue.pop(record);
+
+    // report drops before the first message handled after them
+    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != reported) {
+      SmallString<64> buf;
+      raw_svector_ostream os{buf};
+      os << "dropped " << (dropped - reported) << " log messages";
+      m_func(WPI_LOG_WARNING, __FILE__, __LINE__, buf.c_str());
+      reported = dropped;
+    }
+
+    switch (record.kind) {
+      case kMessage:
+        m_func(record.level, record.file, record.line, record.msg.c_str());
+        break;
+      case kFlush: {
+        std::scoped_lock lock(m_flushMutex);
+        m_flushesDone.push_back(record.flushId);
+        m_flushCond.notify_all();
+        break;
+      }
+      case kStop:
+        return;
+    }
+  }
+}
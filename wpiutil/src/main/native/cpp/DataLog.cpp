@@ -0,0 +1,513 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/DataLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+#include "wpi/Endian.h"
+#include "wpi/Path.h"
+#include "wpi/SmallString.h"
+#include "wpi/SmallVector.h"
+#include "wpi/raw_ostream.h"
+#include "wpi/timestamp.h"
+
+using namespace wpi::log;
+
+static constexpr size_t kRecordHeaderSize = 16;
+static constexpr uint8_t kControlStart = 0;
+static constexpr uint8_t kControlFinish = 1;
+
+// Size of the file output buffer; records are written to the file in chunks
+// of this size
+static constexpr size_t kWriteBufferSize = 256 * 1024;
+
+static std::atomic<uint64_t> gNextSerial{1};
+
+static void WriteRecordHeader(uint8_t* buf, uint32_t entry, uint32_t size,
+                              int64_t timestamp) {
+  wpi::support::endian::write32le(buf, entry);
+  wpi::support::endian::write32le(buf + 4, size);
+  wpi::support::endian::write64le(buf + 8, timestamp);
+}
+
+static void AppendString(std::vector<uint8_t>& buf, wpi::StringRef str) {
+  size_t pos = buf.size();
+  buf.resize(pos + 4 + str.size());
+  wpi::support::endian::write32le(&buf[pos], str.size());
+  std::memcpy(&buf[pos + 4], str.data(), str.size());
+}
+
+// Calls func for each record in a buffer of complete records
+template <typename F>
+static void ForEachRecord(wpi::ArrayRef<uint8_t> records, F&& func) {
+  while (records.size() >= kRecordHeaderSize) {
+    size_t size = kRecordHeaderSize +
+                  wpi::support::endian::read32le(records.data() + 4);
+    func(records.take_front(size));
+    records = records.drop_front(size);
+  }
+}
+
+// Record buffer of one thread.  This is a single-producer, single-consumer
+// ring of bytes: the owning thread copies records (in their file format) in
+// at the tail, and the writer thread copies them out from the head.  The
+// positions only ever increase; they are masked to index the ring.
+class DataLog::ThreadBuffer {
+ public:
+  explicit ThreadBuffer(size_t size) {
+    size_t capacity = 64;
+    while (capacity < size) {
+      capacity <<= 1;
+    }
+    m_data = std::make_unique<uint8_t[]>(capacity);
+    m_mask = capacity - 1;
+  }
+
+  // Called on the owning thread
+  bool Push(uint32_t entry, int64_t timestamp, wpi::ArrayRef<uint8_t> data) {
+    size_t size = kRecordHeaderSize + data.size();
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail + size - m_head.load(std::memory_order_acquire) > m_mask + 1) {
+      return false;
+    }
+    uint8_t header[kRecordHeaderSize];
+    WriteRecordHeader(header, entry, data.size(), timestamp);
+    Copy(tail, header);
+    Copy(tail + kRecordHeaderSize, data);
+    m_tail.store(tail + size, std::memory_order_release);
+    return true;
+  }
+
+  // Called on the writer thread; gets the current end of the records
+  uint64_t GetTail() const { return m_tail.load(std::memory_order_acquire); }
+
+  bool IsEmpty() const {
+    return m_head.load(std::memory_order_relaxed) == GetTail();
+  }
+
+  // Called on the writer thread; calls func for each record up to tail and
+  // frees their space
+  template <typename F>
+  void Drain(uint64_t tail, F&& func) {
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    while (head < tail) {
+      size_t begin = head & m_mask;
+      size_t size = kRecordHeaderSize;
+      if (begin + 8 <= m_mask + 1) {
+        size += wpi::support::endian::read32le(&m_data[begin + 4]);
+      } else {
+        uint8_t header[8];
+        for (size_t i = 0; i < 8; ++i) {
+          header[i] = m_data[(head + i) & m_mask];
+        }
+        size += wpi::support::endian::read32le(header + 4);
+      }
+      if (begin + size <= m_mask + 1) {
+        func(wpi::ArrayRef<uint8_t>(&m_data[begin], size));
+      } else {
+        // record wraps around the end of the ring
+        size_t first = m_mask + 1 - begin;
+        m_wrapped.resize(size);
+        std::memcpy(m_wrapped.data(), &m_data[begin], first);
+        std::memcpy(m_wrapped.data() + first, &m_data[0], size - first);
+        func(wpi::ArrayRef<uint8_t>(m_wrapped));
+      }
+      head += size;
+    }
+    m_head.store(head, std::memory_order_release);
+  }
+
+  // Set when the owning thread exits; the writer thread releases the buffer
+  // once it is empty
+  std::atomic<bool> orphaned{false};
+  // Set when the log is destroyed; the owning thread stops using the buffer
+  std::atomic<bool> detached{false};
+
+ private:
+  void Copy(uint64_t pos, wpi::ArrayRef<uint8_t> data) {
+    size_t begin = pos & m_mask;
+    size_t first = (std::min)(data.size(), m_mask + 1 - begin);
+    std::memcpy(&m_data[begin], data.data(), first);
+    if (first < data.size()) {
+      std::memcpy(&m_data[0], data.data() + first, data.size() - first);
+    }
+  }
+
+  std::unique_ptr<uint8_t[]> m_data;
+  size_t m_mask;
+  // Keep the producer and consumer positions on separate cache lines
+  alignas(64) std::atomic<uint64_t> m_tail{0};
+  alignas(64) std::atomic<uint64_t> m_head{0};
+  // Only used by the writer thread
+  std::vector<uint8_t> m_wrapped;
+};
+
+static std::string MakeFilename(const wpi::Twine& dir,
+                               const wpi::Twine& filename) {
+  wpi::SmallString<128> path;
+  dir.toVector(path);
+  if (filename.isTriviallyEmpty() ||
+      (filename.isSingleStringRef() && filename.getSingleStringRef().empty())) {
+    std::time_t now = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "wpilog_%Y%m%d_%H%M%S.wpilog",
+                  std::localtime(&now));
+    wpi::sys::path::append(path, buf);
+  } else {
+    wpi::sys::path::append(path, filename);
+  }
+  return path.str();
+}
+
+DataLog::DataLog(const Twine& dir, const Twine& filename, double period,
+                 uint64_t maxFileSize, size_t bufferSize)
+    : m_serial{gNextSerial++},
+      m_bufferSize{bufferSize},
+      m_period{period},
+      m_maxFileSize{maxFileSize},
+      m_filename{MakeFilename(dir, filename)} {
+  m_currentFilename = m_filename;
+  OpenFile();
+  m_thread = std::thread([this] { WriterThreadMain(); });
+}
+
+DataLog::~DataLog() {
+  {
+    std::scoped_lock lock(m_mutex);
+    m_shutdown = true;
+  }
+  m_cond.notify_one();
+  m_thread.join();
+  for (auto&& buf : m_buffers) {
+    buf->detached = true;
+  }
+}
+
+std::string DataLog::GetFilename() const {
+  std::scoped_lock lock(m_mutex);
+  return m_currentFilename;
+}
+
+void DataLog::Flush() {
+  {
+    std::scoped_lock lock(m_mutex);
+    m_doFlush = true;
+  }
+  m_cond.notify_one();
+}
+
+int DataLog::Start(StringRef name, StringRef type, StringRef metadata,
+                   int64_t timestamp) {
+  if (timestamp == 0) {
+    timestamp = wpi::Now();
+  }
+  std::scoped_lock lock(m_mutex);
+  auto& entry = m_entryIds[name];
+  if (entry != 0) {
+    return entry;
+  }
+  entry = m_nextEntry++;
+
+  // control records are built in place in their file format
+  auto& buf = m_pendingStarts;
+  size_t pos = buf.size();
+  buf.resize(pos + kRecordHeaderSize + 5);
+  buf[pos + kRecordHeaderSize] = kControlStart;
+  support::endian::write32le(&buf[pos + kRecordHeaderSize + 1], entry);
+  ::AppendString(buf, name);
+  ::AppendString(buf, type);
+  ::AppendString(buf, metadata);
+  WriteRecordHeader(&buf[pos], 0, buf.size() - pos - kRecordHeaderSize,
+                    timestamp);
+  return entry;
+}
+
+void DataLog::Finish(int entry, int64_t timestamp) {
+  if (entry <= 0) {
+    return;
+  }
+  if (timestamp == 0) {
+    timestamp = wpi::Now();
+  }
+  std::scoped_lock lock(m_mutex);
+  for (auto&& id : m_entryIds) {
+    if (id.second == entry) {
+      m_entryIds.erase(id.getKey());
+      break;
+    }
+  }
+  auto& buf = m_pendingFinishes;
+  size_t pos = buf.size();
+  buf.resize(pos + kRecordHeaderSize + 5);
+  WriteRecordHeader(&buf[pos], 0, 5, timestamp);
+  buf[pos + kRecordHeaderSize] = kControlFinish;
+  support::endian::write32le(&buf[pos + kRecordHeaderSize + 1], entry);
+}
+
+uint64_t DataLog::GetDroppedCount() const {
+  return m_dropped.load(std::memory_order_relaxed);
+}
+
+DataLog::ThreadBuffer* DataLog::GetThreadBuffer() {
+  // Buffers of the calling thread, by log serial
+  struct Buffers {
+    ~Buffers() {
+      for (auto&& buf : buffers) {
+        buf.second->orphaned = true;
+      }
+    }
+    std::vector<std::pair<uint64_t, std::shared_ptr<ThreadBuffer>>> buffers;
+  };
+  static thread_local Buffers tls;
+  static thread_local std::pair<uint64_t, ThreadBuffer*> last{0, nullptr};
+
+  if (last.first == m_serial) {
+    return last.second;
+  }
+  auto& buffers = tls.buffers;
+  for (auto it = buffers.begin(); it != buffers.end();) {
+    if (it->first == m_serial) {
+      last = {m_serial, it->second.get()};
+      return last.second;
+    }
+    // release buffers of destroyed logs
+    if (it->second->detached) {
+      it = buffers.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // first append from this thread
+  auto buf = std::make_shared<ThreadBuffer>(m_bufferSize);
+  {
+    std::scoped_lock lock(m_mutex);
+    m_buffers.emplace_back(buf);
+  }
+  buffers.emplace_back(m_serial, buf);
+  last = {m_serial, buf.get()};
+  return last.second;
+}
+
+bool DataLog::Append(int entry, int64_t timestamp, ArrayRef<uint8_t> data) {
+  if (entry <= 0) {
+    return false;
+  }
+  if (timestamp == 0) {
+    timestamp = wpi::Now();
+  }
+  if (!GetThreadBuffer()->Push(entry, timestamp, data)) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+bool DataLog::AppendRaw(int entry, ArrayRef<uint8_t> data, int64_t timestamp) {
+  return Append(entry, timestamp, data);
+}
+
+bool DataLog::AppendBoolean(int entry, bool value, int64_t timestamp) {
+  uint8_t buf = value ? 1 : 0;
+  return Append(entry, timestamp, buf);
+}
+
+bool DataLog::AppendInteger(int entry, int64_t value, int64_t timestamp) {
+  uint8_t buf[8];
+  support::endian::write64le(buf, value);
+  return Append(entry, timestamp, buf);
+}
+
+bool DataLog::AppendFloat(int entry, float value, int64_t timestamp) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uint8_t buf[4];
+  support::endian::write32le(buf, bits);
+  return Append(entry, timestamp, buf);
+}
+
+bool DataLog::AppendDouble(int entry, double value, int64_t timestamp) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  uint8_t buf[8];
+  support::endian::write64le(buf, bits);
+  return Append(entry, timestamp, buf);
+}
+
+bool DataLog::AppendString(int entry, StringRef value, int64_t timestamp) {
+  return Append(
+      entry, timestamp,
+      {reinterpret_cast<const uint8_t*>(value.data()), value.size()});
+}
+
+bool DataLog::AppendDoubleArray(int entry, ArrayRef<double> arr,
+                                int64_t timestamp) {
+  SmallVector<uint8_t, 128> buf;
+  buf.resize(arr.size() * 8);
+  uint8_t* out = buf.data();
+  for (double value : arr) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    support::endian::write64le(out, bits);
+    out += 8;
+  }
+  return Append(entry, timestamp, buf);
+}
+
+void DataLog::WriterThreadMain() {
+  std::vector<uint8_t> starts;
+  std::vector<uint8_t> finishes;
+  std::vector<std::pair<std::shared_ptr<ThreadBuffer>, uint64_t>> drains;
+  auto period = std::chrono::duration<double>(m_period);
+
+  for (;;) {
+    bool shutdown;
+    {
+      std::unique_lock lock(m_mutex);
+      m_cond.wait_for(lock, period, [&] { return m_shutdown || m_doFlush; });
+      shutdown = m_shutdown;
+      m_doFlush = false;
+
+      // Release buffers of exited threads once they have been drained
+      m_buffers.erase(
+          std::remove_if(m_buffers.begin(), m_buffers.end(),
+                         [](const auto& buf) {
+                           return buf->orphaned && buf->IsEmpty();
+                         }),
+          m_buffers.end());
+
+      // The buffer ends must be taken together with the control records:
+      // any record before an end was appended after its entry's start
+      // record was queued (so is written after it), and any record appended
+      // before a finish record was queued is before an end (so is written
+      // before it).
+      drains.clear();
+      for (auto&& buf : m_buffers) {
+        drains.emplace_back(buf, buf->GetTail());
+      }
+      starts.swap(m_pendingStarts);
+      finishes.swap(m_pendingFinishes);
+    }
+
+    WriteControl(starts, true);
+    for (auto&& drain : drains) {
+      drain.first->Drain(
+          drain.second, [&](ArrayRef<uint8_t> record) { WriteRecord(record); });
+    }
+    WriteControl(finishes, false);
+    starts.clear();
+    finishes.clear();
+
+    if (m_os) {
+      m_os->flush();
+      if (m_os->has_error()) {
+        // stop writing rather than failing on every record
+        CloseFile();
+      }
+    }
+    if (shutdown) {
+      break;
+    }
+  }
+  drains.clear();
+  CloseFile();
+}
+
+void DataLog::OpenFile() {
+  std::string filename;
+  if (m_fileIndex == 0) {
+    filename = m_filename;
+  } else {
+    // insert the index before the extension
+    wpi::SmallString<128> path{wpi::sys::path::parent_path(m_filename)};
+    wpi::sys::path::append(path, wpi::sys::path::stem(m_filename) + "." +
+                                     wpi::Twine(m_fileIndex) +
+                                     wpi::sys::path::extension(m_filename));
+    filename = path.str();
+  }
+
+  std::error_code ec;
+  m_os = std::make_unique<raw_fd_ostream>(filename, ec);
+  if (ec) {
+    wpi::errs() << "DataLog: could not open '" << filename
+                << "': " << ec.message() << '\n';
+    m_os.reset();
+  } else {
+    m_os->SetBufferSize(kWriteBufferSize);
+    *m_os << "WPILOG";
+    uint8_t version[2];
+    support::endian::write16le(version, 0x0100);
+    m_os->write(reinterpret_cast<const char*>(version), sizeof(version));
+  }
+  m_fileSize = 8;
+  m_fileHasData = false;
+
+  {
+    std::scoped_lock lock(m_mutex);
+    m_currentFilename = filename;
+  }
+
+  // each file starts with the entries that are still active
+  for (auto&& start : m_activeStarts) {
+    if (!start.empty() && m_os) {
+      m_os->write(reinterpret_cast<const char*>(start.data()), start.size());
+      m_fileSize += start.size();
+    }
+  }
+}
+
+void DataLog::CloseFile() {
+  if (!m_os) {
+    return;
+  }
+  m_os->close();
+  // raw_fd_ostream is fatal if destroyed with an error pending
+  if (m_os->has_error()) {
+    wpi::errs() << "DataLog: error writing '" << m_currentFilename
+                << "': " << m_os->error().message() << '\n';
+    m_os->clear_error();
+  }
+  m_os.reset();
+}
+
+void DataLog::WriteControl(ArrayRef<uint8_t> records, bool start) {
+  ForEachRecord(records, [&](ArrayRef<uint8_t> record) {
+    // written first, as rotating to a new file repeats the active starts
+    WriteRecord(record);
+    uint32_t entry =
+        support::endian::read32le(record.data() + kRecordHeaderSize + 1);
+    if (start) {
+      if (m_activeStarts.size() <= entry) {
+        m_activeStarts.resize(entry + 1);
+      }
+      m_activeStarts[entry].assign(record.begin(), record.end());
+    } else if (entry < m_activeStarts.size()) {
+      m_activeStarts[entry].clear();
+    }
+  });
+}
+
+void DataLog::WriteRecord(ArrayRef<uint8_t> record) {
+  // rotate on record boundaries; a file always gets at least one record after
+  // the repeated start records, even if that makes it too large
+  if (m_os && m_maxFileSize != 0 && m_fileHasData &&
+      m_fileSize + record.size() > m_maxFileSize) {
+    CloseFile();
+    ++m_fileIndex;
+    OpenFile();
+  }
+  if (m_os) {
+    m_os->write(reinterpret_cast<const char*>(record.data()), record.size());
+  } else {
+    // the file could not be opened or written
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+  m_fileSize += record.size();
+  m_fileHasData = true;
+}
@@ -0,0 +1,296 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/DataLogReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "wpi/Endian.h"
+#include "wpi/FileSystem.h"
+
+using namespace wpi::log;
+
+static constexpr size_t kHeaderSize = 8;
+static constexpr size_t kRecordHeaderSize = 16;
+static constexpr uint8_t kControlStart = 0;
+static constexpr uint8_t kControlFinish = 1;
+
+static bool ReadString(wpi::ArrayRef<uint8_t>* buf, wpi::StringRef* str) {
+  if (buf->size() < 4) {
+    *str = {};
+    return false;
+  }
+  uint32_t len = wpi::support::endian::read32le(buf->data());
+  if (len > (buf->size() - 4)) {
+    *str = {};
+    return false;
+  }
+  *str = {reinterpret_cast<const char*>(buf->data() + 4), len};
+  *buf = buf->drop_front(len + 4);
+  return true;
+}
+
+static int64_t ReadTimestamp(const uint8_t* data, size_t offset) {
+  return wpi::support::endian::read64le(data + offset + 8);
+}
+
+bool DataLogRecord::IsStart() const {
+  return m_entry == 0 && m_data.size() >= 17 && m_data[0] == kControlStart;
+}
+
+bool DataLogRecord::IsFinish() const {
+  return m_entry == 0 && m_data.size() == 5 && m_data[0] == kControlFinish;
+}
+
+bool DataLogRecord::GetStartData(StartRecordData* out) const {
+  if (!IsStart()) {
+    return false;
+  }
+  out->entry = support::endian::read32le(&m_data[1]);
+  auto buf = m_data.drop_front(5);
+  if (!ReadString(&buf, &out->name)) {
+    return false;
+  }
+  if (!ReadString(&buf, &out->type)) {
+    return false;
+  }
+  if (!ReadString(&buf, &out->metadata)) {
+    return false;
+  }
+  return true;
+}
+
+bool DataLogRecord::GetFinishEntry(int* out) const {
+  if (!IsFinish()) {
+    return false;
+  }
+  *out = support::endian::read32le(&m_data[1]);
+  return true;
+}
+
+bool DataLogRecord::GetBoolean(bool* value) const {
+  if (m_data.size() != 1) {
+    return false;
+  }
+  *value = m_data[0] != 0;
+  return true;
+}
+
+bool DataLogRecord::GetInteger(int64_t* value) const {
+  if (m_data.size() != 8) {
+    return false;
+  }
+  *value = support::endian::read64le(m_data.data());
+  return true;
+}
+
+bool DataLogRecord::GetFloat(float* value) const {
+  if (m_data.size() != 4) {
+    return false;
+  }
+  uint32_t bits = support::endian::read32le(m_data.data());
+  std::memcpy(value, &bits, sizeof(*value));
+  return true;
+}
+
+bool DataLogRecord::GetDouble(double* value) const {
+  if (m_data.size() != 8) {
+    return false;
+  }
+  uint64_t bits = support::endian::read64le(m_data.data());
+  std::memcpy(value, &bits, sizeof(*value));
+  return true;
+}
+
+bool DataLogRecord::GetString(StringRef* value) const {
+  *value = {reinterpret_cast<const char*>(m_data.data()), m_data.size()};
+  return true;
+}
+
+bool DataLogRecord::GetDoubleArray(std::vector<double>* arr) const {
+  arr->clear();
+  if ((m_data.size() % 8) != 0) {
+    return false;
+  }
+  arr->reserve(m_data.size() / 8);
+  for (size_t pos = 0; pos < m_data.size(); pos += 8) {
+    uint64_t bits = support::endian::read64le(&m_data[pos]);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    arr->push_back(value);
+  }
+  return true;
+}
+
+DataLogRecord DataLogReader::RecordIterator::operator*() const {
+  const uint8_t* record = m_data + *m_offset;
+  return {static_cast<int>(support::endian::read32le(record)),
+          static_cast<int64_t>(support::endian::read64le(record + 8)),
+          {record + kRecordHeaderSize, support::endian::read32le(record + 4)}};
+}
+
+DataLogReader::DataLogReader(const Twine& filename, std::error_code& ec) {
+  int fd;
+  ec = sys::fs::openFileForRead(filename, fd);
+  if (ec) {
+    return;
+  }
+  sys::fs::file_status status;
+  ec = sys::fs::status(fd, status);
+  if (!ec && status.getSize() != 0) {
+    m_mapping = std::make_unique<sys::fs::mapped_file_region>(
+        fd, sys::fs::mapped_file_region::readonly, status.getSize(), 0, ec);
+    if (ec) {
+      m_mapping.reset();
+    } else {
+      m_data = {reinterpret_cast<const uint8_t*>(m_mapping->const_data()),
+                m_mapping->size()};
+    }
+  }
+  // the mapping stays valid after the file is closed
+#ifdef _WIN32
+  _close(fd);
+#else
+  ::close(fd);
+#endif
+  Index();
+}
+
+DataLogReader::DataLogReader(ArrayRef<uint8_t> buffer) : m_data{buffer} {
+  Index();
+}
+
+DataLogReader::~DataLogReader() = default;
+
+bool DataLogReader::IsValid() const {
+  return m_data.size() >= kHeaderSize &&
+         StringRef(reinterpret_cast<const char*>(m_data.data()), 6) ==
+             "WPILOG" &&
+         GetVersion() >= 0x0100;
+}
+
+uint16_t DataLogReader::GetVersion() const {
+  if (m_data.size() < kHeaderSize) {
+    return 0;
+  }
+  return support::endian::read16le(&m_data[6]);
+}
+
+const DataLogReader::EntryInfo* DataLogReader::FindEntry(
+    StringRef name) const {
+  for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+    if (it->start.name == name) {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+DataLogReader::RecordRange DataLogReader::GetRecords(int64_t begin,
+                                                     int64_t end) const {
+  return FindRange(m_byTime, begin, end);
+}
+
+DataLogReader::RecordRange DataLogReader::GetRecords(const EntryInfo& entry,
+                                                     int64_t begin,
+                                                     int64_t end) const {
+  return FindRange(entry.offsets, begin, end);
+}
+
+DataLogReader::RecordRange DataLogReader::FindRange(ArrayRef<size_t> offsets,
+                                                    int64_t begin,
+                                                    int64_t end) const {
+  const uint8_t* data = m_data.data();
+  auto first = std::lower_bound(offsets.begin(), offsets.end(), begin,
+                                [&](size_t offset, int64_t timestamp) {
+                                  return ReadTimestamp(data, offset) <
+                                         timestamp;
+                                });
+  auto last = std::lower_bound(first, offsets.end(), end,
+                               [&](size_t offset, int64_t timestamp) {
+                                 return ReadTimestamp(data, offset) <
+                                        timestamp;
+                               });
+  return {data, ArrayRef<size_t>(first, last)};
+}
+
+void DataLogReader::Index() {
+  if (!IsValid()) {
+    return;
+  }
+
+  // Single pass over the records; this only touches the record headers
+  // (and the payloads of control records), so it runs at close to memory
+  // bandwidth
+  const uint8_t* data = m_data.data();
+  size_t size = m_data.size();
+  size_t pos = kHeaderSize;
+  bool sorted = true;
+  int64_t lastTimestamp = std::numeric_limits<int64_t>::min();
+  // Same for each entry (indexed as m_entries)
+  std::vector<int64_t> entryLastTimestamps;
+  std::vector<bool> entrySorted;
+  while (size - pos >= kRecordHeaderSize) {
+    uint32_t entry = support::endian::read32le(data + pos);
+    uint32_t len = support::endian::read32le(data + pos + 4);
+    if (len > size - pos - kRecordHeaderSize) {
+      break;  // truncated
+    }
+    m_all.push_back(pos);
+
+    if (entry == 0) {
+      DataLogRecord record{0, 0, {data + pos + kRecordHeaderSize, len}};
+      StartRecordData start;
+      int finished;
+      if (record.GetStartData(&start)) {
+        m_activeEntries[start.entry] = m_entries.size();
+        m_entries.push_back({start, {}});
+        entryLastTimestamps.push_back(std::numeric_limits<int64_t>::min());
+        entrySorted.push_back(true);
+      } else if (record.GetFinishEntry(&finished)) {
+        m_activeEntries.erase(finished);
+      }
+    } else {
+      int64_t timestamp = ReadTimestamp(data, pos);
+      auto it = m_activeEntries.find(entry);
+      if (it != m_activeEntries.end()) {
+        m_entries[it->second].offsets.push_back(pos);
+        if (timestamp < entryLastTimestamps[it->second]) {
+          entrySorted[it->second] = false;
+        }
+        entryLastTimestamps[it->second] = timestamp;
+      }
+      if (timestamp < lastTimestamp) {
+        sorted = false;
+      }
+      lastTimestamp = timestamp;
+      m_byTime.push_back(pos);
+    }
+
+    pos += kRecordHeaderSize + len;
+  }
+
+  // Records of different threads can be out of order; logs are mostly in
+  // order, so this is rarely needed
+  auto byTimestamp = [&](size_t a, size_t b) {
+    return ReadTimestamp(data, a) < ReadTimestamp(data, b);
+  };
+  if (!sorted) {
+    std::stable_sort(m_byTime.begin(), m_byTime.end(), byTimestamp);
+  }
+  for (size_t i = 0; i < m_entries.size(); ++i) {
+    if (!entrySorted[i]) {
+      std::stable_sort(m_entries[i].offsets.begin(), m_entries[i].offsets.end(),
+                       byTimestamp);
+    }
+  }
+}
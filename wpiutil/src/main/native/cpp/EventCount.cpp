@@ -0,0 +1,95 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/EventCount.h"
+
+#include <chrono>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <ctime>
+#endif
+
+using namespace wpi;
+
+#ifdef __linux__
+
+static int Futex(std::atomic<uint32_t>* addr, int op, uint32_t val,
+                 const struct timespec* timeout) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val,
+                 timeout, nullptr, 0);
+}
+
+void EventCount::Wait(uint32_t key) {
+  while (m_epoch.load(std::memory_order_acquire) == key) {
+    Futex(&m_epoch, FUTEX_WAIT_PRIVATE, key, nullptr);
+  }
+}
+
+bool EventCount::WaitFor(uint32_t key, double timeout) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::duration<double>(timeout);
+  bool notified = true;
+  while (m_epoch.load(std::memory_order_acquire) == key) {
+    std::chrono::duration<double> remaining =
+        deadline - std::chrono::steady_clock::now();
+    if (remaining.count() <= 0) {
+      notified = false;
+      break;
+    }
+    struct timespec ts;
+    double whole;
+    ts.tv_nsec = std::modf(remaining.count(), &whole) * 1.0e9;
+    ts.tv_sec = whole;
+    Futex(&m_epoch, FUTEX_WAIT_PRIVATE, key, &ts);
+  }
+  return notified;
+}
+
+void EventCount::DoNotify(uint32_t epoch) {
+  // only one of several concurrent notifiers needs to wake the waiters
+  if (m_epoch.compare_exchange_strong(epoch, (epoch + 2) & ~kWaiting,
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed)) {
+    Futex(&m_epoch, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
+  }
+}
+
+#else
+
+void EventCount::Wait(uint32_t key) {
+  std::unique_lock lock(m_mutex);
+  m_cond.wait(lock,
+              [&] { return m_epoch.load(std::memory_order_acquire) != key; });
+}
+
+bool EventCount::WaitFor(uint32_t key, double timeout) {
+  std::unique_lock lock(m_mutex);
+  bool notified = m_cond.wait_for(
+      lock, std::chrono::duration<double>(timeout),
+      [&] { return m_epoch.load(std::memory_order_acquire) != key; });
+  return notified;
+}
+
+void EventCount::DoNotify(uint32_t epoch) {
+  {
+    // the epoch is changed under the lock so a waiter can't miss it between
+    // checking it and blocking
+    std::scoped_lock lock(m_mutex);
+    if (!m_epoch.compare_exchange_strong(epoch, (epoch + 2) & ~kWaiting,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+      return;
+    }
+  }
+  m_cond.notify_all();
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include "wpi/HttpUtil.h"
 
 #include <cctype>
+#include <cstring>
 
 #include "wpi/Base64.h"
 #include "wpi/STLExtras.h"
@@ -446,8 +447,19 @@ StringRef HttpMultipartScanner::Execute(StringRef in) {
 
   size_t pos = 0;
   if (m_state == kBoundary) {
-    for (char ch : in) {
-      ++pos;
+    while (pos < in.size()) {
+      // Both boundary forms start with '\n', so when nothing is partially
+      // matched, skip straight to the next one.  memchr is vectorized, which
+      // makes this much faster than matching byte by byte through image data.
+      if (m_posWith == 0 && m_posWithout == 0) {
+        const void* nl = std::memchr(in.data() + pos, '\n', in.size() - pos);
+        if (!nl) {
+          pos = in.size();
+          break;
+        }
+        pos = static_cast<const char*>(nl) - in.data();
+      }
+      char ch = in[pos++];
       if (m_dashes != kWithout) {
         if (ch == m_boundaryWith[m_posWith]) {
           ++m_posWith;
@@ -0,0 +1,219 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/ThreadPool.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include "wpi/raw_ostream.h"
+
+using namespace wpi;
+
+// Pool and index of the worker running on the current thread
+static thread_local const ThreadPool* gCurrentPool = nullptr;
+static thread_local size_t gCurrentWorker = 0;
+
+static void SetAffinity(int cpu) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (err != 0) {
+    wpi::errs() << "ThreadPool: could not set affinity to CPU " << cpu
+                << ": error " << err << '\n';
+  }
+#elif defined(_WIN32)
+  if (SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) == 0) {
+    wpi::errs() << "ThreadPool: could not set affinity to CPU " << cpu
+                << ": error " << static_cast<int>(GetLastError()) << '\n';
+  }
+#else
+  (void)cpu;
+#endif
+}
+
+ThreadPool::ThreadPool(int numThreads, ArrayRef<int> cpus) {
+  if (numThreads <= 0) {
+    numThreads = static_cast<int>(
+        !cpus.empty() ? cpus.size()
+                      : (std::max)(std::thread::hardware_concurrency(), 1u));
+  }
+  m_workers.reserve(numThreads);
+  for (int i = 0; i < numThreads; ++i) {
+    m_workers.emplace_back(std::make_unique<Worker>());
+  }
+  // start the threads once the worker list is complete, as workers look at
+  // each other's queues
+  for (int i = 0; i < numThreads; ++i) {
+    int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+    m_workers[i]->thread = std::thread([=] { WorkerMain(i, cpu); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  m_active = false;
+  m_event.Notify();
+  for (auto&& worker : m_workers) {
+    worker->thread.join();
+  }
+}
+
+ThreadPool& ThreadPool::GetDefault() {
+  // never destroyed, as tasks may still be using other static objects (such
+  // as the promise factories) at exit
+  static ThreadPool* pool = new ThreadPool;
+  return *pool;
+}
+
+bool ThreadPool::IsWorkerThread() const {
+  return gCurrentPool == this;
+}
+
+void ThreadPool::Post(Priority priority, unique_function<void()> func) {
+  // tasks posted by a worker stay on that worker; others are spread out
+  bool local = gCurrentPool == this;
+  size_t index = local ? gCurrentWorker
+                       : m_next.fetch_add(1, std::memory_order_relaxed) %
+                             m_workers.size();
+  Worker& worker = *m_workers[index];
+
+  // counted before it is queued, so a worker that sees no queued tasks after
+  // preparing to wait can't miss it
+  m_queued.fetch_add(1, std::memory_order_relaxed);
+  {
+    std::scoped_lock lock(worker.mutex);
+    // the worker takes from the back, so local tasks run newest first and
+    // outside tasks oldest first
+    if (local) {
+      worker.tasks[priority].emplace_back(std::move(func));
+    } else {
+      worker.tasks[priority].emplace_front(std::move(func));
+    }
+    worker.count[priority].fetch_add(1, std::memory_order_relaxed);
+  }
+  m_event.Notify();
+}
+
+void ThreadPool::ParallelFor(size_t first, size_t last, size_t grain,
+                             std::function<void(size_t, size_t)> func,
+                             Priority priority) {
+  if (first >= last) {
+    return;
+  }
+  grain = (std::max)(grain, size_t{1});
+  size_t chunks = (last - first + grain - 1) / grain;
+  if (chunks == 1) {
+    func(first, last);
+    return;
+  }
+
+  // each thread (the caller and the helper tasks) claims chunks until none
+  // are left
+  struct State {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+    EventCount event;
+  };
+  auto state = std::make_shared<State>();
+  auto work = [=] {
+    for (;;) {
+      size_t chunk = state->next.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= chunks) {
+        return;
+      }
+      size_t begin = first + chunk * grain;
+      func(begin, (std::min)(last, begin + grain));
+      if (state->done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks) {
+        state->event.Notify();
+      }
+    }
+  };
+  size_t helpers = (std::min)(chunks - 1, m_workers.size());
+  for (size_t i = 0; i < helpers; ++i) {
+    Post(priority, work);
+  }
+  work();
+
+  // wait for the chunks claimed by helpers
+  while (state->done.load(std::memory_order_acquire) != chunks) {
+    uint32_t key = state->event.PrepareWait();
+    if (state->done.load(std::memory_order_acquire) == chunks) {
+      state->event.CancelWait();
+      break;
+    }
+    state->event.Wait(key);
+  }
+}
+
+void ThreadPool::WorkerMain(size_t index, int cpu) {
+  gCurrentPool = this;
+  gCurrentWorker = index;
+  if (cpu >= 0) {
+    SetAffinity(cpu);
+  }
+
+  for (;;) {
+    if (RunTask(index)) {
+      continue;
+    }
+    uint32_t key = m_event.PrepareWait();
+    if (m_queued.load(std::memory_order_seq_cst) != 0) {
+      m_event.CancelWait();
+      continue;
+    }
+    if (!m_active) {
+      // notify any other workers still waiting
+      m_event.CancelWait();
+      m_event.Notify();
+      break;
+    }
+    m_event.Wait(key);
+  }
+}
+
+bool ThreadPool::RunTask(size_t index) {
+  size_t numWorkers = m_workers.size();
+  for (int priority = 0; priority < kNumPriorities; ++priority) {
+    // own tasks first, then steal from the other workers in turn
+    for (size_t i = 0; i < numWorkers; ++i) {
+      auto task =
+          Take(*m_workers[(index + i) % numWorkers], priority, i == 0);
+      if (task) {
+        task();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+unique_function<void()> ThreadPool::Take(Worker& worker, int priority,
+                                         bool own) {
+  if (worker.count[priority].load(std::memory_order_relaxed) == 0) {
+    return {};
+  }
+  std::scoped_lock lock(worker.mutex);
+  auto& tasks = worker.tasks[priority];
+  if (tasks.empty()) {
+    return {};
+  }
+  unique_function<void()> task;
+  if (own) {
+    task = std::move(tasks.back());
+    tasks.pop_back();
+  } else {
+    // the other end from the owner, to keep out of its way
+    task = std::move(tasks.front());
+    tasks.pop_front();
+  }
+  worker.count[priority].fetch_sub(1, std::memory_order_relaxed);
+  m_queued.fetch_sub(1, std::memory_order_relaxed);
+  return task;
+}
@@ -0,0 +1,272 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "wpi/SmallString.h"
+#include "wpi/StringRef.h"
+#include "wpi/mutex.h"
+#include "wpi/raw_ostream.h"
+
+using namespace wpi;
+
+namespace {
+
+// Fields are atomic so the writer can read a buffer while its thread keeps
+// recording; all accesses are relaxed
+struct Event {
+  std::atomic<const char*> name{nullptr};
+  std::atomic<uint64_t> time{0};
+  std::atomic<uint64_t> arg{0};  // duration, or counter value bits
+  std::atomic<char> phase{0};
+};
+
+struct EventCopy {
+  const char* name;
+  uint64_t time;
+  uint64_t arg;
+  char phase;
+};
+
+class ThreadBuffer {
+ public:
+  ThreadBuffer(size_t size, int tid) : tid{tid} {
+    size_t capacity = 2;
+    while (capacity < size) {
+      capacity <<= 1;
+    }
+    m_events = std::make_unique<Event[]>(capacity);
+    m_mask = capacity - 1;
+  }
+
+  // Owning thread only
+  void Add(char phase, const char* name, uint64_t time, uint64_t arg) {
+    uint64_t n = m_count.load(std::memory_order_relaxed);
+    // announce the overwrite before doing it; pairs with the fence in Copy()
+    m_begun.store(n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Event& event = m_events[n & m_mask];
+    event.name.store(name, std::memory_order_relaxed);
+    event.time.store(time, std::memory_order_relaxed);
+    event.arg.store(arg, std::memory_order_relaxed);
+    event.phase.store(phase, std::memory_order_relaxed);
+    m_count.store(n + 1, std::memory_order_release);
+  }
+
+  // Any thread; appends the events still valid after copying
+  void Copy(std::vector<EventCopy>* out) const {
+    uint64_t end = m_count.load(std::memory_order_acquire);
+    uint64_t capacity = m_mask + 1;
+    uint64_t begin = end > capacity ? end - capacity : 0;
+    begin = (std::max)(begin, m_cleared.load(std::memory_order_relaxed));
+    size_t first = out->size();
+    for (uint64_t i = begin; i < end; ++i) {
+      const Event& event = m_events[i & m_mask];
+      out->push_back({event.name.load(std::memory_order_relaxed),
+                      event.time.load(std::memory_order_relaxed),
+                      event.arg.load(std::memory_order_relaxed),
+                      event.phase.load(std::memory_order_relaxed)});
+    }
+    // drop events the thread started overwriting while they were copied
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t begun = m_begun.load(std::memory_order_relaxed);
+    if (begun > begin + capacity && end > begin) {
+      size_t overwritten = (std::min)(begun - capacity - begin, end - begin);
+      out->erase(out->begin() + first, out->begin() + first + overwritten);
+    }
+  }
+
+  // Any thread; hides the events recorded so far
+  void Clear() {
+    m_cleared.store(m_count.load(std::memory_order_acquire),
+                    std::memory_order_relaxed);
+  }
+
+  const int tid;
+  std::string name;  // protected by the registry mutex
+
+ private:
+  std::unique_ptr<Event[]> m_events;
+  uint64_t m_mask;
+  std::atomic<uint64_t> m_begun{0};
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_cleared{0};
+};
+
+struct Registry {
+  std::atomic<bool> enabled{false};
+  wpi::mutex mutex;
+  size_t bufferSize = 4096;
+  int nextTid = 1;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+}  // namespace
+
+static Registry& GetRegistry() {
+  // never destroyed, as threads may record events during static destruction
+  static Registry* registry = new Registry;
+  return *registry;
+}
+
+// The calling thread's buffer; the registry holds another reference, so the
+// events of a thread that has exited are kept until cleared
+static thread_local std::shared_ptr<ThreadBuffer> gThreadBuffer;
+static thread_local std::string gThreadName;
+
+static ThreadBuffer& GetThreadBuffer() {
+  if (!gThreadBuffer) {
+    auto& registry = GetRegistry();
+    std::scoped_lock lock(registry.mutex);
+    gThreadBuffer = std::make_shared<ThreadBuffer>(registry.bufferSize,
+                                                   registry.nextTid++);
+    gThreadBuffer->name = gThreadName;
+    registry.buffers.emplace_back(gThreadBuffer);
+  }
+  return *gThreadBuffer;
+}
+
+static void WriteString(raw_ostream& os, StringRef str) {
+  os << '"';
+  for (char ch : str) {
+    if (ch == '"' || ch == '\\') {
+      os << '\\' << ch;
+    } else if (static_cast<unsigned char>(ch) < 0x20) {
+      os << "\\u00";
+      os.write_hex(static_cast<unsigned char>(ch) >> 4);
+      os.write_hex(ch & 0xf);
+    } else {
+      os << ch;
+    }
+  }
+  os << '"';
+}
+
+void trace::SetEnabled(bool enabled) {
+  GetRegistry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool trace::IsEnabled() {
+  return GetRegistry().enabled.load(std::memory_order_relaxed);
+}
+
+void trace::SetBufferSize(size_t size) {
+  auto& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  registry.bufferSize = size;
+}
+
+void trace::SetThreadName(const Twine& name) {
+  gThreadName = name.str();
+  if (gThreadBuffer) {
+    auto& registry = GetRegistry();
+    std::scoped_lock lock(registry.mutex);
+    gThreadBuffer->name = gThreadName;
+  }
+}
+
+void trace::Complete(const char* name, uint64_t start, uint64_t end) {
+  if (IsEnabled()) {
+    GetThreadBuffer().Add('X', name, start, end - start);
+  }
+}
+
+void trace::Instant(const char* name) {
+  if (IsEnabled()) {
+    GetThreadBuffer().Add('i', name, Now(), 0);
+  }
+}
+
+void trace::Counter(const char* name, double value) {
+  if (IsEnabled()) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    GetThreadBuffer().Add('C', name, Now(), bits);
+  }
+}
+
+void trace::Clear() {
+  auto& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  auto& buffers = registry.buffers;
+  buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                               [](const auto& buffer) {
+                                 return buffer.use_count() == 1;
+                               }),
+                buffers.end());
+  for (auto&& buffer : buffers) {
+    buffer->Clear();
+  }
+}
+
+void trace::WriteJson(raw_ostream& os) {
+  auto& registry = GetRegistry();
+  std::scoped_lock lock(registry.mutex);
+  std::vector<EventCopy> events;
+  bool first = true;
+  auto separate = [&] {
+    if (!first) {
+      os << ",\n";
+    }
+    first = false;
+  };
+
+  os << "{\"traceEvents\":[\n";
+  for (auto&& buffer : registry.buffers) {
+    if (!buffer->name.empty()) {
+      separate();
+      os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+         << buffer->tid << ",\"args\":{\"name\":";
+      WriteString(os, buffer->name);
+      os << "}}";
+    }
+
+    events.clear();
+    buffer->Copy(&events);
+    for (auto&& event : events) {
+      separate();
+      os << "{\"name\":";
+      WriteString(os, event.name);
+      os << ",\"ph\":\"" << event.phase << "\",\"ts\":" << event.time
+         << ",\"pid\":1,\"tid\":" << buffer->tid;
+      switch (event.phase) {
+        case 'X':
+          os << ",\"dur\":" << event.arg;
+          break;
+        case 'i':
+          os << ",\"s\":\"t\"";
+          break;
+        case 'C': {
+          double value;
+          std::memcpy(&value, &event.arg, sizeof(value));
+          os << ",\"args\":{\"value\":" << value << '}';
+          break;
+        }
+      }
+      os << '}';
+    }
+  }
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void trace::WriteJson(const Twine& filename, std::error_code& ec) {
+  SmallString<128> buf;
+  raw_fd_ostream os{filename.toStringRef(buf), ec};
+  if (ec) {
+    return;
+  }
+  WriteJson(os);
+  os.close();
+  if (os.has_error()) {
+    ec = os.error();
+    os.clear_error();
+  }
+}
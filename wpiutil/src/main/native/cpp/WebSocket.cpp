@@ -4,8 +4,18 @@
 
 #include "wpi/WebSocket.h"
 
+#include <cstring>
 #include <random>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WPI_WS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define WPI_WS_NEON
+#include <arm_neon.h>
+#endif
+
 #include "wpi/Base64.h"
 #include "wpi/HttpParser.h"
 #include "wpi/SmallString.h"
@@ -35,6 +45,38 @@ class WebSocketWriteReq : public uv::WriteReq {
 };
 }  // namespace
 
+// Applies a masking key to data in place. The key starts at the first byte;
+// as it repeats every 4 bytes, it can be applied a vector or word at a time.
+static void Unmask(MutableArrayRef<uint8_t> data, const uint8_t* key) {
+  uint8_t* p = data.data();
+  size_t len = data.size();
+  size_t i = 0;
+  uint32_t key32;
+  std::memcpy(&key32, key, 4);
+#if defined(WPI_WS_SSE2)
+  __m128i key128 = _mm_set1_epi32(static_cast<int>(key32));
+  for (; i + 16 <= len; i += 16) {
+    auto ptr = reinterpret_cast<__m128i*>(p + i);
+    _mm_storeu_si128(ptr, _mm_xor_si128(_mm_loadu_si128(ptr), key128));
+  }
+#elif defined(WPI_WS_NEON)
+  uint8x16_t key128 = vreinterpretq_u8_u32(vdupq_n_u32(key32));
+  for (; i + 16 <= len; i += 16) {
+    vst1q_u8(p + i, veorq_u8(vld1q_u8(p + i), key128));
+  }
+#endif
+  uint64_t key64 = (static_cast<uint64_t>(key32) << 32) | key32;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, p + i, 8);
+    word ^= key64;
+    std::memcpy(p + i, &word, 8);
+  }
+  for (; i < len; ++i) {
+    p[i] ^= key[i & 3];
+  }
+}
+
 class WebSocket::ClientHandshakeData {
  public:
   ClientHandshakeData() {
@@ -444,129 +486,144 @@ void WebSocket::HandleIncoming(uv::Buffer& buf, size_t size) {
     }
 
     if (m_frameSize != UINT64_MAX) {
-      size_t need = m_frameStart + m_frameSize - m_payload.size();
-      size_t toCopy = (std::min)(need, data.size());
-      m_payload.append(data.bytes_begin(), data.bytes_begin() + toCopy);
-      data = data.drop_front(toCopy);
-      need -= toCopy;
-      if (need == 0) {
-        // We have a complete frame
-        // If the message had masking, unmask it
-        if ((m_header[1] & kFlagMasking) != 0) {
-          uint8_t key[4] = {
-              m_header[m_headerSize - 4], m_header[m_headerSize - 3],
-              m_header[m_headerSize - 2], m_header[m_headerSize - 1]};
-          int n = 0;
-          for (uint8_t& ch :
-               MutableArrayRef<uint8_t>{m_payload}.slice(m_frameStart)) {
-            ch ^= key[n++];
-            if (n >= 4) {
-              n = 0;
-            }
-          }
+      bool fin = (m_header[0] & kFlagFin) != 0;
+      uint8_t opcode = m_header[0] & kOpMask;
+      bool control = (opcode & 0x08) != 0;
+
+      MutableArrayRef<uint8_t> frame;
+      if (m_payload.empty() && data.size() >= m_frameSize &&
+          (control || fin || !m_combineFragments)) {
+        // The whole frame is in the read buffer and doesn't need to be
+        // combined with earlier fragments, so use it in place
+        frame = MutableArrayRef<uint8_t>{
+            reinterpret_cast<uint8_t*>(buf.base + (data.data() - buf.base)),
+            static_cast<size_t>(m_frameSize)};
+        data = data.drop_front(m_frameSize);
+      } else {
+        size_t need = m_frameStart + m_frameSize - m_payload.size();
+        size_t toCopy = (std::min)(need, data.size());
+        m_payload.append(data.bytes_begin(), data.bytes_begin() + toCopy);
+        data = data.drop_front(toCopy);
+        if (toCopy != need) {
+          return;  // need more data
         }
+        frame = MutableArrayRef<uint8_t>{m_payload}.slice(m_frameStart);
+      }
 
-        // Handle message
-        bool fin = (m_header[0] & kFlagFin) != 0;
-        uint8_t opcode = m_header[0] & kOpMask;
-        switch (opcode) {
-          case kOpCont:
-            switch (m_fragmentOpcode) {
-              case kOpText:
-                if (!m_combineFragments || fin) {
-                  text(StringRef{reinterpret_cast<char*>(m_payload.data()),
-                                 m_payload.size()},
-                       fin);
-                }
-                break;
-              case kOpBinary:
-                if (!m_combineFragments || fin) {
-                  binary(m_payload, fin);
-                }
-                break;
-              default:
-                // no preceding message?
-                return Fail(1002, "invalid continuation message");
-            }
-            if (fin) {
-              m_fragmentOpcode = 0;
-            }
-            break;
-          case kOpText:
-            if (m_fragmentOpcode != 0) {
-              return Fail(1002, "incomplete fragment");
-            }
-            if (!m_combineFragments || fin) {
-              text(StringRef{reinterpret_cast<char*>(m_payload.data()),
-                             m_payload.size()},
-                   fin);
-            }
-            if (!fin) {
-              m_fragmentOpcode = opcode;
-            }
-            break;
-          case kOpBinary:
-            if (m_fragmentOpcode != 0) {
-              return Fail(1002, "incomplete fragment");
-            }
-            if (!m_combineFragments || fin) {
-              binary(m_payload, fin);
-            }
-            if (!fin) {
-              m_fragmentOpcode = opcode;
-            }
-            break;
-          case kOpClose: {
-            uint16_t code;
-            StringRef reason;
-            if (!fin) {
-              code = 1002;
-              reason = "cannot fragment control frames";
-            } else if (m_payload.size() < 2) {
-              code = 1005;
-            } else {
-              code = (static_cast<uint16_t>(m_payload[0]) << 8) |
-                     static_cast<uint16_t>(m_payload[1]);
-              reason = StringRef{reinterpret_cast<char*>(m_payload.data()),
-                                 m_payload.size()}
-                           .drop_front(2);
-            }
-            // Echo the close if we didn't previously send it
-            if (m_state != CLOSING) {
-              SendClose(code, reason);
-            }
-            SetClosed(code, reason);
-            // If we're the server, shutdown the connection.
-            if (m_server) {
-              Shutdown();
-            }
-            break;
+      // We have a complete frame
+      // If the frame had masking, unmask it
+      if ((m_header[1] & kFlagMasking) != 0) {
+        Unmask(frame, &m_header[m_headerSize - 4]);
+      }
+
+      // Data messages include any earlier fragments being combined
+      ArrayRef<uint8_t> message = frame;
+      if (!m_payload.empty()) {
+        message = m_payload;
+      }
+
+      // Handle message
+      switch (opcode) {
+        case kOpCont:
+          switch (m_fragmentOpcode) {
+            case kOpText:
+              if (!m_combineFragments || fin) {
+                text(StringRef{reinterpret_cast<const char*>(message.data()),
+                               message.size()},
+                     fin);
+              }
+              break;
+            case kOpBinary:
+              if (!m_combineFragments || fin) {
+                binary(message, fin);
+              }
+              break;
+            default:
+              // no preceding message?
+              return Fail(1002, "invalid continuation message");
           }
-          case kOpPing:
-            if (!fin) {
-              return Fail(1002, "cannot fragment control frames");
-            }
-            ping(m_payload);
-            break;
-          case kOpPong:
-            if (!fin) {
-              return Fail(1002, "cannot fragment control frames");
-            }
-            pong(m_payload);
-            break;
-          default:
-            return Fail(1002, "invalid message opcode");
+          if (fin) {
+            m_fragmentOpcode = 0;
+          }
+          break;
+        case kOpText:
+          if (m_fragmentOpcode != 0) {
+            return Fail(1002, "incomplete fragment");
+          }
+          if (!m_combineFragments || fin) {
+            text(StringRef{reinterpret_cast<const char*>(message.data()),
+                           message.size()},
+                 fin);
+          }
+          if (!fin) {
+            m_fragmentOpcode = opcode;
+          }
+          break;
+        case kOpBinary:
+          if (m_fragmentOpcode != 0) {
+            return Fail(1002, "incomplete fragment");
+          }
+          if (!m_combineFragments || fin) {
+            binary(message, fin);
+          }
+          if (!fin) {
+            m_fragmentOpcode = opcode;
+          }
+          break;
+        case kOpClose: {
+          uint16_t code;
+          StringRef reason;
+          if (!fin) {
+            code = 1002;
+            reason = "cannot fragment control frames";
+          } else if (frame.size() < 2) {
+            code = 1005;
+          } else {
+            code = (static_cast<uint16_t>(frame[0]) << 8) |
+                   static_cast<uint16_t>(frame[1]);
+            reason = StringRef{reinterpret_cast<const char*>(frame.data()),
+                               frame.size()}
+                         .drop_front(2);
+          }
+          // Echo the close if we didn't previously send it
+          if (m_state != CLOSING) {
+            SendClose(code, reason);
+          }
+          SetClosed(code, reason);
+          // If we're the server, shutdown the connection.
+          if (m_server) {
+            Shutdown();
+          }
+          break;
         }
+        case kOpPing:
+          if (!fin) {
+            return Fail(1002, "cannot fragment control frames");
+          }
+          ping(frame);
+          break;
+        case kOpPong:
+          if (!fin) {
+            return Fail(1002, "cannot fragment control frames");
+          }
+          pong(frame);
+          break;
+        default:
+          return Fail(1002, "invalid message opcode");
+      }
 
-        // Prepare for next message
-        m_header.clear();
-        m_headerSize = 0;
-        if (!m_combineFragments || fin) {
-          m_payload.clear();
-        }
-        m_frameStart = m_payload.size();
-        m_frameSize = UINT64_MAX;
+      // Prepare for next frame
+      m_header.clear();
+      m_headerSize = 0;
+      if (control) {
+        // control frames may arrive between the fragments of a message, so
+        // keep the fragments received so far
+        m_payload.resize(m_frameStart);
+      } else if (!m_combineFragments || fin) {
+        m_payload.clear();
       }
+      m_frameStart = m_payload.size();
+      m_frameSize = UINT64_MAX;
     }
   }
 }
@@ -0,0 +1,135 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_ASYNCLOGGER_H_
+#define WPIUTIL_WPI_ASYNCLOGGER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "wpi/Logger.h"
+#include "wpi/MpscQueue.h"
+#include "wpi/SmallString.h"
+#include "wpi/condition_variable.h"
+#include "wpi/mutex.h"
+
+namespace wpi {
+
+/**
+ * A logging backend that moves the cost of handling log messages off the
+ * threads that log them.
+ *
+ * Log() copies the (already formatted) message into a lock-free queue and
+ * returns without blocking; a background thread passes the messages to the
+ * real log function in the order they were queued. If the queue is full, the
+ * message is dropped and counted, and the background thread reports the
+ * number dropped (as a warning) once it catches up.
+ *
+ * Use with a Logger by passing GetLogFunc() as the Logger's log function:
+ * @code
+ * wpi::AsyncLogger asyncLog{PrintLog};
+ * wpi::Logger logger{asyncLog.GetLogFunc()};
+ * @endcode
+ *
+ * The file name passed to Log() is not copied, so it must remain valid until
+ * the message is handled; __FILE__ (as used by WPI_LOG) always does.
+ */
+class AsyncLogger final {
+ public:
+  static constexpr size_t kDefaultCapacity = 1024;
+
+  /**
+   * Constructs an asynchronous logger and starts its background thread.
+   *
+   * @param func log function to call from the background thread
+   * @param capacity number of messages that can be queued
+   */
+  explicit AsyncLogger(Logger::LogFunc func,
+                       size_t capacity = kDefaultCapacity);
+
+  /**
+   * Handles all queued messages and stops the background thread.
+   */
+  ~AsyncLogger();
+
+  AsyncLogger(const AsyncLogger&) = delete;
+  AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+  /**
+   * Queues a message. Never blocks.
+   *
+   * @param level log level
+   * @param file source file name
+   * @param line source line number
+   * @param msg message
+   */
+  void Log(unsigned int level, const char* file, unsigned int line,
+           const char* msg);
+
+  /**
+   * Gets a function for a Logger that calls Log(). The function refers to
+   * this object, so it must not be called after this object is destroyed.
+   */
+  Logger::LogFunc GetLogFunc() {
+    return [this](unsigned int level, const char* file, unsigned int line,
+                  const char* msg) { Log(level, file, line, msg); };
+  }
+
+  /**
+   * Waits until all messages queued before the call have been handled.
+   */
+  void Flush();
+
+  /**
+   * Gets the number of messages dropped because the queue was full.
+   */
+  uint64_t GetDroppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+  }
+
+ private:
+  enum Kind { kMessage, kFlush, kStop };
+
+  struct Record {
+    Record() = default;
+    Record(Kind kind_, unsigned int level_, const char* file_,
+           unsigned int line_, const char* msg_, uint64_t flushId_ = 0)
+        : kind{kind_},
+          level{level_},
+          file{file_},
+          line{line_},
+          msg{msg_},
+          flushId{flushId_} {}
+
+    Kind kind = kMessage;
+    unsigned int level = 0;
+    const char* file = nullptr;
+    unsigned int line = 0;
+    // most messages fit without allocating
+    SmallString<200> msg;
+    uint64_t flushId = 0;
+  };
+
+  void ThreadMain();
+
+  Logger::LogFunc m_func;
+  MpscQueue<Record> m_queue;
+  std::atomic<uint64_t> m_dropped{0};
+
+  wpi::mutex m_flushMutex;
+  wpi::condition_variable m_flushCond;
+  uint64_t m_nextFlushId = 0;
+  // ids of handled flush records whose requesters haven't woken yet
+  std::vector<uint64_t> m_flushesDone;
+
+  std::thread m_thread;
+};
+
+}  // namespace wpi
+
+#endif  // WPIUTIL_WPI_ASYNCLOGGER_H_
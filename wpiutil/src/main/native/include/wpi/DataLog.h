@@ -0,0 +1,414 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_DATALOG_H_
+#define WPIUTIL_WPI_DATALOG_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "wpi/ArrayRef.h"
+#include "wpi/StringMap.h"
+#include "wpi/StringRef.h"
+#include "wpi/Twine.h"
+#include "wpi/condition_variable.h"
+#include "wpi/mutex.h"
+
+namespace wpi {
+
+class raw_fd_ostream;
+
+namespace log {
+
+/**
+ * A data log. The log file is created upon construction.
+ *
+ * The data log is periodically flushed to disk. It can also be explicitly
+ * flushed to disk by using the Flush() function.
+ *
+ * The data log uses a binary format. All values are little endian. The file
+ * starts with an 8 byte header:
+ *
+ *   - "WPILOG" (6 bytes)
+ *   - format version (2 bytes, currently 0x0100)
+ *
+ * The header is followed by records. Each record has a 16 byte header
+ * followed by its payload:
+ *
+ *   - entry ID (4 bytes)
+ *   - payload size in bytes (4 bytes)
+ *   - timestamp, in microseconds in the wpi::Now() time base (8 bytes)
+ *
+ * Records with entry ID 0 are control records. The first byte of their payload
+ * is the control record type:
+ *
+ *   - 0 (start): entry ID (4 bytes), then the entry name, type, and metadata,
+ *     each as a length (4 bytes) followed by that many bytes of UTF-8
+ *   - 1 (finish): entry ID (4 bytes)
+ *
+ * A start record always precedes the data records of its entry in a file.
+ *
+ * Data records are appended on the calling thread to a buffer owned by that
+ * thread, without locking. A background thread moves them from the buffers to
+ * the file in large writes. If a thread's buffer is full (the background
+ * thread is not keeping up), records are dropped rather than blocking the
+ * caller; GetDroppedCount() reports how many. Records are also dropped (and
+ * counted) once the file can't be written, e.g. because the disk is full.
+ * Records from different threads may appear in the file out of timestamp
+ * order.
+ *
+ * If a maximum file size is set, the log is rotated: once a file would exceed
+ * the size, it is closed and writing continues in a new file named with an
+ * increasing number before the extension (e.g. "log.1.wpilog"). The start
+ * records of all entries that have not been finished are repeated at the
+ * beginning of each new file, so each file can be read on its own.
+ */
+class DataLog final {
+ public:
+  /**
+   * Construct a new Data Log.
+   *
+   * @param dir directory to store the log
+   * @param filename filename to use; if empty, a name based on the current
+   *                 time is generated
+   * @param period time between automatic flushes to disk, in seconds
+   * @param maxFileSize rotate to a new file once a file would exceed this
+   *                    size, in bytes; 0 to never rotate
+   * @param bufferSize size of each thread's record buffer, in bytes
+   */
+  explicit DataLog(const Twine& dir = "", const Twine& filename = "",
+                   double period = 0.25, uint64_t maxFileSize = 0,
+                   size_t bufferSize = 256 * 1024);
+
+  /**
+   * Flushes all buffered records to disk and closes the file.
+   */
+  ~DataLog();
+
+  DataLog(const DataLog&) = delete;
+  DataLog& operator=(const DataLog&) = delete;
+
+  /**
+   * Gets the name of the file currently being written.
+   *
+   * @return file name (including directory)
+   */
+  std::string GetFilename() const;
+
+  /**
+   * Explicitly flushes the log data to disk. Does not wait for the write to
+   * complete.
+   */
+  void Flush();
+
+  /**
+   * Starts an entry. Returns an identifier that can be used to append records
+   * for the entry. Starting an entry that has already been started (and not
+   * finished) returns the same identifier.
+   *
+   * @param name Name
+   * @param type Data type
+   * @param metadata Initial metadata (e.g. data properties)
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   * @return Entry index
+   */
+  int Start(StringRef name, StringRef type, StringRef metadata = {},
+            int64_t timestamp = 0);
+
+  /**
+   * Finishes an entry. No records may be appended for the entry afterwards.
+   *
+   * @param entry Entry index
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Finish(int entry, int64_t timestamp = 0);
+
+  /**
+   * Appends a raw record to the log. Lock free.
+   *
+   * @param entry Entry index, as returned by Start()
+   * @param data Byte array to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   * @return False if the record was dropped
+   */
+  bool AppendRaw(int entry, ArrayRef<uint8_t> data, int64_t timestamp = 0);
+
+  bool AppendBoolean(int entry, bool value, int64_t timestamp = 0);
+  bool AppendInteger(int entry, int64_t value, int64_t timestamp = 0);
+  bool AppendFloat(int entry, float value, int64_t timestamp = 0);
+  bool AppendDouble(int entry, double value, int64_t timestamp = 0);
+  bool AppendString(int entry, StringRef value, int64_t timestamp = 0);
+  bool AppendDoubleArray(int entry, ArrayRef<double> arr,
+                         int64_t timestamp = 0);
+
+  /**
+   * Gets the number of records dropped because a thread's buffer was full or
+   * the file could not be written.
+   *
+   * @return Number of dropped records
+   */
+  uint64_t GetDroppedCount() const;
+
+ private:
+  class ThreadBuffer;
+
+  ThreadBuffer* GetThreadBuffer();
+  bool Append(int entry, int64_t timestamp, ArrayRef<uint8_t> data);
+  void WriterThreadMain();
+  void OpenFile();
+  void CloseFile();
+  void WriteControl(ArrayRef<uint8_t> records, bool start);
+  void WriteRecord(ArrayRef<uint8_t> record);
+
+  // Unique (across all logs) identifier of this log, used to find the
+  // calling thread's buffer
+  const uint64_t m_serial;
+  const size_t m_bufferSize;
+  const double m_period;
+  const uint64_t m_maxFileSize;
+
+  mutable wpi::mutex m_mutex;
+  wpi::condition_variable m_cond;
+  bool m_shutdown = false;
+  bool m_doFlush = false;
+  std::string m_filename;  // of the first file
+  std::string m_currentFilename;
+  wpi::StringMap<int> m_entryIds;
+  int m_nextEntry = 1;
+  std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+  // Control records waiting to be written; start records are written before
+  // and finish records after the data records collected at the same time
+  std::vector<uint8_t> m_pendingStarts;
+  std::vector<uint8_t> m_pendingFinishes;
+  std::atomic<uint64_t> m_dropped{0};
+
+  // Only used by the writer thread
+  std::unique_ptr<raw_fd_ostream> m_os;
+  unsigned int m_fileIndex = 0;
+  uint64_t m_fileSize = 0;
+  bool m_fileHasData = false;
+  // Start records of entries not yet finished, by entry
+  std::vector<std::vector<uint8_t>> m_activeStarts;
+
+  std::thread m_thread;
+};
+
+/**
+ * Log entry base class.
+ */
+class DataLogEntry {
+ protected:
+  DataLogEntry() = default;
+  DataLogEntry(DataLog& log, StringRef name, StringRef type,
+               StringRef metadata = {}, int64_t timestamp = 0)
+      : m_log{&log}, m_entry{log.Start(name, type, metadata, timestamp)} {}
+
+ public:
+  DataLogEntry(const DataLogEntry&) = delete;
+  DataLogEntry& operator=(const DataLogEntry&) = delete;
+
+  DataLogEntry(DataLogEntry&& rhs) : m_log{rhs.m_log}, m_entry{rhs.m_entry} {
+    rhs.m_log = nullptr;
+  }
+  DataLogEntry& operator=(DataLogEntry&& rhs) {
+    if (m_log) {
+      m_log->Finish(m_entry);
+    }
+    m_log = rhs.m_log;
+    rhs.m_log = nullptr;
+    m_entry = rhs.m_entry;
+    return *this;
+  }
+
+  explicit operator bool() const { return m_log != nullptr; }
+
+  /**
+   * Finishes the entry.
+   *
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Finish(int64_t timestamp = 0) {
+    if (m_log) {
+      m_log->Finish(m_entry, timestamp);
+      m_log = nullptr;
+    }
+  }
+
+ protected:
+  ~DataLogEntry() { Finish(); }
+
+  DataLog* m_log = nullptr;
+  int m_entry = 0;
+};
+
+/**
+ * Log arbitrary byte data.
+ */
+class RawLogEntry : public DataLogEntry {
+ public:
+  static constexpr const char* kDataType = "raw";
+
+  RawLogEntry() = default;
+  RawLogEntry(DataLog& log, StringRef name, StringRef metadata = {},
+              int64_t timestamp = 0)
+      : DataLogEntry{log, name, kDataType, metadata, timestamp} {}
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param data Byte array to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(ArrayRef<uint8_t> data, int64_t timestamp = 0) {
+    m_log->AppendRaw(m_entry, data, timestamp);
+  }
+};
+
+/**
+ * Log boolean values.
+ */
+class BooleanLogEntry : public DataLogEntry {
+ public:
+  static constexpr const char* kDataType = "boolean";
+
+  BooleanLogEntry() = default;
+  BooleanLogEntry(DataLog& log, StringRef name, StringRef metadata = {},
+                  int64_t timestamp = 0)
+      : DataLogEntry{log, name, kDataType, metadata, timestamp} {}
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param value Value to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(bool value, int64_t timestamp = 0) {
+    m_log->AppendBoolean(m_entry, value, timestamp);
+  }
+};
+
+/**
+ * Log integer values.
+ */
+class IntegerLogEntry : public DataLogEntry {
+ public:
+  static constexpr const char* kDataType = "int64";
+
+  IntegerLogEntry() = default;
+  IntegerLogEntry(DataLog& log, StringRef name, StringRef metadata = {},
+                  int64_t timestamp = 0)
+      : DataLogEntry{log, name, kDataType, metadata, timestamp} {}
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param value Value to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(int64_t value, int64_t timestamp = 0) {
+    m_log->AppendInteger(m_entry, value, timestamp);
+  }
+};
+
+/**
+ * Log float values.
+ */
+class FloatLogEntry : public DataLogEntry {
+ public:
+  static constexpr const char* kDataType = "float";
+
+  FloatLogEntry() = default;
+  FloatLogEntry(DataLog& log, StringRef name, StringRef metadata = {},
+                int64_t timestamp = 0)
+      : DataLogEntry{log, name, kDataType, metadata, timestamp} {}
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param value Value to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(float value, int64_t timestamp = 0) {
+    m_log->AppendFloat(m_entry, value, timestamp);
+  }
+};
+
+/**
+ * Log double values.
+ */
+class DoubleLogEntry : public DataLogEntry {
+ public:
+  static constexpr const char* kDataType = "double";
+
+  DoubleLogEntry() = default;
+  DoubleLogEntry(DataLog& log, StringRef name, StringRef metadata = {},
+                 int64_t timestamp = 0)
+      : DataLogEntry{log, name, kDataType, metadata, timestamp} {}
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param value Value to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(double value, int64_t timestamp = 0) {
+    m_log->AppendDouble(m_entry, value, timestamp);
+  }
+};
+
+/**
+ * Log string values.
+ */
+class StringLogEntry : public DataLogEntry {
+ public:
+  static constexpr const char* kDataType = "string";
+
+  StringLogEntry() = default;
+  StringLogEntry(DataLog& log, StringRef name, StringRef metadata = {},
+                 int64_t timestamp = 0)
+      : DataLogEntry{log, name, kDataType, metadata, timestamp} {}
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param value Value to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(StringRef value, int64_t timestamp = 0) {
+    m_log->AppendString(m_entry, value, timestamp);
+  }
+};
+
+/**
+ * Log array of double values.
+ */
+class DoubleArrayLogEntry : public DataLogEntry {
+ public:
+  static constexpr const char* kDataType = "double[]";
+
+  DoubleArrayLogEntry() = default;
+  DoubleArrayLogEntry(DataLog& log, StringRef name, StringRef metadata = {},
+                      int64_t timestamp = 0)
+      : DataLogEntry{log, name, kDataType, metadata, timestamp} {}
+
+  /**
+   * Appends a record to the log.
+   *
+   * @param arr Values to record
+   * @param timestamp Time stamp (may be 0 to indicate now)
+   */
+  void Append(ArrayRef<double> arr, int64_t timestamp = 0) {
+    m_log->AppendDoubleArray(m_entry, arr, timestamp);
+  }
+};
+
+}  // namespace log
+}  // namespace wpi
+
+#endif  // WPIUTIL_WPI_DATALOG_H_
@@ -0,0 +1,398 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_DATALOGREADER_H_
+#define WPIUTIL_WPI_DATALOGREADER_H_
+
+#include <stdint.h>
+
+#include <iterator>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#include "wpi/ArrayRef.h"
+#include "wpi/DenseMap.h"
+#include "wpi/StringRef.h"
+#include "wpi/Twine.h"
+
+namespace wpi {
+
+namespace sys::fs {
+class mapped_file_region;
+}  // namespace sys::fs
+
+namespace log {
+
+/**
+ * Data contained in a start control record as created by DataLog::Start() when
+ * writing the log. This can be read by calling DataLogRecord::GetStartData().
+ */
+struct StartRecordData {
+  /** Entry ID; this will be used for this entry in future records. */
+  int entry;
+
+  /** Entry name. */
+  StringRef name;
+
+  /** Type of the stored data for this entry, as a string, e.g. "double". */
+  StringRef type;
+
+  /** Initial metadata. */
+  StringRef metadata;
+};
+
+/**
+ * A record in the data log. May represent either a control record (entry == 0)
+ * or a data record. Used only for reading (e.g. with DataLogReader). The
+ * record refers to the data being read; it does not own a copy.
+ */
+class DataLogRecord {
+ public:
+  DataLogRecord() = default;
+  DataLogRecord(int entry, int64_t timestamp, ArrayRef<uint8_t> data)
+      : m_timestamp{timestamp}, m_data{data}, m_entry{entry} {}
+
+  /**
+   * Gets the entry ID.
+   *
+   * @return entry ID
+   */
+  int GetEntry() const { return m_entry; }
+
+  /**
+   * Gets the record timestamp.
+   *
+   * @return Timestamp, in integer microseconds
+   */
+  int64_t GetTimestamp() const { return m_timestamp; }
+
+  /**
+   * Gets the size of the raw data.
+   *
+   * @return size
+   */
+  size_t GetSize() const { return m_data.size(); }
+
+  /**
+   * Gets the raw data. Use the GetX functions to decode based on the data
+   * type in the entry's start record.
+   */
+  ArrayRef<uint8_t> GetRaw() const { return m_data; }
+
+  /**
+   * Returns true if the record is a control record.
+   *
+   * @return True if control record, false if normal data record.
+   */
+  bool IsControl() const { return m_entry == 0; }
+
+  /**
+   * Returns true if the record is a start control record. Use GetStartData()
+   * to decode the contents.
+   *
+   * @return True if start control record, false otherwise.
+   */
+  bool IsStart() const;
+
+  /**
+   * Returns true if the record is a finish control record. Use
+   * GetFinishEntry() to decode the contents.
+   *
+   * @return True if finish control record, false otherwise.
+   */
+  bool IsFinish() const;
+
+  /**
+   * Decodes a start control record.
+   *
+   * @param[out] out start record decoded data (if successful)
+   * @return True on success, false on error
+   */
+  bool GetStartData(StartRecordData* out) const;
+
+  /**
+   * Decodes a finish control record.
+   *
+   * @param[out] out finish record entry ID (if successful)
+   * @return True on success, false on error
+   */
+  bool GetFinishEntry(int* out) const;
+
+  /**
+   * Decodes a data record as a boolean. Note if the data type (as indicated in
+   * the corresponding start control record for this entry) is not "boolean",
+   * invalid results may be returned.
+   *
+   * @param[out] value boolean value (if successful)
+   * @return True on success, false on error
+   */
+  bool GetBoolean(bool* value) const;
+
+  /**
+   * Decodes a data record as an integer. Note if the data type (as indicated
+   * in the corresponding start control record for this entry) is not "int64",
+   * invalid results may be returned.
+   *
+   * @param[out] value integer value (if successful)
+   * @return True on success, false on error
+   */
+  bool GetInteger(int64_t* value) const;
+
+  /**
+   * Decodes a data record as a float. Note if the data type (as indicated in
+   * the corresponding start control record for this entry) is not "float",
+   * invalid results may be returned.
+   *
+   * @param[out] value float value (if successful)
+   * @return True on success, false on error
+   */
+  bool GetFloat(float* value) const;
+
+  /**
+   * Decodes a data record as a double. Note if the data type (as indicated in
+   * the corresponding start control record for this entry) is not "double",
+   * invalid results may be returned.
+   *
+   * @param[out] value double value (if successful)
+   * @return True on success, false on error
+   */
+  bool GetDouble(double* value) const;
+
+  /**
+   * Decodes a data record as a string. Note if the data type (as indicated in
+   * the corresponding start control record for this entry) is not "string",
+   * invalid results may be returned.
+   *
+   * @param[out] value string value
+   * @return True (never fails)
+   */
+  bool GetString(StringRef* value) const;
+
+  /**
+   * Decodes a data record as an array of doubles. Note if the data type (as
+   * indicated in the corresponding start control record for this entry) is
+   * not "double[]", invalid results may be returned.
+   *
+   * @param[out] arr double array (if successful)
+   * @return True on success, false on error
+   */
+  bool GetDoubleArray(std::vector<double>* arr) const;
+
+ private:
+  int64_t m_timestamp{0};
+  ArrayRef<uint8_t> m_data;
+  int m_entry{-1};
+};
+
+/**
+ * Data log reader (reads logs written by the DataLog class).
+ *
+ * The log is accessed in place: a file is memory mapped, and records refer to
+ * the mapped data rather than copies of it. On construction, the log is
+ * scanned once to build an index of the offsets of the records of each entry,
+ * which allows iterating over the records of one entry, or over the records
+ * in a time range, without scanning the whole log again.
+ *
+ * A truncated record at the end of the log (e.g. because the log was still
+ * being written) is ignored.
+ */
+class DataLogReader {
+  class RecordIterator;
+
+ public:
+  /**
+   * A range of records, in log order, selected by an index.
+   */
+  class RecordRange {
+   public:
+    RecordIterator begin() const;
+    RecordIterator end() const;
+
+    size_t size() const { return m_offsets.size(); }
+    bool empty() const { return m_offsets.empty(); }
+
+   private:
+    friend class DataLogReader;
+    RecordRange(const uint8_t* data, ArrayRef<size_t> offsets)
+        : m_data{data}, m_offsets{offsets} {}
+
+    const uint8_t* m_data;
+    ArrayRef<size_t> m_offsets;
+  };
+
+  /**
+   * An entry in the log.
+   */
+  struct EntryInfo {
+    /** Start record data; refers to the log data. */
+    StartRecordData start;
+
+    /**
+     * Offsets of the entry's data records in the log, in timestamp order
+     * (records with equal timestamps are in log order).
+     */
+    std::vector<size_t> offsets;
+  };
+
+  /**
+   * Memory maps and indexes a log file.
+   *
+   * @param filename name of the file
+   * @param ec error code (set on failure to open or map the file)
+   */
+  DataLogReader(const Twine& filename, std::error_code& ec);
+
+  /**
+   * Indexes a log in memory. The buffer must outlive the reader.
+   *
+   * @param buffer log contents
+   */
+  explicit DataLogReader(ArrayRef<uint8_t> buffer);
+
+  ~DataLogReader();
+
+  DataLogReader(const DataLogReader&) = delete;
+  DataLogReader& operator=(const DataLogReader&) = delete;
+
+  /**
+   * Returns true if the data log is valid (e.g. has a valid header).
+   */
+  explicit operator bool() const { return IsValid(); }
+
+  /**
+   * Returns true if the data log is valid (e.g. has a valid header).
+   */
+  bool IsValid() const;
+
+  /**
+   * Gets the data log version. Returns 0 if data log is invalid.
+   *
+   * @return Version number; most significant byte is major, least significant
+   *         is minor (so version 1.0 will be 0x0100)
+   */
+  uint16_t GetVersion() const;
+
+  /**
+   * Gets the size of the log data, in bytes.
+   */
+  size_t GetSize() const { return m_data.size(); }
+
+  /**
+   * Gets all records (data and control), in log order.
+   */
+  RecordRange GetRecords() const { return {m_data.data(), m_all}; }
+
+  /**
+   * Gets all data records with timestamps in [begin, end), in timestamp
+   * order.
+   *
+   * @param begin first timestamp, in microseconds
+   * @param end timestamp after the last, in microseconds
+   */
+  RecordRange GetRecords(int64_t begin, int64_t end) const;
+
+  /**
+   * Gets the entries in the log, in the order they were started.
+   */
+  ArrayRef<EntryInfo> GetEntries() const { return m_entries; }
+
+  /**
+   * Finds an entry by name. If several entries had the same name (an entry
+   * was finished and started again), this is the last one.
+   *
+   * @param name entry name
+   * @return Entry, or nullptr if there is no entry with the name
+   */
+  const EntryInfo* FindEntry(StringRef name) const;
+
+  /**
+   * Gets the data records of an entry, in timestamp order.
+   *
+   * @param entry entry
+   */
+  RecordRange GetRecords(const EntryInfo& entry) const {
+    return {m_data.data(), entry.offsets};
+  }
+
+  /**
+   * Gets the data records of an entry with timestamps in [begin, end), in
+   * timestamp order.
+   *
+   * @param entry entry
+   * @param begin first timestamp, in microseconds
+   * @param end timestamp after the last, in microseconds
+   */
+  RecordRange GetRecords(const EntryInfo& entry, int64_t begin,
+                         int64_t end) const;
+
+ private:
+  void Index();
+  RecordRange FindRange(ArrayRef<size_t> offsets, int64_t begin,
+                        int64_t end) const;
+
+  std::unique_ptr<sys::fs::mapped_file_region> m_mapping;
+  ArrayRef<uint8_t> m_data;
+  // Offsets of all records
+  std::vector<size_t> m_all;
+  // Offsets of all data records, in timestamp order
+  std::vector<size_t> m_byTime;
+  std::vector<EntryInfo> m_entries;
+  // Index into m_entries of each active entry ID
+  DenseMap<int, size_t> m_activeEntries;
+};
+
+/**
+ * Iterator over the records of a DataLogReader::RecordRange.
+ */
+class DataLogReader::RecordIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = DataLogRecord;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+  using difference_type = std::ptrdiff_t;
+
+  RecordIterator(const uint8_t* data, const size_t* offset)
+      : m_data{data}, m_offset{offset} {}
+
+  RecordIterator& operator++() {
+    ++m_offset;
+    return *this;
+  }
+
+  RecordIterator operator++(int) {
+    RecordIterator tmp = *this;
+    ++m_offset;
+    return tmp;
+  }
+
+  bool operator==(const RecordIterator& oth) const {
+    return m_offset == oth.m_offset;
+  }
+
+  bool operator!=(const RecordIterator& oth) const {
+    return m_offset != oth.m_offset;
+  }
+
+  value_type operator*() const;
+
+ private:
+  const uint8_t* m_data;
+  const size_t* m_offset;
+};
+
+inline DataLogReader::RecordIterator DataLogReader::RecordRange::begin()
+    const {
+  return {m_data, m_offsets.begin()};
+}
+
+inline DataLogReader::RecordIterator DataLogReader::RecordRange::end() const {
+  return {m_data, m_offsets.end()};
+}
+
+}  // namespace log
+}  // namespace wpi
+
+#endif  // WPIUTIL_WPI_DATALOGREADER_H_
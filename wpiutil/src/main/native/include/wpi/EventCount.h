@@ -0,0 +1,100 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_EVENTCOUNT_H_
+#define WPIUTIL_WPI_EVENTCOUNT_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#ifndef __linux__
+#include "wpi/condition_variable.h"
+#include "wpi/mutex.h"
+#endif
+
+namespace wpi {
+
+/**
+ * Lets threads wait for a condition that other threads change without
+ * locking, such as a lock-free queue becoming non-empty.
+ *
+ * A waiter calls PrepareWait(), checks the condition again, and then either
+ * calls CancelWait() (if the condition is true) or Wait(). A notifier changes
+ * the condition and then calls Notify(). Notify() is a fence and an atomic
+ * load unless a thread has started waiting since the last notification, so
+ * the notifier does not pay for blocking support it does not use.
+ *
+ * On Linux, waiting uses a futex; elsewhere, a mutex and condition variable.
+ */
+class EventCount {
+ public:
+  EventCount() = default;
+  EventCount(const EventCount&) = delete;
+  EventCount& operator=(const EventCount&) = delete;
+
+  /**
+   * Registers the calling thread as a waiter. The condition must be checked
+   * again after this.
+   *
+   * @return Key to pass to Wait()
+   */
+  uint32_t PrepareWait() {
+    return m_epoch.fetch_or(kWaiting, std::memory_order_seq_cst) | kWaiting;
+  }
+
+  /**
+   * Unregisters the calling thread as a waiter without waiting.
+   */
+  void CancelWait() {}
+
+  /**
+   * Waits until Notify() is called after PrepareWait(), and unregisters the
+   * calling thread as a waiter.
+   *
+   * @param key Value returned by PrepareWait()
+   */
+  void Wait(uint32_t key);
+
+  /**
+   * Waits until Notify() is called after PrepareWait() or the timeout
+   * expires, and unregisters the calling thread as a waiter.
+   *
+   * @param key Value returned by PrepareWait()
+   * @param timeout Timeout in seconds
+   * @return False if timed out
+   */
+  bool WaitFor(uint32_t key, double timeout);
+
+  /**
+   * Wakes all threads waiting. Call after changing the condition.
+   */
+  void Notify() {
+    // Orders the condition change before the load of the epoch; pairs with
+    // the read-modify-write in PrepareWait()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint32_t epoch = m_epoch.load(std::memory_order_relaxed);
+    if ((epoch & kWaiting) != 0) {
+      DoNotify(epoch);
+    }
+  }
+
+ private:
+  void DoNotify(uint32_t epoch);
+
+  // The low bit is set while there may be waiters that have not been woken;
+  // notifying clears it and advances the rest, so waiters blocked on the old
+  // value wake, and only the first Notify() after a PrepareWait() wakes
+  // anything
+  static constexpr uint32_t kWaiting = 1;
+  std::atomic<uint32_t> m_epoch{0};
+#ifndef __linux__
+  wpi::mutex m_mutex;
+  wpi::condition_variable m_cond;
+#endif
+};
+
+}  // namespace wpi
+
+#endif  // WPIUTIL_WPI_EVENTCOUNT_H_
@@ -0,0 +1,259 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_MPSCQUEUE_H_
+#define WPIUTIL_WPI_MPSCQUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "wpi/EventCount.h"
+
+namespace wpi {
+
+/**
+ * Bounded lock-free queue for any number of producer threads and a single
+ * consumer thread.
+ *
+ * This is a ring buffer of slots that each carry a sequence number (as in
+ * Dmitry Vyukov's bounded queue). A producer claims a slot with a single
+ * compare-and-swap on the shared tail index, fills it, and publishes it by
+ * advancing the slot's sequence number; the consumer takes slots in order
+ * without any read-modify-write operations. The head and tail indices are
+ * kept on separate cache lines.
+ *
+ * If Blocking is true, push() and pop() wait (without spinning for long) when
+ * the queue is full or empty; each operation then costs an extra memory
+ * fence. If false, only the try_ functions are available.
+ *
+ * @tparam T element type
+ * @tparam Blocking whether blocking operations are supported
+ */
+template <typename T, bool Blocking = true>
+class MpscQueue {
+ public:
+  /**
+   * Constructs a queue.
+   *
+   * @param capacity minimum number of elements the queue can hold; rounded up
+   *                 to a power of 2
+   */
+  explicit MpscQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    m_slots = std::make_unique<Slot[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+      m_slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    m_mask = size - 1;
+  }
+
+  ~MpscQueue() {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    for (;; ++head) {
+      Slot& slot = m_slots[head & m_mask];
+      if (slot.seq.load(std::memory_order_relaxed) != head + 1) {
+        break;
+      }
+      slot.get()->~T();
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  /**
+   * Gets the number of elements the queue can hold.
+   */
+  size_t capacity() const { return m_mask + 1; }
+
+  /**
+   * Gets the number of elements in the queue (including elements still being
+   * pushed). This is only a snapshot if called from a thread other than the
+   * consumer.
+   */
+  size_t size() const {
+    size_t head = m_head.load(std::memory_order_acquire);
+    size_t tail = m_tail.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * Constructs an element at the end of the queue if there is room.
+   *
+   * @return False if the queue is full
+   */
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &m_slots[tail & m_mask];
+      size_t seq = slot->seq.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(tail);
+      if (diff == 0) {
+        // slot is free; claim it
+        if (m_tail.compare_exchange_weak(tail, tail + 1,
+                                         std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // slot still holds the element from one lap ago
+        return false;
+      } else {
+        // another producer claimed the slot
+        tail = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+    new (slot->get()) T(std::forward<Args>(args)...);
+    slot->seq.store(tail + 1, std::memory_order_release);
+    if constexpr (Blocking) {
+      m_notEmpty.Notify();
+    }
+    return true;
+  }
+
+  bool try_push(const T& item) { return try_emplace(item); }
+  bool try_push(T&& item) { return try_emplace(std::move(item)); }
+
+  /**
+   * Constructs an element at the end of the queue, waiting for room if the
+   * queue is full.
+   */
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    static_assert(Blocking, "queue does not support blocking");
+    WaitUntil(m_notFull,
+              [&] { return try_emplace(std::forward<Args>(args)...); });
+  }
+
+  void push(const T& item) { emplace(item); }
+  void push(T&& item) {
+    static_assert(Blocking, "queue does not support blocking");
+    WaitUntil(m_notFull, [&] { return try_emplace(std::move(item)); });
+  }
+
+  /**
+   * Removes the element at the front of the queue if there is one. Consumer
+   * only.
+   *
+   * @param item element (if successful)
+   * @return False if the queue is empty, or the producer of the element at
+   *         the front has not finished pushing it
+   */
+  bool try_pop(T& item) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    Slot& slot = m_slots[head & m_mask];
+    if (slot.seq.load(std::memory_order_acquire) != head + 1) {
+      return false;
+    }
+    T* elem = slot.get();
+    item = std::move(*elem);
+    elem->~T();
+    // free the slot for the producers of the next lap
+    slot.seq.store(head + m_mask + 1, std::memory_order_release);
+    m_head.store(head + 1, std::memory_order_release);
+    if constexpr (Blocking) {
+      // waking producers when the queue is half empty rather than at the
+      // first free slot lets them push a batch each time they run
+      if (m_tail.load(std::memory_order_relaxed) - (head + 1) <= m_mask / 2) {
+        m_notFull.Notify();
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Removes the element at the front of the queue, waiting for one if the
+   * queue is empty. Consumer only.
+   */
+  T pop() {
+    T item;
+    pop(item);
+    return item;
+  }
+
+  void pop(T& item) {
+    static_assert(Blocking, "queue does not support blocking");
+    WaitUntil(m_notEmpty, [&] { return try_pop(item); });
+  }
+
+  /**
+   * Removes the element at the front of the queue, waiting up to a timeout
+   * for one if the queue is empty. Consumer only.
+   *
+   * @param item element (if successful)
+   * @param timeout timeout in seconds
+   * @return False if timed out
+   */
+  bool pop_for(T& item, double timeout) {
+    static_assert(Blocking, "queue does not support blocking");
+    return WaitUntil(m_notEmpty, [&] { return try_pop(item); }, timeout);
+  }
+
+ private:
+  struct Slot {
+    T* get() { return reinterpret_cast<T*>(&storage); }
+    std::atomic<size_t> seq;
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+  };
+
+  // Retries op until it succeeds (or the timeout, in seconds, expires);
+  // spins briefly before blocking
+  template <typename F>
+  static bool WaitUntil(EventCount& event, F&& op, double timeout = -1) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (op()) {
+        return true;
+      }
+    }
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::duration<double>(timeout);
+    for (;;) {
+      uint32_t key = event.PrepareWait();
+      if (op()) {
+        event.CancelWait();
+        return true;
+      }
+      if (timeout < 0) {
+        event.Wait(key);
+      } else if (!event.WaitFor(
+                     key, std::chrono::duration<double>(
+                              deadline - std::chrono::steady_clock::now())
+                              .count())) {
+        return op();
+      }
+    }
+  }
+
+  static constexpr int kSpinCount = 64;
+  static constexpr size_t kCacheLineSize = 64;
+
+  // Shared, read only
+  std::unique_ptr<Slot[]> m_slots;
+  size_t m_mask;
+
+  // Producers
+  alignas(kCacheLineSize) std::atomic<size_t> m_tail{0};
+  EventCount m_notEmpty;
+
+  // Consumer
+  alignas(kCacheLineSize) std::atomic<size_t> m_head{0};
+  EventCount m_notFull;
+};
+
+}  // namespace wpi
+
+#endif  // WPIUTIL_WPI_MPSCQUEUE_H_
@@ -0,0 +1,236 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_SPSCQUEUE_H_
+#define WPIUTIL_WPI_SPSCQUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "wpi/EventCount.h"
+
+namespace wpi {
+
+/**
+ * Bounded lock-free queue for a single producer thread and a single consumer
+ * thread.
+ *
+ * This is a ring buffer. The producer and consumer each own one index, kept
+ * on its own cache line, and keep a cached copy of the other's index so they
+ * only read the other's cache line when the queue looks full (or empty).
+ *
+ * If Blocking is true, push() and pop() wait (without spinning for long) when
+ * the queue is full or empty; each operation then costs an extra memory
+ * fence. If false, only the try_ functions are available.
+ *
+ * @tparam T element type
+ * @tparam Blocking whether blocking operations are supported
+ */
+template <typename T, bool Blocking = true>
+class SpscQueue {
+ public:
+  /**
+   * Constructs a queue.
+   *
+   * @param capacity minimum number of elements the queue can hold; rounded up
+   *                 to a power of 2
+   */
+  explicit SpscQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    m_slots = std::make_unique<Slot[]>(size);
+    m_mask = size - 1;
+  }
+
+  ~SpscQueue() {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    for (size_t i = m_head.load(std::memory_order_relaxed); i != tail; ++i) {
+      m_slots[i & m_mask].get()->~T();
+    }
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /**
+   * Gets the number of elements the queue can hold.
+   */
+  size_t capacity() const { return m_mask + 1; }
+
+  /**
+   * Gets the number of elements in the queue. This is only a snapshot if
+   * called from a thread that is neither the producer nor the consumer.
+   */
+  size_t size() const {
+    return m_tail.load(std::memory_order_acquire) -
+           m_head.load(std::memory_order_acquire);
+  }
+
+  bool empty() const { return size() == 0; }
+
+  /**
+   * Constructs an element at the end of the queue if there is room.
+   * Producer only.
+   *
+   * @return False if the queue is full
+   */
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_headCache > m_mask) {
+      m_headCache = m_head.load(std::memory_order_acquire);
+      if (tail - m_headCache > m_mask) {
+        return false;
+      }
+    }
+    new (m_slots[tail & m_mask].get()) T(std::forward<Args>(args)...);
+    m_tail.store(tail + 1, std::memory_order_release);
+    if constexpr (Blocking) {
+      m_notEmpty.Notify();
+    }
+    return true;
+  }
+
+  bool try_push(const T& item) { return try_emplace(item); }
+  bool try_push(T&& item) { return try_emplace(std::move(item)); }
+
+  /**
+   * Constructs an element at the end of the queue, waiting for room if the
+   * queue is full. Producer only.
+   */
+  template <typename... Args>
+  void emplace(Args&&... args) {
+    static_assert(Blocking, "queue does not support blocking");
+    WaitUntil(m_notFull,
+              [&] { return try_emplace(std::forward<Args>(args)...); });
+  }
+
+  void push(const T& item) { emplace(item); }
+  void push(T&& item) {
+    static_assert(Blocking, "queue does not support blocking");
+    WaitUntil(m_notFull, [&] { return try_emplace(std::move(item)); });
+  }
+
+  /**
+   * Removes the element at the front of the queue if there is one. Consumer
+   * only.
+   *
+   * @param item element (if successful)
+   * @return False if the queue is empty
+   */
+  bool try_pop(T& item) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tailCache) {
+      m_tailCache = m_tail.load(std::memory_order_acquire);
+      if (head == m_tailCache) {
+        return false;
+      }
+    }
+    T* slot = m_slots[head & m_mask].get();
+    item = std::move(*slot);
+    slot->~T();
+    m_head.store(head + 1, std::memory_order_release);
+    if constexpr (Blocking) {
+      // waking the producer when the queue is half empty rather than at the
+      // first free slot lets it push a batch each time it runs
+      if (m_tailCache - (head + 1) <= m_mask / 2) {
+        m_notFull.Notify();
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Removes the element at the front of the queue, waiting for one if the
+   * queue is empty. Consumer only.
+   */
+  T pop() {
+    T item;
+    pop(item);
+    return item;
+  }
+
+  void pop(T& item) {
+    static_assert(Blocking, "queue does not support blocking");
+    WaitUntil(m_notEmpty, [&] { return try_pop(item); });
+  }
+
+  /**
+   * Removes the element at the front of the queue, waiting up to a timeout
+   * for one if the queue is empty. Consumer only.
+   *
+   * @param item element (if successful)
+   * @param timeout timeout in seconds
+   * @return False if timed out
+   */
+  bool pop_for(T& item, double timeout) {
+    static_assert(Blocking, "queue does not support blocking");
+    return WaitUntil(m_notEmpty, [&] { return try_pop(item); }, timeout);
+  }
+
+ private:
+  struct Slot {
+    T* get() { return reinterpret_cast<T*>(&storage); }
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+  };
+
+  // Retries op until it succeeds (or the timeout, in seconds, expires);
+  // spins briefly before blocking
+  template <typename F>
+  static bool WaitUntil(EventCount& event, F&& op, double timeout = -1) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (op()) {
+        return true;
+      }
+    }
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::duration<double>(timeout);
+    for (;;) {
+      uint32_t key = event.PrepareWait();
+      if (op()) {
+        event.CancelWait();
+        return true;
+      }
+      if (timeout < 0) {
+        event.Wait(key);
+      } else if (!event.WaitFor(
+                     key, std::chrono::duration<double>(
+                              deadline - std::chrono::steady_clock::now())
+                              .count())) {
+        return op();
+      }
+    }
+  }
+
+  static constexpr int kSpinCount = 64;
+
+  static constexpr size_t kCacheLineSize = 64;
+
+  // Shared, read only
+  std::unique_ptr<Slot[]> m_slots;
+  size_t m_mask;
+
+  // Producer; the producer notifies m_notEmpty on every push, so it is kept
+  // on the producer's line (and the consumer only writes to it to wait)
+  alignas(kCacheLineSize) std::atomic<size_t> m_tail{0};
+  size_t m_headCache = 0;
+  EventCount m_notEmpty;
+
+  // Consumer
+  alignas(kCacheLineSize) std::atomic<size_t> m_head{0};
+  size_t m_tailCache = 0;
+  EventCount m_notFull;
+};
+
+}  // namespace wpi
+
+#endif  // WPIUTIL_WPI_SPSCQUEUE_H_
@@ -0,0 +1,219 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_THREADPOOL_H_
+#define WPIUTIL_WPI_THREADPOOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "wpi/ArrayRef.h"
+#include "wpi/EventCount.h"
+#include "wpi/FunctionExtras.h"
+#include "wpi/future.h"
+#include "wpi/mutex.h"
+
+namespace wpi {
+
+namespace detail {
+
+template <typename R>
+struct ThreadPoolResult {
+  template <typename F, typename... Args>
+  static void Run(uint64_t request, F& func, Args&&... args) {
+    PromiseFactory<R>::GetInstance().SetValue(
+        request, func(std::forward<Args>(args)...));
+  }
+};
+
+template <>
+struct ThreadPoolResult<void> {
+  template <typename F, typename... Args>
+  static void Run(uint64_t request, F& func, Args&&... args) {
+    func(std::forward<Args>(args)...);
+    PromiseFactory<void>::GetInstance().SetValue(request);
+  }
+};
+
+}  // namespace detail
+
+/**
+ * A pool of worker threads that run tasks submitted from any thread.
+ *
+ * Libraries can use the shared pool returned by GetDefault() to run parallel
+ * work without owning threads of their own.
+ *
+ * Each worker has its own queue of tasks for each priority. Tasks submitted
+ * from a worker (e.g. tasks that split their work into more tasks) go to that
+ * worker's queue, and are run most recently submitted first, while the
+ * caches are still warm; tasks submitted from other threads are spread over
+ * the workers and run in the order submitted. A worker that runs out of tasks
+ * steals from the other end of another worker's queue. Higher priority tasks
+ * are always run first: a worker steals a high priority task before running
+ * a normal priority task of its own.
+ *
+ * Results are provided as wpi::future values, so continuations can be
+ * attached with future::then() (running on the worker that completes the
+ * task) or Then() (running as a new task on the pool).
+ *
+ * On destruction, all tasks already submitted are run before the workers
+ * exit.
+ */
+class ThreadPool final {
+ public:
+  /**
+   * Task priority.
+   */
+  enum Priority { kHigh = 0, kNormal, kLow };
+
+  /**
+   * Constructs a thread pool.
+   *
+   * @param numThreads number of worker threads; if 0, the number of CPUs
+   *                   given, or if none are given, the number of hardware
+   *                   threads
+   * @param cpus CPUs the workers run on; worker i is bound to
+   *             cpus[i % cpus.size()].  If empty, workers are not bound.
+   *             Only supported on Linux and Windows.
+   */
+  explicit ThreadPool(int numThreads = 0, ArrayRef<int> cpus = {});
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * Gets the shared thread pool, which has a worker per hardware thread.
+   */
+  static ThreadPool& GetDefault();
+
+  /**
+   * Gets the number of worker threads.
+   */
+  int GetNumThreads() const { return static_cast<int>(m_workers.size()); }
+
+  /**
+   * Returns true if called from one of this pool's worker threads.
+   */
+  bool IsWorkerThread() const;
+
+  /**
+   * Submits a task whose result is not needed.
+   *
+   * @param priority priority
+   * @param func task
+   */
+  void Post(Priority priority, unique_function<void()> func);
+
+  void Post(unique_function<void()> func) { Post(kNormal, std::move(func)); }
+
+  /**
+   * Submits a task.
+   *
+   * @param priority priority
+   * @param func task
+   * @return Future for the return value of func
+   */
+  template <typename F, typename R = std::invoke_result_t<F>>
+  future<R> Submit(Priority priority, F&& func) {
+    auto& factory = PromiseFactory<R>::GetInstance();
+    uint64_t request = factory.CreateRequest();
+    Post(priority, [request, func = std::forward<F>(func)]() mutable {
+      detail::ThreadPoolResult<R>::Run(request, func);
+    });
+    return factory.CreateFuture(request);
+  }
+
+  template <typename F, typename R = std::invoke_result_t<F>>
+  future<R> Submit(F&& func) {
+    return Submit(kNormal, std::forward<F>(func));
+  }
+
+  /**
+   * Runs a function on a future's value as a new task, once the value is
+   * available.
+   *
+   * @param f future
+   * @param func function, called with the value
+   * @param priority priority of the task
+   * @return Future for the return value of func
+   */
+  template <typename T, typename F,
+            typename R = std::invoke_result_t<F, T&&>>
+  future<R> Then(future<T>&& f, F&& func, Priority priority = kNormal) {
+    auto& factory = PromiseFactory<R>::GetInstance();
+    uint64_t request = factory.CreateRequest();
+    f.then([this, request, priority,
+            func = std::forward<F>(func)](T value) {
+      Post(priority, [request, func, value = std::move(value)]() mutable {
+        detail::ThreadPoolResult<R>::Run(request, func, std::move(value));
+      });
+    });
+    return factory.CreateFuture(request);
+  }
+
+  template <typename F, typename R = std::invoke_result_t<F>>
+  future<R> Then(future<void>&& f, F&& func, Priority priority = kNormal) {
+    auto& factory = PromiseFactory<R>::GetInstance();
+    uint64_t request = factory.CreateRequest();
+    f.then([this, request, priority, func = std::forward<F>(func)] {
+      Post(priority, [request, func]() mutable {
+        detail::ThreadPoolResult<R>::Run(request, func);
+      });
+    });
+    return factory.CreateFuture(request);
+  }
+
+  /**
+   * Calls func(begin, end) for consecutive subranges of [first, last) in
+   * parallel, and waits for all the calls to return. The calling thread
+   * runs subranges too, so this may be called from a task.
+   *
+   * @param first start of the range
+   * @param last end of the range
+   * @param grain size of each subrange (the last may be smaller)
+   * @param func function, called with the start and end of each subrange
+   * @param priority priority of the tasks
+   */
+  void ParallelFor(size_t first, size_t last, size_t grain,
+                   std::function<void(size_t, size_t)> func,
+                   Priority priority = kNormal);
+
+ private:
+  static constexpr int kNumPriorities = 3;
+
+  struct Worker {
+    wpi::mutex mutex;
+    std::deque<unique_function<void()>> tasks[kNumPriorities];
+    // Number of tasks in each queue; lets other workers skip empty queues
+    // without locking
+    std::atomic<size_t> count[kNumPriorities] = {};
+    std::thread thread;
+  };
+
+  void WorkerMain(size_t index, int cpu);
+  bool RunTask(size_t index);
+  unique_function<void()> Take(Worker& worker, int priority, bool own);
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::atomic<size_t> m_next{0};    // worker to give the next outside task
+  std::atomic<size_t> m_queued{0};  // tasks not yet started
+  std::atomic<bool> m_active{true};
+  EventCount m_event;
+};
+
+}  // namespace wpi
+
+#endif  // WPIUTIL_WPI_THREADPOOL_H_
@@ -0,0 +1,168 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#ifndef WPIUTIL_WPI_TRACE_H_
+#define WPIUTIL_WPI_TRACE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <system_error>
+
+#include "wpi/Twine.h"
+#include "wpi/timestamp.h"
+
+namespace wpi {
+
+class raw_ostream;
+
+/**
+ * Lightweight tracing of where time goes across threads.
+ *
+ * Code is instrumented with spans (timed regions), instant events, and
+ * counters, usually through the WPI_TRACE_ macros. While tracing is disabled
+ * (the default), each of these costs a function call and a relaxed atomic
+ * load. While it is enabled, events are timestamped with wpi::Now() and
+ * recorded into a per-thread ring buffer without locking; when a thread's
+ * buffer is full, its oldest events are overwritten. The buffered events of
+ * all threads can be written at any time in the Chrome trace event JSON
+ * format, for viewing in chrome://tracing or Perfetto.
+ *
+ * Event names are not copied, so they must be string literals (or otherwise
+ * remain valid until the events are written or cleared).
+ *
+ * Defining WPI_TRACE_DISABLED compiles the WPI_TRACE_ macros out entirely.
+ */
+namespace trace {
+
+/**
+ * Enables or disables recording of events.
+ */
+void SetEnabled(bool enabled);
+
+/**
+ * Returns true if events are being recorded.
+ */
+bool IsEnabled();
+
+/**
+ * Sets the number of events each thread's buffer holds. Only affects buffers
+ * created after the call; a thread's buffer is created when it first records
+ * an event. The default is 4096.
+ *
+ * @param size number of events (rounded up to a power of 2)
+ */
+void SetBufferSize(size_t size);
+
+/**
+ * Names the calling thread in the trace output.
+ *
+ * @param name thread name
+ */
+void SetThreadName(const Twine& name);
+
+/**
+ * Records a completed span.
+ *
+ * @param name span name
+ * @param start start time, as returned by wpi::Now()
+ * @param end end time, as returned by wpi::Now()
+ */
+void Complete(const char* name, uint64_t start, uint64_t end);
+
+/**
+ * Records an instant event at the current time.
+ *
+ * @param name event name
+ */
+void Instant(const char* name);
+
+/**
+ * Records the value of a counter at the current time.
+ *
+ * @param name counter name
+ * @param value value
+ */
+void Counter(const char* name, double value);
+
+/**
+ * Discards all recorded events, and the buffers of threads that have exited.
+ */
+void Clear();
+
+/**
+ * Writes all recorded events in Chrome trace event JSON format. Threads may
+ * keep recording events while this runs; events overwritten while being
+ * written are left out.
+ *
+ * @param os output stream
+ */
+void WriteJson(raw_ostream& os);
+
+/**
+ * Writes all recorded events in Chrome trace event JSON format to a file.
+ *
+ * @param filename file name
+ * @param ec error code (set on failure)
+ */
+void WriteJson(const Twine& filename, std::error_code& ec);
+
+/**
+ * Records a span covering the lifetime of this object.
+ */
+class Span {
+ public:
+  /**
+   * Starts a span.
+   *
+   * @param name span name
+   */
+  explicit Span(const char* name) : m_name{name}, m_enabled{IsEnabled()} {
+    if (m_enabled) {
+      m_start = Now();
+    }
+  }
+
+  ~Span() {
+    if (m_enabled) {
+      Complete(m_name, m_start, Now());
+    }
+  }
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+ private:
+  const char* m_name;
+  bool m_enabled;
+  uint64_t m_start = 0;
+};
+
+}  // namespace trace
+}  // namespace wpi
+
+#define WPI_TRACE_CONCAT_IMPL(a, b) a##b
+#define WPI_TRACE_CONCAT(a, b) WPI_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef WPI_TRACE_DISABLED
+#define WPI_TRACE_SPAN(name) \
+  do {                       \
+  } while (0)
+#define WPI_TRACE_INSTANT(name) \
+  do {                          \
+  } while (0)
+#define WPI_TRACE_COUNTER(name, value) \
+  do {                                 \
+  } while (0)
+#else
+/**
+ * Records a span from this point to the end of the enclosing scope.
+ */
+#define WPI_TRACE_SPAN(name) \
+  ::wpi::trace::Span WPI_TRACE_CONCAT(wpi_trace_span_, __LINE__) { name }
+#define WPI_TRACE_INSTANT(name) ::wpi::trace::Instant(name)
+#define WPI_TRACE_COUNTER(name, value) ::wpi::trace::Counter(name, value)
+#endif
+
+#endif  // WPIUTIL_WPI_TRACE_H_
@@ -0,0 +1,122 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/AsyncLogger.h"  // NOLINT(build/include_order)
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "wpi/condition_variable.h"
+#include "wpi/mutex.h"
+
+namespace wpi {
+
+namespace {
+struct Message {
+  unsigned int level;
+  std::string msg;
+  std::thread::id thread;
+};
+}  // namespace
+
+TEST(AsyncLoggerTest, Order) {
+  std::vector<Message> messages;
+  {
+    AsyncLogger asyncLog{[&](unsigned int level, const char* file,
+                             unsigned int line, const char* msg) {
+      messages.push_back({level, msg, std::this_thread::get_id()});
+    }};
+    Logger logger{asyncLog.GetLogFunc(), WPI_LOG_DEBUG};
+    for (int i = 0; i < 100; ++i) {
+      WPI_INFO(logger, "message " << i);
+    }
+    // longer than the inline buffer
+    WPI_WARNING(logger, std::string(500, 'x'));
+  }
+  ASSERT_EQ(messages.size(), 101u);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(messages[i].level, static_cast<unsigned int>(WPI_LOG_INFO));
+    EXPECT_EQ(messages[i].msg, "message " + std::to_string(i));
+    EXPECT_NE(messages[i].thread, std::this_thread::get_id());
+  }
+  EXPECT_EQ(messages[100].msg, std::string(500, 'x'));
+}
+
+TEST(AsyncLoggerTest, Flush) {
+  wpi::mutex mutex;
+  int count = 0;
+  // messages handled for each thread (each message is its thread's index)
+  int handled[4] = {0};
+  AsyncLogger asyncLog{[&](unsigned int, const char*, unsigned int,
+                           const char* msg) {
+    std::scoped_lock lock(mutex);
+    ++count;
+    ++handled[msg[0] - '0'];
+  }};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&, i] {
+      const char msg[2] = {static_cast<char>('0' + i), '\0'};
+      for (int j = 0; j < 100; ++j) {
+        asyncLog.Log(WPI_LOG_INFO, __FILE__, __LINE__, msg);
+        if (j % 10 == 0) {
+          asyncLog.Flush();
+          // the queue never fills, so none of this thread's messages were
+          // dropped
+          std::scoped_lock lock(mutex);
+          EXPECT_EQ(handled[i], j + 1);
+        }
+      }
+    });
+  }
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  asyncLog.Flush();
+  std::scoped_lock lock(mutex);
+  EXPECT_EQ(static_cast<uint64_t>(count) + asyncLog.GetDroppedCount(), 400u);
+}
+
+TEST(AsyncLoggerTest, Dropped) {
+  wpi::mutex mutex;
+  wpi::condition_variable cond;
+  bool blocked = true;
+  std::vector<Message> messages;
+  AsyncLogger asyncLog{[&](unsigned int level, const char*, unsigned int,
+                           const char* msg) {
+                         std::unique_lock lock(mutex);
+                         cond.wait(lock, [&] { return !blocked; });
+                         messages.push_back({level, msg, {}});
+                       },
+                       4};
+
+  // the background thread blocks on the first message, so at most 4 more fit
+  for (int i = 0; i < 10; ++i) {
+    asyncLog.Log(WPI_LOG_INFO, __FILE__, __LINE__, "msg");
+  }
+  EXPECT_GE(asyncLog.GetDroppedCount(), 5u);
+  {
+    std::scoped_lock lock(mutex);
+    blocked = false;
+  }
+  cond.notify_all();
+  asyncLog.Flush();
+
+  std::scoped_lock lock(mutex);
+  uint64_t dropped = asyncLog.GetDroppedCount();
+  ASSERT_EQ(messages.size(), 10 - dropped + 1);
+  bool reported = false;
+  for (auto&& message : messages) {
+    if (message.level == WPI_LOG_WARNING) {
+      EXPECT_EQ(message.msg,
+                "dropped " + std::to_string(dropped) + " log messages");
+      reported = true;
+    }
+  }
+  EXPECT_TRUE(reported);
+}
+
+}  // namespace wpi
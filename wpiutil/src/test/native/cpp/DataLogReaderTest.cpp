@@ -0,0 +1,169 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/DataLogReader.h"  // NOLINT(build/include_order)
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "wpi/DataLog.h"
+#include "wpi/Twine.h"
+
+namespace wpi::log {
+
+namespace {
+
+class DataLogReaderTest : public ::testing::Test {
+ protected:
+  DataLogReaderTest()
+      : filename{(Twine(::testing::TempDir()) + "datalogreader.wpilog").str()} {
+    DataLog log{"", filename};
+    DoubleLogEntry a{log, "a", "", 1};
+    StringLogEntry b{log, "b", "", 1};
+    for (int i = 0; i < 10; ++i) {
+      a.Append(i * 0.5, 10 + i * 10);
+      // each b record is older than the a record before it
+      b.Append(Twine(i).str(), 5 + i * 10);
+    }
+    a.Finish(200);
+    DoubleLogEntry a2{log, "a", "again", 201};
+    a2.Append(99.0, 210);
+  }
+
+  ~DataLogReaderTest() override { remove(filename.c_str()); }
+
+  std::string filename;
+};
+
+}  // namespace
+
+TEST_F(DataLogReaderTest, Entries) {
+  std::error_code ec;
+  DataLogReader reader{filename, ec};
+  ASSERT_FALSE(ec);
+  ASSERT_TRUE(reader);
+  EXPECT_EQ(reader.GetVersion(), 0x0100);
+
+  auto entries = reader.GetEntries();
+  ASSERT_EQ(entries.size(), 3u);
+  EXPECT_EQ(entries[0].start.name, "a");
+  EXPECT_EQ(entries[0].start.type, "double");
+  EXPECT_EQ(entries[0].offsets.size(), 10u);
+  EXPECT_EQ(entries[1].start.name, "b");
+  EXPECT_EQ(entries[2].start.name, "a");
+  EXPECT_EQ(entries[2].start.metadata, "again");
+  EXPECT_EQ(reader.FindEntry("a"), &entries[2]);
+  EXPECT_EQ(reader.FindEntry("c"), nullptr);
+
+  int i = 0;
+  for (auto&& record : reader.GetRecords(entries[1])) {
+    StringRef value;
+    ASSERT_TRUE(record.GetString(&value));
+    EXPECT_EQ(value, Twine(i).str());
+    EXPECT_EQ(record.GetTimestamp(), 5 + i * 10);
+    ++i;
+  }
+  EXPECT_EQ(i, 10);
+
+  // 3 starts, 3 finishes, 21 data records
+  EXPECT_EQ(reader.GetRecords().size(), 27u);
+}
+
+TEST_F(DataLogReaderTest, EntryTimeRange) {
+  std::error_code ec;
+  DataLogReader reader{filename, ec};
+  auto& a = reader.GetEntries()[0];
+
+  auto range = reader.GetRecords(a, 30, 60);
+  ASSERT_EQ(range.size(), 3u);
+  std::vector<double> values;
+  for (auto&& record : range) {
+    double value;
+    ASSERT_TRUE(record.GetDouble(&value));
+    values.push_back(value);
+  }
+  EXPECT_EQ(values, (std::vector<double>{1.0, 1.5, 2.0}));
+
+  EXPECT_TRUE(reader.GetRecords(a, 101, 1000).empty());
+  EXPECT_EQ(reader.GetRecords(a, 0, 1000).size(), 10u);
+}
+
+TEST_F(DataLogReaderTest, TimeRange) {
+  std::error_code ec;
+  DataLogReader reader{filename, ec};
+
+  int64_t last = 0;
+  int count = 0;
+  for (auto&& record : reader.GetRecords(20, 50)) {
+    EXPECT_FALSE(record.IsControl());
+    EXPECT_GE(record.GetTimestamp(), last);
+    last = record.GetTimestamp();
+    ++count;
+  }
+  // a at 20, 30, 40; b at 25, 35, 45
+  EXPECT_EQ(count, 6);
+  EXPECT_EQ(reader.GetRecords(0, 1000).size(), 21u);
+}
+
+TEST(DataLogReaderUnsortedTest, EntryTimeRange) {
+  // records of an entry appended from several threads may be out of
+  // timestamp order in the log
+  auto filename =
+      (Twine(::testing::TempDir()) + "datalogreader_unsorted.wpilog").str();
+  {
+    DataLog log{"", filename};
+    IntegerLogEntry c{log, "c", "", 1};
+    for (int64_t timestamp : {30, 10, 50, 20, 40}) {
+      c.Append(timestamp, timestamp);
+    }
+  }
+
+  std::error_code ec;
+  DataLogReader reader{filename, ec};
+  ASSERT_TRUE(reader);
+  auto& c = reader.GetEntries()[0];
+  std::vector<int64_t> values;
+  for (auto&& record : reader.GetRecords(c, 15, 45)) {
+    int64_t value;
+    ASSERT_TRUE(record.GetInteger(&value));
+    values.push_back(value);
+  }
+  EXPECT_EQ(values, (std::vector<int64_t>{20, 30, 40}));
+  remove(filename.c_str());
+}
+
+TEST(DataLogReaderBufferTest, Invalid) {
+  const uint8_t data[] = {'W', 'P', 'I', 'L', 'O', 'X', 0, 1};
+  DataLogReader reader{data};
+  EXPECT_FALSE(reader);
+  EXPECT_TRUE(reader.GetRecords().empty());
+}
+
+TEST(DataLogReaderBufferTest, Truncated) {
+  // header, a finish record, and part of another record
+  const uint8_t data[] = {'W', 'P', 'I', 'L', 'O', 'G', 0, 1,  //
+                          0,   0,   0,   0,   5,   0,   0, 0,  //
+                          1,   0,   0,   0,   0,   0,   0, 0,  //
+                          1,   1,   0,   0,   0,                //
+                          1,   0,   0,   0,   8,   0,   0, 0};
+  DataLogReader reader{data};
+  ASSERT_TRUE(reader);
+  ASSERT_EQ(reader.GetRecords().size(), 1u);
+  int entry;
+  EXPECT_TRUE((*reader.GetRecords().begin()).GetFinishEntry(&entry));
+  EXPECT_EQ(entry, 1);
+}
+
+TEST(DataLogReaderFileTest, Missing) {
+  std::error_code ec;
+  DataLogReader reader{
+      Twine(::testing::TempDir()) + "datalogreader_missing.wpilog", ec};
+  EXPECT_TRUE(ec);
+  EXPECT_FALSE(reader);
+}
+
+}  // namespace wpi::log
@@ -0,0 +1,270 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/DataLog.h"  // NOLINT(build/include_order)
+
+#include <stdio.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "wpi/Endian.h"
+#include "wpi/SmallString.h"
+#include "wpi/Twine.h"
+
+namespace wpi::log {
+
+namespace {
+
+struct Record {
+  uint32_t entry;
+  int64_t timestamp;
+  std::string data;
+};
+
+std::vector<uint8_t> ReadFile(const std::string& filename) {
+  std::ifstream is{filename, std::ios::binary};
+  return {std::istreambuf_iterator<char>{is}, {}};
+}
+
+// Parses a log file, checking the header
+std::vector<Record> ReadRecords(const std::string& filename) {
+  auto contents = ReadFile(filename);
+  std::vector<Record> records;
+  EXPECT_GE(contents.size(), 8u);
+  if (contents.size() < 8) {
+    return records;
+  }
+  EXPECT_EQ(std::string(contents.begin(), contents.begin() + 6), "WPILOG");
+  EXPECT_EQ(support::endian::read16le(&contents[6]), 0x0100);
+  size_t pos = 8;
+  while (pos + 16 <= contents.size()) {
+    Record record;
+    record.entry = support::endian::read32le(&contents[pos]);
+    uint32_t size = support::endian::read32le(&contents[pos + 4]);
+    record.timestamp = support::endian::read64le(&contents[pos + 8]);
+    pos += 16;
+    EXPECT_LE(pos + size, contents.size());
+    record.data.assign(reinterpret_cast<const char*>(&contents[pos]), size);
+    pos += size;
+    records.emplace_back(std::move(record));
+  }
+  EXPECT_EQ(pos, contents.size());
+  return records;
+}
+
+std::string TestFilename(const char* name) {
+  return (Twine(::testing::TempDir()) + "datalog_" + name + ".wpilog").str();
+}
+
+}  // namespace
+
+TEST(DataLogTest, StartAppendFinish) {
+  auto filename = TestFilename("basic");
+  {
+    DataLog log{"", filename};
+    DoubleLogEntry d{log, "d", "meta", 5};
+    StringLogEntry s{log, "s"};
+    EXPECT_EQ(log.Start("d", "double"), 1);
+    d.Append(1.5, 10);
+    s.Append("hello", 20);
+    d.Finish(30);
+  }
+  auto records = ReadRecords(filename);
+  ASSERT_EQ(records.size(), 6u);
+
+  // start d
+  EXPECT_EQ(records[0].entry, 0u);
+  EXPECT_EQ(records[0].timestamp, 5);
+  EXPECT_EQ(records[0].data,
+            std::string("\0\1\0\0\0\1\0\0\0d\6\0\0\0double\4\0\0\0meta", 28));
+  EXPECT_EQ(records[1].entry, 0u);
+  EXPECT_EQ(records[1].data[0], 0);
+
+  EXPECT_EQ(records[2].entry, 1u);
+  EXPECT_EQ(records[2].timestamp, 10);
+  uint64_t bits = support::endian::read64le(records[2].data.data());
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  EXPECT_EQ(value, 1.5);
+
+  EXPECT_EQ(records[3].entry, 2u);
+  EXPECT_EQ(records[3].data, "hello");
+
+  // finish d (at destruction s is finished too)
+  EXPECT_EQ(records[4].entry, 0u);
+  EXPECT_EQ(records[4].timestamp, 30);
+  EXPECT_EQ(records[4].data, std::string("\1\1\0\0\0", 5));
+  EXPECT_EQ(records[5].data, std::string("\1\2\0\0\0", 5));
+  remove(filename.c_str());
+}
+
+TEST(DataLogTest, MultipleThreads) {
+  constexpr int kThreads = 4;
+  constexpr int kRecords = 10000;
+  auto filename = TestFilename("threads");
+  uint64_t dropped;
+  {
+    DataLog log{"", filename, 0.01, 0, 1024 * 1024};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+      threads.emplace_back([&, i] {
+        IntegerLogEntry entry{log, (Twine("thread") + Twine(i)).str()};
+        for (int j = 0; j < kRecords; ++j) {
+          entry.Append(j, j + 1);
+        }
+      });
+    }
+    for (auto&& thread : threads) {
+      thread.join();
+    }
+    dropped = log.GetDroppedCount();
+  }
+  EXPECT_EQ(dropped, 0u);
+
+  // records of each entry are in order, and between its start and finish
+  std::map<uint32_t, int> next;
+  std::map<uint32_t, bool> finished;
+  for (auto&& record : ReadRecords(filename)) {
+    if (record.entry == 0) {
+      uint32_t entry = support::endian::read32le(record.data.data() + 1);
+      if (record.data[0] == 0) {
+        EXPECT_EQ(next.count(entry), 0u);
+        next[entry] = 0;
+      } else {
+        EXPECT_EQ(next[entry], kRecords);
+        finished[entry] = true;
+      }
+    } else {
+      ASSERT_EQ(next.count(record.entry), 1u);
+      EXPECT_FALSE(finished[record.entry]);
+      EXPECT_EQ(support::endian::read64le(record.data.data()),
+                static_cast<uint64_t>(next[record.entry]++));
+    }
+  }
+  EXPECT_EQ(finished.size(), static_cast<size_t>(kThreads));
+  remove(filename.c_str());
+}
+
+TEST(DataLogTest, DropWhenFull) {
+  auto filename = TestFilename("drop");
+  {
+    // the writer thread only runs at destruction
+    DataLog log{"", filename, 100, 0, 64};
+    int entry = log.Start("raw", "raw");
+    uint8_t data[16] = {0};  // 32 byte records
+    EXPECT_TRUE(log.AppendRaw(entry, data, 1));
+    EXPECT_TRUE(log.AppendRaw(entry, data, 2));
+    EXPECT_FALSE(log.AppendRaw(entry, data, 3));
+    EXPECT_EQ(log.GetDroppedCount(), 1u);
+  }
+  auto records = ReadRecords(filename);
+  ASSERT_EQ(records.size(), 3u);
+  EXPECT_EQ(records[1].timestamp, 1);
+  EXPECT_EQ(records[2].timestamp, 2);
+  remove(filename.c_str());
+}
+
+#ifdef __linux__
+TEST(DataLogTest, WriteError) {
+  // every write to /dev/full fails; the log must report it and stop writing
+  // rather than abort
+  {
+    DataLog log{"/dev", "full", 0.01};
+    int entry = log.Start("raw", "raw");
+    uint8_t data[256] = {0};
+    // the buffers never fill, so records are only dropped once the failed
+    // write has been seen
+    for (int i = 1; i <= 200 && log.GetDroppedCount() == 0; ++i) {
+      log.AppendRaw(entry, data, i);
+      log.Flush();
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GT(log.GetDroppedCount(), 0u);
+  }
+}
+#endif
+
+TEST(DataLogTest, Rotate) {
+  auto filename = TestFilename("rotate");
+  {
+    DataLog log{"", filename, 100, 200};
+    RawLogEntry entry{log, "raw"};
+    std::vector<uint8_t> data(50, 'x');
+    for (int i = 0; i < 6; ++i) {
+      entry.Append(data, i + 1);
+    }
+  }
+
+  // each file holds the start record and as many data records as fit
+  int64_t timestamp = 1;
+  for (int i = 0; i < 3; ++i) {
+    std::string name =
+        i == 0 ? filename : TestFilename(("rotate." + Twine(i)).str().c_str());
+    auto records = ReadRecords(name);
+    ASSERT_GE(records.size(), 3u) << name;
+    EXPECT_EQ(records[0].entry, 0u);
+    EXPECT_EQ(records[0].data[0], 0);
+    EXPECT_EQ(records[1].timestamp, timestamp++);
+    EXPECT_EQ(records[2].timestamp, timestamp++);
+    EXPECT_LE(ReadFile(name).size(), 200u);
+    remove(name.c_str());
+  }
+  EXPECT_TRUE(ReadFile(TestFilename("rotate.3")).empty());
+}
+
+TEST(DataLogTest, RotateOnControlRecord) {
+  // every file size from one that fits a single record to one that fits them
+  // all, so the rotation lands on each (control and data) record in turn
+  for (uint64_t maxSize = 50; maxSize < 250; ++maxSize) {
+    SCOPED_TRACE(maxSize);
+    auto filename = TestFilename("rotatecontrol");
+    {
+      DataLog log{"", filename, 100, maxSize};
+      RawLogEntry a{log, "a"};
+      RawLogEntry b{log, "b"};
+      std::vector<uint8_t> data(10, 'x');
+      a.Append(data, 1);
+      b.Append(data, 2);
+      a.Finish(3);
+      b.Append(data, 4);
+    }
+
+    // each file must start every entry it uses exactly once
+    for (int i = 0;; ++i) {
+      std::string name =
+          i == 0 ? filename
+                 : TestFilename(("rotatecontrol." + Twine(i)).str().c_str());
+      if (ReadFile(name).empty()) {
+        break;
+      }
+      SCOPED_TRACE(name);
+      std::map<uint32_t, bool> active;
+      for (auto&& record : ReadRecords(name)) {
+        if (record.entry != 0) {
+          EXPECT_TRUE(active[record.entry]) << "data without start";
+          continue;
+        }
+        ASSERT_GE(record.data.size(), 5u);
+        uint32_t entry = support::endian::read32le(&record.data[1]);
+        if (record.data[0] == 0) {
+          EXPECT_FALSE(active[entry]) << "entry " << entry << " started twice";
+          active[entry] = true;
+        } else {
+          EXPECT_TRUE(active[entry]) << "entry " << entry << " not started";
+          active[entry] = false;
+        }
+      }
+      remove(name.c_str());
+    }
+  }
+}
+
+}  // namespace wpi::log
@@ -4,6 +4,8 @@
 
 #include "wpi/HttpUtil.h"  // NOLINT(build/include_order)
 
+#include <string>
+
 #include "gtest/gtest.h"
 
 namespace wpi {
@@ -91,6 +93,18 @@ TEST(HttpMultipartScannerTest, SeqNoDashesDashes) {
   EXPECT_FALSE(scanner.IsDone());
 }
 
+TEST(HttpMultipartScannerTest, LongSkipped) {
+  HttpMultipartScanner scanner("foo", true);
+  std::string data(10000, 'x');
+  data[5000] = '\n';  // lone newline that doesn't start a boundary
+  data += "\r\n--fo";
+  EXPECT_TRUE(scanner.Execute(data).empty());
+  EXPECT_FALSE(scanner.IsDone());
+  EXPECT_EQ(scanner.Execute("o\r\nxyz"), "xyz");
+  EXPECT_TRUE(scanner.IsDone());
+  EXPECT_EQ(scanner.GetSkipped(), data + "o\r\n");
+}
+
 TEST(HttpMultipartScannerTest, SeqNoDashesNoDashes) {
   HttpMultipartScanner scanner("foo", true);
   EXPECT_TRUE(scanner.Execute("\r\nfoo\r\n").empty());
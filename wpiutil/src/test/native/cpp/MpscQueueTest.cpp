@@ -0,0 +1,70 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/MpscQueue.h"  // NOLINT(build/include_order)
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace wpi {
+
+TEST(MpscQueueTest, Capacity) {
+  MpscQueue<int> queue{8};
+  EXPECT_EQ(queue.capacity(), 8u);
+  for (int lap = 0; lap < 3; ++lap) {
+    for (int i = 0; i < 8; ++i) {
+      EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_push(8));
+    EXPECT_EQ(queue.size(), 8u);
+    int value;
+    for (int i = 0; i < 8; ++i) {
+      ASSERT_TRUE(queue.try_pop(value));
+      EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+  }
+}
+
+TEST(MpscQueueTest, DestroysElements) {
+  auto ptr = std::make_shared<int>(1);
+  {
+    MpscQueue<std::shared_ptr<int>, false> queue{4};
+    queue.try_push(ptr);
+    queue.try_push(ptr);
+    std::shared_ptr<int> out;
+    queue.try_pop(out);
+    EXPECT_EQ(ptr.use_count(), 3);
+  }
+  EXPECT_EQ(ptr.use_count(), 1);
+}
+
+TEST(MpscQueueTest, Threads) {
+  constexpr int kProducers = 4;
+  constexpr int kCount = 250000;
+  MpscQueue<std::pair<int, int>> queue{64};
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p] {
+      for (int i = 0; i < kCount; ++i) {
+        queue.emplace(p, i);
+      }
+    });
+  }
+  // the elements of each producer arrive in order
+  std::vector<int> next(kProducers, 0);
+  for (int i = 0; i < kProducers * kCount; ++i) {
+    auto [p, value] = queue.pop();
+    ASSERT_EQ(value, next[p]++);
+  }
+  for (auto&& producer : producers) {
+    producer.join();
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace wpi
@@ -0,0 +1,69 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/SpscQueue.h"  // NOLINT(build/include_order)
+
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace wpi {
+
+TEST(SpscQueueTest, Capacity) {
+  SpscQueue<int> queue{5};
+  EXPECT_EQ(queue.capacity(), 8u);
+  EXPECT_TRUE(queue.empty());
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_TRUE(queue.try_push(i));
+  }
+  EXPECT_FALSE(queue.try_push(8));
+  EXPECT_EQ(queue.size(), 8u);
+
+  int value;
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(SpscQueueTest, DestroysElements) {
+  auto ptr = std::make_shared<int>(1);
+  {
+    SpscQueue<std::shared_ptr<int>, false> queue{4};
+    queue.try_push(ptr);
+    queue.try_push(ptr);
+    std::shared_ptr<int> out;
+    queue.try_pop(out);
+    EXPECT_EQ(ptr.use_count(), 3);
+  }
+  EXPECT_EQ(ptr.use_count(), 1);
+}
+
+TEST(SpscQueueTest, PopTimeout) {
+  SpscQueue<int> queue{4};
+  int value;
+  EXPECT_FALSE(queue.pop_for(value, 0.01));
+  queue.push(5);
+  EXPECT_TRUE(queue.pop_for(value, 0.01));
+  EXPECT_EQ(value, 5);
+}
+
+TEST(SpscQueueTest, Threads) {
+  constexpr int kCount = 1000000;
+  SpscQueue<int> queue{64};
+  std::thread producer{[&] {
+    for (int i = 0; i < kCount; ++i) {
+      queue.push(i);
+    }
+  }};
+  for (int i = 0; i < kCount; ++i) {
+    ASSERT_EQ(queue.pop(), i);
+  }
+  producer.join();
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace wpi
@@ -0,0 +1,141 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/ThreadPool.h"  // NOLINT(build/include_order)
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "wpi/mutex.h"
+
+namespace wpi {
+
+TEST(ThreadPoolTest, Submit) {
+  ThreadPool pool{2};
+  EXPECT_EQ(pool.GetNumThreads(), 2);
+  EXPECT_FALSE(pool.IsWorkerThread());
+  auto f = pool.Submit([&] { return pool.IsWorkerThread(); });
+  EXPECT_TRUE(f.get());
+  std::atomic<int> count{0};
+  pool.Submit([&] { ++count; }).get();
+  EXPECT_EQ(count, 1);
+}
+
+TEST(ThreadPoolTest, Priority) {
+  ThreadPool pool{1};
+  wpi::mutex mutex;
+  std::vector<int> order;
+
+  // hold the only worker until all the tasks are queued
+  auto& factory = PromiseFactory<void>::GetInstance();
+  auto blocker = factory.CreatePromise(factory.CreateRequest());
+  auto blocked = blocker.get_future();
+  pool.Post([&] { blocked.get(); });
+  for (int i = 0; i < 2; ++i) {
+    pool.Post(ThreadPool::kLow, [&] {
+      std::scoped_lock lock(mutex);
+      order.push_back(ThreadPool::kLow);
+    });
+    pool.Post(ThreadPool::kNormal, [&] {
+      std::scoped_lock lock(mutex);
+      order.push_back(ThreadPool::kNormal);
+    });
+    pool.Post(ThreadPool::kHigh, [&] {
+      std::scoped_lock lock(mutex);
+      order.push_back(ThreadPool::kHigh);
+    });
+  }
+  blocker.set_value();
+  pool.Submit(ThreadPool::kLow, [] {}).get();
+
+  std::vector<int> expected{ThreadPool::kHigh,   ThreadPool::kHigh,
+                            ThreadPool::kNormal, ThreadPool::kNormal,
+                            ThreadPool::kLow,    ThreadPool::kLow};
+  std::scoped_lock lock(mutex);
+  EXPECT_EQ(order, expected);
+}
+
+TEST(ThreadPoolTest, Then) {
+  ThreadPool pool{2};
+  auto f = pool.Then(pool.Submit([] { return 20; }),
+                     [&](int v) {
+                       EXPECT_TRUE(pool.IsWorkerThread());
+                       return std::to_string(v + 1);
+                     });
+  EXPECT_EQ(f.get(), "21");
+
+  std::atomic<bool> ran{false};
+  pool.Then(pool.Submit([] {}), [&] { ran = true; }).get();
+  EXPECT_TRUE(ran);
+}
+
+TEST(ThreadPoolTest, NestedTasks) {
+  ThreadPool pool{4};
+  std::atomic<int> count{0};
+  // each task splits into two until the depth runs out
+  std::function<void(int)> split = [&](int depth) {
+    ++count;
+    if (depth > 0) {
+      pool.Post([&, depth] { split(depth - 1); });
+      pool.Post([&, depth] { split(depth - 1); });
+    }
+  };
+  pool.Post([&] { split(10); });
+  // low priority tasks run once the queued normal priority tasks are taken
+  while (count < (1 << 11) - 1) {
+    pool.Submit(ThreadPool::kLow, [] {}).get();
+  }
+  EXPECT_EQ(count, (1 << 11) - 1);
+}
+
+TEST(ThreadPoolTest, ParallelFor) {
+  ThreadPool pool{3};
+  std::vector<int> values(10007);
+  pool.ParallelFor(0, values.size(), 100, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      values[i] = static_cast<int>(i);
+    }
+  });
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], static_cast<int>(i));
+  }
+
+  // from inside a task, even with all other workers busy
+  std::atomic<int64_t> sum{0};
+  std::vector<future<void>> results;
+  for (int i = 0; i < 3; ++i) {
+    results.emplace_back(pool.Submit([&] {
+      pool.ParallelFor(0, 1000, 7, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          sum += i;
+        }
+      });
+    }));
+  }
+  for (auto&& result : results) {
+    result.get();
+  }
+  EXPECT_EQ(sum, 3 * 999 * 1000 / 2);
+}
+
+TEST(ThreadPoolTest, DestructorRunsTasks) {
+  std::atomic<int> count{0};
+  {
+    ThreadPool pool{2};
+    for (int i = 0; i < 1000; ++i) {
+      pool.Post([&] { ++count; });
+    }
+  }
+  EXPECT_EQ(count, 1000);
+}
+
+TEST(ThreadPoolTest, Affinity) {
+  ThreadPool pool{0, {0}};
+  EXPECT_EQ(pool.GetNumThreads(), 1);
+  EXPECT_EQ(pool.Submit([] { return 5; }).get(), 5);
+}
+
+}  // namespace wpi
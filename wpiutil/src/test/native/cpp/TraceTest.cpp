@@ -0,0 +1,150 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include "wpi/Trace.h"  // NOLINT(build/include_order)
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "wpi/SmallString.h"
+#include "wpi/json.h"
+#include "wpi/raw_ostream.h"
+
+namespace wpi {
+
+class TraceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    trace::Clear();
+    trace::SetEnabled(true);
+  }
+
+  void TearDown() override {
+    trace::SetEnabled(false);
+    trace::Clear();
+  }
+
+  static json Dump() {
+    SmallString<1024> buf;
+    raw_svector_ostream os{buf};
+    trace::WriteJson(os);
+    return json::parse(os.str());
+  }
+
+  // Counts events with the given name and phase
+  static int Count(const json& j, const std::string& name,
+                   const std::string& phase) {
+    int count = 0;
+    for (auto&& event : j.at("traceEvents")) {
+      if (event.at("name") == name && event.at("ph") == phase) {
+        ++count;
+      }
+    }
+    return count;
+  }
+};
+
+TEST_F(TraceTest, Disabled) {
+  trace::SetEnabled(false);
+  {
+    WPI_TRACE_SPAN("span");
+    WPI_TRACE_INSTANT("instant");
+    WPI_TRACE_COUNTER("counter", 1);
+  }
+  EXPECT_TRUE(Dump().at("traceEvents").empty());
+}
+
+TEST_F(TraceTest, Events) {
+  uint64_t before = Now();
+  {
+    WPI_TRACE_SPAN("outer");
+    WPI_TRACE_SPAN("inner \"quoted\"");
+    WPI_TRACE_INSTANT("instant");
+    WPI_TRACE_COUNTER("counter", 2.5);
+  }
+  auto j = Dump();
+  EXPECT_EQ(Count(j, "outer", "X"), 1);
+  EXPECT_EQ(Count(j, "inner \"quoted\"", "X"), 1);
+  EXPECT_EQ(Count(j, "instant", "i"), 1);
+  EXPECT_EQ(Count(j, "counter", "C"), 1);
+  for (auto&& event : j.at("traceEvents")) {
+    EXPECT_GE(event.at("ts").get<uint64_t>(), before);
+    if (event.at("name") == "counter") {
+      EXPECT_EQ(event.at("args").at("value").get<double>(), 2.5);
+    }
+  }
+}
+
+TEST_F(TraceTest, Threads) {
+  std::thread thread{[] {
+    trace::SetThreadName("worker");
+    WPI_TRACE_SPAN("thread span");
+  }};
+  thread.join();
+  { WPI_TRACE_SPAN("main span"); }
+
+  auto j = Dump();
+  int64_t workerTid = -1;
+  int64_t spanTid = -2;
+  int64_t mainTid = -3;
+  for (auto&& event : j.at("traceEvents")) {
+    if (event.at("ph") == "M" && event.at("args").at("name") == "worker") {
+      workerTid = event.at("tid");
+    } else if (event.at("name") == "thread span") {
+      spanTid = event.at("tid");
+    } else if (event.at("name") == "main span") {
+      mainTid = event.at("tid");
+    }
+  }
+  EXPECT_EQ(workerTid, spanTid);
+  EXPECT_NE(mainTid, spanTid);
+
+  // the exited thread's events are discarded with its buffer
+  trace::Clear();
+  EXPECT_TRUE(Dump().at("traceEvents").empty());
+}
+
+TEST_F(TraceTest, Overwrite) {
+  trace::SetBufferSize(8);
+  std::thread thread{[] {
+    for (int i = 0; i < 100; ++i) {
+      WPI_TRACE_COUNTER("count", i);
+    }
+  }};
+  thread.join();
+  trace::SetBufferSize(4096);
+
+  auto j = Dump();
+  ASSERT_EQ(Count(j, "count", "C"), 8);
+  EXPECT_EQ(j.at("traceEvents")[0].at("args").at("value").get<double>(), 92);
+}
+
+TEST_F(TraceTest, WriteWhileRecording) {
+  trace::SetBufferSize(64);
+  std::atomic<bool> done{false};
+  std::thread thread{[&] {
+    for (int i = 0; !done; ++i) {
+      WPI_TRACE_COUNTER("count", i);
+    }
+  }};
+  trace::SetBufferSize(4096);
+  for (int i = 0; i < 100; ++i) {
+    auto j = Dump();
+    // values are consecutive unless events were torn
+    double prev = -1;
+    for (auto&& event : j.at("traceEvents")) {
+      double value = event.at("args").at("value");
+      if (prev >= 0) {
+        ASSERT_EQ(value, prev + 1);
+      }
+      prev = value;
+    }
+  }
+  done = true;
+  thread.join();
+}
+
+}  // namespace wpi
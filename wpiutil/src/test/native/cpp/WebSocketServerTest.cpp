@@ -474,6 +474,45 @@ TEST_F(WebSocketServerTest, ReceiveFragmentSeparate) {
   ASSERT_EQ(gotCallback, 3);
 }
 
+// Control frames can arrive between fragments
+TEST_F(WebSocketServerTest, ReceiveFragmentWithPing) {
+  int gotCallback = 0;
+
+  std::vector<uint8_t> data(4, 0x03);
+  std::vector<uint8_t> data2(4, 0x04);
+  std::vector<uint8_t> pingData(3, 0x06);
+  std::vector<uint8_t> combData{data};
+  combData.insert(combData.end(), data2.begin(), data2.end());
+
+  setupWebSocket = [&] {
+    ws->ping.connect([&](ArrayRef<uint8_t> inData) {
+      ++gotCallback;
+      std::vector<uint8_t> recvData{inData.begin(), inData.end()};
+      ASSERT_EQ(pingData, recvData);
+    });
+    ws->binary.connect([&](ArrayRef<uint8_t> inData, bool fin) {
+      ++gotCallback;
+      ws->Terminate();
+      ASSERT_TRUE(fin);
+      std::vector<uint8_t> recvData{inData.begin(), inData.end()};
+      ASSERT_EQ(combData, recvData);
+    });
+  };
+
+  auto message = BuildMessage(0x02, false, true, data);
+  auto message2 = BuildMessage(0x09, true, true, pingData);
+  auto message3 = BuildMessage(0x00, true, true, data2);
+  resp.headersComplete.connect([&](bool) {
+    clientPipe->Write(
+        {uv::Buffer(message), uv::Buffer(message2), uv::Buffer(message3)},
+        [&](auto bufs, uv::Error) {});
+  });
+
+  loop->Run();
+
+  ASSERT_EQ(gotCallback, 2);
+}
+
 //
 // Maximum message size is limited.
 //
@@ -669,6 +708,31 @@ TEST_P(WebSocketServerDataTest, ReceiveBinary) {
   ASSERT_EQ(gotCallback, 1);
 }
 
+TEST_P(WebSocketServerDataTest, ReceiveBinaryPattern) {
+  int gotCallback = 0;
+  std::vector<uint8_t> data(GetParam());
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  setupWebSocket = [&] {
+    ws->binary.connect([&](ArrayRef<uint8_t> inData, bool fin) {
+      ++gotCallback;
+      ws->Terminate();
+      ASSERT_TRUE(fin);
+      std::vector<uint8_t> recvData{inData.begin(), inData.end()};
+      ASSERT_EQ(data, recvData);
+    });
+  };
+  auto message = BuildMessage(0x02, true, true, data);
+  resp.headersComplete.connect([&](bool) {
+    clientPipe->Write(uv::Buffer(message), [&](auto bufs, uv::Error) {});
+  });
+
+  loop->Run();
+
+  ASSERT_EQ(gotCallback, 1);
+}
+
 TEST_P(WebSocketServerDataTest, ReceivePing) {
   int gotCallback = 0;
   std::vector<uint8_t> data(GetParam(), 0x03u);
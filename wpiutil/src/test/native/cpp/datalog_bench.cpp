@@ -0,0 +1,78 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <stdio.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "wpi/DataLog.h"
+#include "wpi/DataLogReader.h"
+#include "wpi/Twine.h"
+
+TEST(DataLogBenchmark, Scan) {
+  using std::chrono::duration;
+  using std::chrono::high_resolution_clock;
+
+  // about 250 MB of records of a few typical sizes
+  auto filename =
+      (wpi::Twine(::testing::TempDir()) + "datalog_bench.wpilog").str();
+  {
+    wpi::log::DataLog log{"", filename, 0.01, 0, 16 * 1024 * 1024};
+    wpi::log::DoubleLogEntry d{log, "double"};
+    wpi::log::DoubleArrayLogEntry arr{log, "array"};
+    wpi::log::StringLogEntry str{log, "string"};
+    double values[12] = {0};
+    std::string text(100, 'x');
+    for (int i = 1; i <= 1000000; ++i) {
+      d.Append(i, i);
+      arr.Append(values, i);
+      str.Append(text, i);
+      if ((i % 10000) == 0) {
+        // keep the per-thread buffer from filling
+        log.Flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+    }
+  }
+
+  // index (one pass over the record headers)
+  auto start = high_resolution_clock::now();
+  std::error_code ec;
+  wpi::log::DataLogReader reader{filename, ec};
+  auto indexed = high_resolution_clock::now();
+  ASSERT_FALSE(ec);
+
+  // scan every record and touch its payload
+  uint64_t sum = 0;
+  size_t count = 0;
+  for (auto&& record : reader.GetRecords()) {
+    for (uint8_t byte : record.GetRaw()) {
+      sum += byte;
+    }
+    ++count;
+  }
+  auto scanned = high_resolution_clock::now();
+
+  // read one entry's values
+  double total = 0;
+  for (auto&& record : reader.GetRecords(*reader.FindEntry("double"))) {
+    double value;
+    record.GetDouble(&value);
+    total += value;
+  }
+  auto entry = high_resolution_clock::now();
+
+  double gb = reader.GetSize() / 1.0e9;
+  auto seconds = [](auto d) { return duration<double>(d).count(); };
+  std::cout << "size: " << reader.GetSize() << " records: " << count
+            << " sum: " << sum << " total: " << total << "\n"
+            << "index: " << gb / seconds(indexed - start) << " GB/s\n"
+            << "scan: " << gb / seconds(scanned - indexed) << " GB/s\n"
+            << "entry: " << seconds(entry - scanned) * 1000 << " ms\n";
+  remove(filename.c_str());
+}
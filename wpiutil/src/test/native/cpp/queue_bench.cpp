@@ -0,0 +1,85 @@
+// Copyright (c) FIRST and other WPILib contributors.
+// Open Source Software; you can modify and/or share it under the terms of
+// the WPILib BSD license file in the root directory of this project.
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "wpi/ConcurrentQueue.h"
+#include "wpi/MpscQueue.h"
+#include "wpi/SpscQueue.h"
+
+static constexpr int kCount = 2000000;
+
+// Pushes kCount elements split across the producers, pops them all on the
+// calling thread, and prints the throughput
+template <typename Push, typename Pop>
+static void RunBenchmark(const char* name, int producers, Push push, Pop pop) {
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < kCount / producers; ++i) {
+        push(i);
+      }
+    });
+  }
+  int64_t sum = 0;
+  for (int i = 0; i < kCount / producers * producers; ++i) {
+    sum += pop();
+  }
+  for (auto&& thread : threads) {
+    thread.join();
+  }
+  auto stop = std::chrono::high_resolution_clock::now();
+  double seconds = std::chrono::duration<double>(stop - start).count();
+  std::cout << name << " producers: " << producers
+            << " Mops/s: " << kCount / seconds / 1.0e6 << " sum: " << sum
+            << "\n";
+}
+
+TEST(QueueBenchmark, Spsc) {
+  wpi::ConcurrentQueue<int> cq;
+  RunBenchmark(
+      "ConcurrentQueue", 1, [&](int i) { cq.push(i); },
+      [&] { return cq.pop(); });
+
+  wpi::SpscQueue<int> spsc{1024};
+  RunBenchmark(
+      "SpscQueue", 1, [&](int i) { spsc.push(i); },
+      [&] { return spsc.pop(); });
+
+  // poll instead of blocking
+  wpi::SpscQueue<int, false> spscPoll{1024};
+  RunBenchmark(
+      "SpscQueue<nonblocking>", 1,
+      [&](int i) {
+        while (!spscPoll.try_push(i)) {
+          std::this_thread::yield();
+        }
+      },
+      [&] {
+        int value;
+        while (!spscPoll.try_pop(value)) {
+          std::this_thread::yield();
+        }
+        return value;
+      });
+}
+
+TEST(QueueBenchmark, Mpsc) {
+  for (int producers : {2, 4}) {
+    wpi::ConcurrentQueue<int> cq;
+    RunBenchmark(
+        "ConcurrentQueue", producers, [&](int i) { cq.push(i); },
+        [&] { return cq.pop(); });
+
+    wpi::MpscQueue<int> mpsc{1024};
+    RunBenchmark(
+        "MpscQueue", producers, [&](int i) { mpsc.push(i); },
+        [&] { return mpsc.pop(); });
+  }
+}